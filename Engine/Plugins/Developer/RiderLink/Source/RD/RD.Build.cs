@@ -59,6 +59,17 @@ public class RD : ModuleRules
 			"nssv_CONFIG_SELECT_STRING_VIEW=nssv_STRING_VIEW_NONSTD");
 		PublicDefinitions.Add("FMT_SHARED");
 
+		// Trace and debug calls on the wire path are compiled out below this level, spdlog::set_level can't bring them back.
+		// Raise it together with ENABLE_LOG_FILE of RiderLink to get them in the log file.
+		if (Target.Configuration == UnrealTargetConfiguration.Debug || Target.Configuration == UnrealTargetConfiguration.DebugGame)
+		{
+			PublicDefinitions.Add("SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_TRACE");
+		}
+		else
+		{
+			PublicDefinitions.Add("SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_INFO");
+		}
+
 		string[] Paths =
 		{
 			"src", "src/rd_core_cpp", "src/rd_core_cpp/src/main"
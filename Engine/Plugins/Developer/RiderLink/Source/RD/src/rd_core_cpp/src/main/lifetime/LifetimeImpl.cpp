@@ -51,9 +51,8 @@ void LifetimeImpl::attach_nested(std::shared_ptr<LifetimeImpl> nested)
 	if (nested->is_terminated() || is_eternal())
 		return;
 
-	std::function<void()> action = [nested] { nested->terminate(); };
-	counter_t action_id = add_action(action);
-	nested->add_action([this, id = action_id] { actions.erase(id); });
+	counter_t action_id = add_action([nested] { nested->terminate(); });
+	nested->add_action([this, id = action_id] { remove_action(id); });
 }
 
 LifetimeImpl::~LifetimeImpl()
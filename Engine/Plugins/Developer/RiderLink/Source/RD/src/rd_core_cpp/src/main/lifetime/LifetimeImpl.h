@@ -7,6 +7,7 @@
 #endif
 
 #include <std/hash.h>
+#include <util/unique_function.h>
 
 #include <functional>
 #include <map>
@@ -37,7 +38,7 @@ private:
 	counter_t id = 0;
 
 	counter_t action_id_in_map = 0;
-	using actions_t = ordered_map<int, std::function<void()>, rd::hash<int>>;
+	using actions_t = ordered_map<int, util::unique_function<void()>, rd::hash<int>>;
 	actions_t actions;
 
 	void terminate();
@@ -6,10 +6,13 @@
 
 #include <lifetime/Lifetime.h>
 #include <util/core_util.h>
+#include <util/unique_function.h>
 
+#include <algorithm>
 #include <utility>
 #include <functional>
 #include <atomic>
+#include <deque>
 
 namespace rd
 {
@@ -25,7 +28,7 @@ private:
 	class Event
 	{
 	private:
-		std::function<void(T const&)> action;
+		util::unique_function<void(T const&)> action;
 		Lifetime lifetime;
 
 	public:
@@ -38,6 +41,8 @@ private:
 		}
 
 		Event(Event&&) = default;
+
+		Event& operator=(Event&&) = default;
 		// endregion
 
 		bool is_alive() const
@@ -54,25 +59,55 @@ private:
 		}
 	};
 
-	using counter_t = int32_t;
-	using listeners_t = std::map<counter_t, Event>;
+	/**
+	 * \brief Listeners in advise order. Terminated ones stay as tombstones while any fire is in progress
+	 * and are compacted afterwards, a deque keeps the executing listener in place when a handler advises.
+	 */
+	using listeners_t = std::deque<Event>;
 
-	mutable counter_t advise_id = 0;
 	mutable listeners_t listeners, priority_listeners;
+	mutable int32_t firing_depth = 0;
 
 	static void cleanup(listeners_t& queue)
 	{
-		util::erase_if(queue, [](Event const& e) -> bool { return !e.is_alive(); });
+		queue.erase(std::remove_if(queue.begin(), queue.end(), [](Event const& e) -> bool { return !e.is_alive(); }), queue.end());
 	}
 
+	/**
+	 * \brief Keeps [firing_depth] balanced when a handler throws, the outermost fire compacts [queue] on exit.
+	 */
+	class FiringScope
+	{
+		int32_t& depth;
+		listeners_t& queue;
+
+	public:
+		FiringScope(int32_t& depth, listeners_t& queue) : depth(depth), queue(queue)
+		{
+			++depth;
+		}
+
+		FiringScope(FiringScope const&) = delete;
+
+		FiringScope& operator=(FiringScope const&) = delete;
+
+		~FiringScope()
+		{
+			if (--depth == 0)
+			{
+				cleanup(queue);
+			}
+		}
+	};
+
 	void fire_impl(T const& value, listeners_t& queue) const
 	{
-		for (auto const& p : queue)
+		FiringScope scope(firing_depth, queue);
+		// listeners advised by a handler get this value too
+		for (size_t i = 0; i < queue.size(); ++i)
 		{
-			auto const& event = p.second;
-			event.execute_if_alive(value);
+			queue[i].execute_if_alive(value);
 		}
-		cleanup(queue);
 	}
 
 	template <typename F>
@@ -80,9 +115,7 @@ private:
 	{
 		if (lifetime->is_terminated())
 			return;
-		counter_t id = advise_id /*.load()*/;
-		queue.emplace(id, Event(std::forward<F>(handler), lifetime));
-		++advise_id;
+		queue.emplace_back(std::forward<F>(handler), lifetime);
 	}
 
 public:
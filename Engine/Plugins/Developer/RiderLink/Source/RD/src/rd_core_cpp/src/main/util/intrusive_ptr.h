@@ -0,0 +1,108 @@
+#ifndef RD_CPP_INTRUSIVE_PTR_H
+#define RD_CPP_INTRUSIVE_PTR_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Strong reference to an object which counts its references itself, through its add_ref() and release()
+ * const member functions. Unlike std::shared_ptr there is no control block, so the object decides what happens when
+ * the last reference is gone, e.g. goes back to a pool.
+ */
+template <typename T>
+class intrusive_ptr
+{
+	template <typename>
+	friend class intrusive_ptr;
+
+	T* ptr = nullptr;
+
+public:
+	// region ctor/dtor
+	intrusive_ptr() = default;
+
+	/**
+	 * \brief Takes a new reference to [ptr].
+	 */
+	explicit intrusive_ptr(T* ptr) : ptr(ptr)
+	{
+		if (ptr)
+		{
+			ptr->add_ref();
+		}
+	}
+
+	intrusive_ptr(intrusive_ptr const& other) : intrusive_ptr(other.ptr)
+	{
+	}
+
+	intrusive_ptr(intrusive_ptr&& other) noexcept : ptr(other.ptr)
+	{
+		other.ptr = nullptr;
+	}
+
+	template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	intrusive_ptr(intrusive_ptr<U> const& other) : intrusive_ptr(other.ptr)
+	{
+	}
+
+	template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	intrusive_ptr(intrusive_ptr<U>&& other) noexcept : ptr(other.ptr)
+	{
+		other.ptr = nullptr;
+	}
+
+	intrusive_ptr& operator=(intrusive_ptr other) noexcept
+	{
+		std::swap(ptr, other.ptr);
+		return *this;
+	}
+
+	~intrusive_ptr()
+	{
+		if (ptr)
+		{
+			ptr->release();
+		}
+	}
+	// endregion
+
+	T* get() const
+	{
+		return ptr;
+	}
+
+	T* operator->() const
+	{
+		return ptr;
+	}
+
+	T& operator*() const
+	{
+		return *ptr;
+	}
+
+	explicit operator bool() const
+	{
+		return ptr != nullptr;
+	}
+
+	friend bool operator==(intrusive_ptr const& lhs, intrusive_ptr const& rhs)
+	{
+		return lhs.ptr == rhs.ptr;
+	}
+
+	friend bool operator!=(intrusive_ptr const& lhs, intrusive_ptr const& rhs)
+	{
+		return !(lhs == rhs);
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_INTRUSIVE_PTR_H
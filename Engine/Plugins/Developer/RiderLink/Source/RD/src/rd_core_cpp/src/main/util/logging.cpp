@@ -0,0 +1,86 @@
+#include "logging.h"
+
+#include <spdlog/async_logger.h>
+#include <spdlog/details/registry.h>
+#include <spdlog/details/thread_pool.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <mutex>
+
+#ifndef RD_LOG_QUEUE_SIZE
+#define RD_LOG_QUEUE_SIZE 8192
+#endif
+
+#ifndef RD_LOG_BLOCK_ON_OVERFLOW
+#define RD_LOG_BLOCK_ON_OVERFLOW 0
+#endif
+
+namespace rd
+{
+namespace util
+{
+struct log_queue_state
+{
+	std::mutex lock;
+	std::shared_ptr<spdlog::details::thread_pool> queue;
+};
+
+static log_queue_state& log_queue()
+{
+	// Loggers are created after it, so static ones are destroyed before the writer thread stops.
+	static log_queue_state state;
+	return state;
+}
+
+std::shared_ptr<spdlog::logger> create_logger(std::string name)
+{
+	constexpr spdlog::async_overflow_policy policy =
+		RD_LOG_BLOCK_ON_OVERFLOW ? spdlog::async_overflow_policy::block : spdlog::async_overflow_policy::overrun_oldest;
+
+	log_queue_state& state = log_queue();
+	std::lock_guard<std::mutex> guard(state.lock);
+	if (!state.queue)
+	{
+		state.queue = std::make_shared<spdlog::details::thread_pool>(RD_LOG_QUEUE_SIZE, 1U);
+	}
+
+	auto sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>(spdlog::color_mode::automatic);
+	auto logger = std::make_shared<spdlog::async_logger>(std::move(name), std::move(sink), state.queue, policy);
+	spdlog::details::registry::instance().initialize_logger(logger);
+	return logger;
+}
+
+size_t dropped_log_messages()
+{
+	log_queue_state& state = log_queue();
+	std::lock_guard<std::mutex> guard(state.lock);
+	return state.queue ? state.queue->overrun_counter() : 0;
+}
+
+void shutdown_logging()
+{
+	log_queue_state& state = log_queue();
+	std::lock_guard<std::mutex> guard(state.lock);
+
+	// Turned off before the queue goes away: an async logger aborts if it is handed a message or a flush without its queue.
+	// Loggers already off are left alone, like the default one kept from an earlier shutdown.
+	spdlog::apply_all([](std::shared_ptr<spdlog::logger> logger) {
+		if (logger->level() != spdlog::level::off)
+		{
+			logger->flush();
+			logger->set_level(spdlog::level::off);
+		}
+	});
+
+	// The writer thread handles everything queued before it stops, the flushes included
+	state.queue.reset();
+
+	spdlog::apply_all([](std::shared_ptr<spdlog::logger> logger) { logger->sinks().clear(); });
+
+	// The default logger is kept registered, spdlog::error and friends dereference it without a check
+	std::shared_ptr<spdlog::logger> default_logger = spdlog::default_logger();
+	spdlog::shutdown();
+	spdlog::set_default_logger(std::move(default_logger));
+}
+}	 // namespace util
+}	 // namespace rd
@@ -0,0 +1,48 @@
+#ifndef RD_CPP_LOGGING_H
+#define RD_CPP_LOGGING_H
+
+#include <spdlog/spdlog.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <rd_core_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Creates and registers a logger writing to stderr. Messages are queued to a single writer thread shared by
+ * all RD loggers, so wire and scheduler threads only format them and never wait for the sinks.
+ * The queue holds [RD_LOG_QUEUE_SIZE] messages. When the writer falls behind, the oldest are dropped,
+ * unless [RD_LOG_BLOCK_ON_OVERFLOW] is set, then the logging thread waits for it.
+ */
+RD_CORE_API std::shared_ptr<spdlog::logger> create_logger(std::string name);
+
+/**
+ * \brief Number of messages dropped because the queue was full.
+ */
+RD_CORE_API size_t dropped_log_messages();
+
+/**
+ * \brief Flushes every logger and stops the writer thread, then drops them from the spdlog registry along with their sinks,
+ * so log files are closed before the module is unloaded. Loggers still referenced afterwards, like the static ones of
+ * the RD classes, discard everything. Call once the threads using RD are stopped. Loggers created later start a new
+ * writer thread.
+ */
+RD_CORE_API void shutdown_logging();
+
+/**
+ * \brief Whether [logger] accepts messages of [level]. Levels below SPDLOG_ACTIVE_LEVEL are rejected at compile time,
+ * so the code describing a message under this check is removed along with the message itself.
+ */
+inline bool should_log(spdlog::logger const& logger, spdlog::level::level_enum level)
+{
+	return level >= static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL) && logger.should_log(level);
+}
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_LOGGING_H
@@ -0,0 +1,222 @@
+#ifndef RD_CPP_UNIQUE_FUNCTION_H
+#define RD_CPP_UNIQUE_FUNCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+template <typename Signature>
+class unique_function;
+
+/**
+ * \brief Move-only counterpart of std::function. Callables up to [INLINE_SIZE] bytes which are nothrow movable
+ * are stored inline, bigger ones on the heap. Unlike std::function it accepts move-only callables,
+ * so captured buffers don't need to be wrapped into a shared pointer.
+ */
+template <typename R, typename... Args>
+class unique_function<R(Args...)>
+{
+public:
+	static constexpr size_t INLINE_SIZE = 6 * sizeof(void*);
+
+private:
+	using storage_t = std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)>;
+
+	struct ops_t
+	{
+		R (*invoke)(storage_t&, Args&&...);
+		void (*move)(storage_t& from, storage_t& to) noexcept;
+		void (*destroy)(storage_t&) noexcept;
+	};
+
+	template <typename F>
+	static constexpr bool is_inline_v = sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) &&
+										std::is_nothrow_move_constructible<F>::value;
+
+	template <typename F>
+	struct inline_ops
+	{
+		static F& get(storage_t& storage)
+		{
+			return *reinterpret_cast<F*>(&storage);
+		}
+
+		static R invoke(storage_t& storage, Args&&... args)
+		{
+			return get(storage)(std::forward<Args>(args)...);
+		}
+
+		static void move(storage_t& from, storage_t& to) noexcept
+		{
+			::new (&to) F(std::move(get(from)));
+			get(from).~F();
+		}
+
+		static void destroy(storage_t& storage) noexcept
+		{
+			get(storage).~F();
+		}
+
+		static constexpr ops_t ops{&invoke, &move, &destroy};
+	};
+
+	template <typename F>
+	struct heap_ops
+	{
+		static F*& get(storage_t& storage)
+		{
+			return *reinterpret_cast<F**>(&storage);
+		}
+
+		static R invoke(storage_t& storage, Args&&... args)
+		{
+			return (*get(storage))(std::forward<Args>(args)...);
+		}
+
+		static void move(storage_t& from, storage_t& to) noexcept
+		{
+			::new (&to) F*(get(from));
+		}
+
+		static void destroy(storage_t& storage) noexcept
+		{
+			delete get(storage);
+		}
+
+		static constexpr ops_t ops{&invoke, &move, &destroy};
+	};
+
+	storage_t storage;
+	ops_t const* ops = nullptr;
+
+	template <typename F>
+	static bool is_empty(F const& f, std::true_type)
+	{
+		return !f;
+	}
+
+	template <typename F>
+	static bool is_empty(F const&, std::false_type)
+	{
+		return false;
+	}
+
+	template <typename D, typename F>
+	void emplace(F&& f, std::true_type)
+	{
+		::new (&storage) D(std::forward<F>(f));
+		ops = &inline_ops<D>::ops;
+	}
+
+	template <typename D, typename F>
+	void emplace(F&& f, std::false_type)
+	{
+		::new (&storage) D*(new D(std::forward<F>(f)));
+		ops = &heap_ops<D>::ops;
+	}
+
+	void reset() noexcept
+	{
+		if (ops != nullptr)
+		{
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+public:
+	// region ctor/dtor
+
+	unique_function() noexcept = default;
+
+	unique_function(std::nullptr_t) noexcept
+	{
+	}
+
+	template <typename F, typename D = std::decay_t<F>,
+		typename = std::enable_if_t<!std::is_same<D, unique_function>::value &&
+									std::is_convertible<decltype(std::declval<D&>()(std::declval<Args>()...)), R>::value>>
+	unique_function(F&& f)
+	{
+		// empty std::function and null function pointers stay empty
+		if (is_empty(f, std::integral_constant<bool, std::is_pointer<D>::value || std::is_member_pointer<D>::value ||
+														 std::is_constructible<bool, D const&>::value>{}))
+		{
+			return;
+		}
+		emplace<D>(std::forward<F>(f), std::integral_constant<bool, is_inline_v<D>>{});
+	}
+
+	unique_function(unique_function&& other) noexcept : ops(other.ops)
+	{
+		if (ops != nullptr)
+		{
+			ops->move(other.storage, storage);
+			other.ops = nullptr;
+		}
+	}
+
+	unique_function& operator=(unique_function&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.ops != nullptr)
+			{
+				other.ops->move(other.storage, storage);
+				ops = other.ops;
+				other.ops = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	unique_function& operator=(std::nullptr_t) noexcept
+	{
+		reset();
+		return *this;
+	}
+
+	unique_function(unique_function const&) = delete;
+
+	unique_function& operator=(unique_function const&) = delete;
+
+	~unique_function()
+	{
+		reset();
+	}
+
+	// endregion
+
+	explicit operator bool() const noexcept
+	{
+		return ops != nullptr;
+	}
+
+	R operator()(Args... args) const
+	{
+		if (ops == nullptr)
+		{
+			throw std::bad_function_call();
+		}
+		return ops->invoke(const_cast<storage_t&>(storage), std::forward<Args>(args)...);
+	}
+};
+
+template <typename R, typename... Args>
+template <typename F>
+constexpr typename unique_function<R(Args...)>::ops_t unique_function<R(Args...)>::inline_ops<F>::ops;
+
+template <typename R, typename... Args>
+template <typename F>
+constexpr typename unique_function<R(Args...)>::ops_t unique_function<R(Args...)>::heap_ops<F>::ops;
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_UNIQUE_FUNCTION_H
@@ -0,0 +1,43 @@
+#ifndef RD_CPP_IRDRESPONSERECEIVER_H
+#define RD_CPP_IRDRESPONSERECEIVER_H
+
+#include "protocol/Buffer.h"
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+// region predeclared
+
+class IRdReactive;
+// endregion
+
+/**
+ * \brief Receiver of the response to one call, advised with [IWire::advise_response] under the id of the call's task.
+ * Responses are short-lived, so unlike entities they aren't advised within a lifetime. Receivers count their
+ * references instead, the wire holds one while the receiver is advised and another one while delivering to it.
+ */
+class RD_FRAMEWORK_API IRdResponseReceiver
+{
+public:
+	// region ctor/dtor
+	virtual ~IRdResponseReceiver() = default;
+	// endregion
+
+	virtual void add_ref() const = 0;
+
+	virtual void release() const = 0;
+
+	/**
+	 * \brief The call which sent the request, responses are accounted to it in the wire's stats.
+	 */
+	virtual IRdReactive const* get_call() const = 0;
+
+	/**
+	 * \brief Invoked on the thread reading the wire with the serialized response.
+	 */
+	virtual void on_response_received(Buffer buffer) const = 0;
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_IRDRESPONSERECEIVER_H
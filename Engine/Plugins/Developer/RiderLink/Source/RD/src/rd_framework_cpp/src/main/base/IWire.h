@@ -8,7 +8,12 @@
 
 #include "reactive/base/interfaces.h"
 #include "base/IRdReactive.h"
+#include "base/IRdResponseReceiver.h"
 #include "reactive/Property.h"
+#include "protocol/Buffer.h"
+
+#include <chrono>
+#include <cstdint>
 
 #include <rd_framework_export.h>
 
@@ -20,6 +25,46 @@ namespace rd
 class RD_FRAMEWORK_API IWire
 {
 public:
+	/**
+	 * \brief Snapshot of the wire traffic since it was created, for diagnostics.
+	 */
+	struct Stats
+	{
+		uint64_t sent_packages = 0;
+		uint64_t sent_bytes = 0;
+		uint64_t received_packages = 0;
+		uint64_t received_bytes = 0;
+		uint64_t received_messages = 0;
+		/**
+		 * \brief Packages handed to the wire which the counterpart hasn't acknowledged yet, sent or not.
+		 */
+		uint64_t queue_depth = 0;
+		uint64_t acknowledged_batches = 0;
+		std::chrono::steady_clock::duration total_ack_latency{0};
+		std::chrono::steady_clock::duration max_ack_latency{0};
+		/**
+		 * \brief Connections established, every one after the first is a reconnect.
+		 */
+		uint32_t connections = 0;
+	};
+
+	/**
+	 * \brief Extensions of the wire format which are only used once the counterpart has offered them too. Flags of a
+	 * bit mask, see SocketWire::Base::set_offered_capabilities.
+	 */
+	enum class Capability : uint32_t
+	{
+		/**
+		 * \brief Packages go through a pair of shared memory rings instead of the socket, which stays open so that
+		 * either end can tell when the other one is gone. Only offered where SharedMemoryRing::is_supported.
+		 */
+		SharedMemory = 1u << 0,
+		/**
+		 * \brief Messages to one entity may be delivered together in one package, see [send_batched].
+		 */
+		CollectionBatches = 1u << 1
+	};
+
 	Property<bool> connected{false};
 	Property<bool> heartbeatAlive{false};
 
@@ -39,6 +84,58 @@ public:
 	 */
 	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const = 0;
 
+	/**
+	 * \brief Same as [send], but the message is written in [encoding] instead of [get_encoding]. Used by writers
+	 * embedding data serialized ahead of time, in case the encoding has been switched in between.
+	 */
+	virtual void send_encoded(RdId const& id, Buffer::Encoding encoding, std::function<void(Buffer& buffer)> writer) const
+	{
+		(void) encoding;
+		send(id, std::move(writer));
+	}
+
+	/**
+	 * \brief Same as [send], but with [Capability::CollectionBatches] agreed on the message may be held back and
+	 * delivered in one package with the next messages to [id]. Held messages go out before any message to another id
+	 * and once the wire's scheduler gets to the next action, so the order of messages across ids doesn't change. Of
+	 * held messages with the same non-empty [key] only the last one is delivered, in place of the first one, so it's
+	 * only to be passed by senders whose messages with the same key supersede each other.
+	 *
+	 * [writer] is invoked before this returns, like with [send].
+	 */
+	virtual void send_batched(RdId const& id, Buffer::ByteArray key, std::function<void(Buffer& buffer)> writer) const
+	{
+		(void) key;
+		send(id, std::move(writer));
+	}
+
+	/**
+	 * \brief Whether the counterpart agreed on [capability]. Senders check it before preparing what only a capability
+	 * needs, like the keys of [send_batched].
+	 */
+	virtual bool has_capability(Capability capability) const
+	{
+		(void) capability;
+		return false;
+	}
+
+	/**
+	 * \brief Encoding of the buffers passed to writers by [send] and of received messages. Data serialized ahead of
+	 * time is sent with [send_encoded] in the encoding it was written in.
+	 */
+	virtual Buffer::Encoding get_encoding() const
+	{
+		return Buffer::Encoding::Fixed;
+	}
+
+	/**
+	 * \brief Traffic counters of this wire. Wires which don't collect them return an empty snapshot.
+	 */
+	virtual Stats get_stats() const
+	{
+		return {};
+	}
+
 	/**
 	 * \brief Adds a [handler] for receiving updated values of the object with the given [id]. The handler is removed
 	 * when the given [lifetime] is terminated.
@@ -46,6 +143,17 @@ public:
 	 * \param entity to be subscripted
 	 */
 	virtual void advise(Lifetime lifetime, IRdReactive const* entity) const = 0;
+
+	/**
+	 * \brief Subscribes [receiver] to the response sent to [task_id], until [unadvise_response] is called for it.
+	 * The wire holds a reference to the receiver meanwhile.
+	 */
+	virtual void advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const = 0;
+
+	/**
+	 * \brief Removes the receiver advised with [task_id], if there is one.
+	 */
+	virtual void unadvise_response(RdId const& task_id) const = 0;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
@@ -81,8 +81,11 @@ public:
 			get_wire()->send(rdid, [this, &v](Buffer& buffer) {
 				buffer.write_integral<int32_t>(master_version);
 				S::write(this->get_serialization_context(), buffer, v);
-				spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
-					std::to_string(master_version), to_string(v));
+				if (util::should_log(log_send(), spdlog::level::trace))
+				{
+					log_send().trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
+						std::to_string(master_version), to_string(v));
+				}
 			});
 		});
 
@@ -105,8 +108,11 @@ public:
 		WT v = S::read(this->get_serialization_context(), buffer);
 
 		bool rejected = is_master && version < master_version;
-		spdlog::get("logSend")->trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
-			master_version, version, to_string(v), (rejected ? ">> REJECTED" : ""));
+		if (util::should_log(log_received(), spdlog::level::trace))
+		{
+			log_received().trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
+				master_version, version, to_string(v), (rejected ? ">> REJECTED" : ""));
+		}
 		if (rejected)
 		{
 			return;
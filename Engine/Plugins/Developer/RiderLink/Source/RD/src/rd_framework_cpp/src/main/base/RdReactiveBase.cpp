@@ -1,13 +1,11 @@
 #include "RdReactiveBase.h"
 
-#include "spdlog/sinks/stdout_color_sinks.h"
+#include "util/logging.h"
 
 namespace rd
 {
-static std::shared_ptr<spdlog::logger> logReceived =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logReceived", spdlog::color_mode::automatic);
-std::shared_ptr<spdlog::logger> logSend =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logSend", spdlog::color_mode::automatic);
+static std::shared_ptr<spdlog::logger> logReceived = util::create_logger("logReceived");
+std::shared_ptr<spdlog::logger> logSend = util::create_logger("logSend");
 
 RdReactiveBase::RdReactiveBase(RdReactiveBase&& other) : RdBindableBase(std::move(other)) /*, async(other.async)*/
 {
@@ -52,6 +50,16 @@ IScheduler* RdReactiveBase::get_default_scheduler() const
 	return get_protocol()->get_scheduler();
 }
 
+spdlog::logger& RdReactiveBase::log_send()
+{
+	return *logSend;
+}
+
+spdlog::logger& RdReactiveBase::log_received()
+{
+	return *logReceived;
+}
+
 IScheduler* RdReactiveBase::get_wire_scheduler() const
 {
 	return get_default_scheduler();
@@ -6,6 +6,7 @@
 #include "guards.h"
 
 #include "spdlog/spdlog.h"
+#include "util/logging.h"
 
 #include <rd_framework_export.h>
 
@@ -55,6 +56,14 @@ public:
 
 	void assert_bound() const;
 
+	/**
+	 * \brief Loggers of sent and received messages. Check util::should_log before describing a message,
+	 * collections send thousands of them on bind.
+	 */
+	static spdlog::logger& log_send();
+
+	static spdlog::logger& log_received();
+
 	template <typename F>
 	auto local_change(F&& action) const -> typename util::result_of_t<F()>
 	{
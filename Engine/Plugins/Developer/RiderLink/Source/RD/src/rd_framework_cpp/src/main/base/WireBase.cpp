@@ -6,4 +6,14 @@ void WireBase::advise(Lifetime lifetime, const IRdReactive* entity) const
 {
 	message_broker.advise_on(lifetime, entity);
 }
+
+void WireBase::advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const
+{
+	message_broker.advise_response(task_id, receiver);
+}
+
+void WireBase::unadvise_response(RdId const& task_id) const
+{
+	message_broker.unadvise_response(task_id);
+}
 }	 // namespace rd
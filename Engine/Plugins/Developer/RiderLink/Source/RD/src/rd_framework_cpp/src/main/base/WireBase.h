@@ -26,6 +26,18 @@ public:
 	// endregion
 
 	void advise(Lifetime lifetime, IRdReactive const* entity) const override;
+
+	void advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const override;
+
+	void unadvise_response(RdId const& task_id) const override;
+
+	/**
+	 * \brief Gives access to the traffic received per entity, see [MessageBroker::get_stats].
+	 */
+	MessageBroker const& get_message_broker() const
+	{
+		return message_broker;
+	}
 };
 }	 // namespace rd
 
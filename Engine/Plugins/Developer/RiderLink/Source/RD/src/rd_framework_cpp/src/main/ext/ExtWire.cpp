@@ -17,11 +17,11 @@ ExtWire::ExtWire()
 					{
 						return;
 					}
-					// auto[id, payload] = std::move(sendQ.front());
-					auto it = std::move(sendQ.front());
+					QueuedMessage it = std::move(sendQ.front());
 					sendQ.pop();
-					realWire->send(
-						it.first, [payload = std::move(it.second)](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+					// the payload was written in the encoding current when it was queued
+					realWire->send_encoded(it.id, it.encoding,
+						[payload = std::move(it.payload)](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
 				}
 			}
 		}
@@ -33,18 +33,67 @@ void ExtWire::advise(Lifetime lifetime, IRdReactive const* entity) const
 	realWire->advise(lifetime, entity);
 }
 
+void ExtWire::advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const
+{
+	realWire->advise_response(task_id, receiver);
+}
+
+void ExtWire::unadvise_response(RdId const& task_id) const
+{
+	realWire->unadvise_response(task_id);
+}
+
 void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	send_encoded(id, get_encoding(), std::move(writer));
+}
+
+void ExtWire::send_encoded(RdId const& id, Buffer::Encoding encoding, std::function<void(Buffer& buffer)> writer) const
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (!sendQ.empty() || !connected.get())
+		{
+			Buffer buffer;
+			buffer.set_encoding(encoding);
+			writer(buffer);
+			sendQ.push(QueuedMessage{id, encoding, buffer.getRealArray()});
+			return;
+		}
+	}
+	realWire->send_encoded(id, encoding, std::move(writer));
+}
+
+void ExtWire::send_batched(RdId const& id, Buffer::ByteArray key, std::function<void(Buffer& buffer)> writer) const
 {
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
 		if (!sendQ.empty() || !connected.get())
 		{
+			// queued messages go out one by one on connection anyway
+			const Buffer::Encoding encoding = get_encoding();
 			Buffer buffer;
+			buffer.set_encoding(encoding);
 			writer(buffer);
-			sendQ.emplace(id, buffer.getRealArray());
+			sendQ.push(QueuedMessage{id, encoding, buffer.getRealArray()});
 			return;
 		}
 	}
-	realWire->send(id, std::move(writer));
+	realWire->send_batched(id, std::move(key), std::move(writer));
+}
+
+bool ExtWire::has_capability(Capability capability) const
+{
+	return realWire != nullptr && realWire->has_capability(capability);
+}
+
+Buffer::Encoding ExtWire::get_encoding() const
+{
+	return realWire != nullptr ? realWire->get_encoding() : Buffer::Encoding::Fixed;
+}
+
+IWire::Stats ExtWire::get_stats() const
+{
+	return realWire != nullptr ? realWire->get_stats() : Stats{};
 }
 }	 // namespace rd
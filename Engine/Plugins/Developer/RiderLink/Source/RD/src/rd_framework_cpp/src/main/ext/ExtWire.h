@@ -22,7 +22,14 @@ class RD_FRAMEWORK_API ExtWire final : public IWire
 {
 	mutable std::mutex lock;
 
-	mutable std::queue<std::pair<RdId, Buffer::ByteArray> > sendQ;
+	struct QueuedMessage
+	{
+		RdId id;
+		Buffer::Encoding encoding;
+		Buffer::ByteArray payload;
+	};
+
+	mutable std::queue<QueuedMessage> sendQ;
 
 public:
 	ExtWire();
@@ -31,7 +38,21 @@ public:
 
 	void advise(Lifetime lifetime, IRdReactive const* entity) const override;
 
+	void advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const override;
+
+	void unadvise_response(RdId const& task_id) const override;
+
 	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send_encoded(RdId const& id, Buffer::Encoding encoding, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send_batched(RdId const& id, Buffer::ByteArray key, std::function<void(Buffer& buffer)> writer) const override;
+
+	bool has_capability(Capability capability) const override;
+
+	Buffer::Encoding get_encoding() const override;
+
+	Stats get_stats() const override;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
@@ -42,13 +42,13 @@ void RdExtBase::init(Lifetime lifetime) const
 	{
 		bindPolymorphic(*(it.second), lifetime, this, it.first);
 	}
-	traceMe(Protocol::initializationLogger, "created and bound");
+	traceMe(*Protocol::initializationLogger, "created and bound");
 }
 
 void RdExtBase::on_wire_received(Buffer buffer) const
 {
 	ExtState remoteState = buffer.read_enum<ExtState>();
-	traceMe(spdlog::get("logReceived"), "remote: " + to_string(remoteState));
+	traceMe(log_received(), "remote: " + to_string(remoteState));
 
 	switch (remoteState)
 	{
@@ -88,9 +88,9 @@ void RdExtBase::sendState(IWire const& wire, ExtState state) const
 	});
 }
 
-void RdExtBase::traceMe(std::shared_ptr<spdlog::logger> logger, string_view message) const
+void RdExtBase::traceMe(spdlog::logger& logger, string_view message) const
 {
-	logger->trace("ext {} {}:: {}", to_string(location), to_string(rdid), std::string(message));
+	logger.trace("ext {} {}:: {}", to_string(location), to_string(rdid), std::string(message));
 }
 
 IScheduler* RdExtBase::get_wire_scheduler() const
@@ -55,7 +55,7 @@ public:
 
 	void sendState(IWire const& wire, ExtState state) const;
 
-	void traceMe(std::shared_ptr<spdlog::logger> logger, string_view message) const;
+	void traceMe(spdlog::logger& logger, string_view message) const;
 };
 
 std::string to_string(RdExtBase::ExtState state);
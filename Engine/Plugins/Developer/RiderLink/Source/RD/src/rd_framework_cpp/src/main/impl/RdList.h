@@ -93,7 +93,8 @@ public:
 					}
 				}
 
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
+				// indices shift with every change, so changes are batched but none supersedes another
+				get_wire()->send_batched(rdid, {}, [this, e](Buffer& buffer) {
 					Op op = static_cast<Op>(e.v.index());
 
 					buffer.write_integral<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
@@ -104,7 +105,10 @@ public:
 					{
 						S::write(this->get_serialization_context(), buffer, *new_value);
 					}
-					spdlog::get("logSend")->trace(logmsg(op, next_version - 1, e.get_index(), new_value));
+					if (util::should_log(log_send(), spdlog::level::trace))
+					{
+						log_send().trace(logmsg(op, next_version - 1, e.get_index(), new_value));
+					}
 				});
 			});
 		});
@@ -138,7 +142,10 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				if (util::should_log(log_received(), spdlog::level::trace))
+				{
+					log_received().trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				}
 
 				(index < 0) ? list::add(std::move(value)) : list::add(static_cast<size_t>(index), std::move(value));
 				break;
@@ -147,14 +154,20 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				if (util::should_log(log_received(), spdlog::level::trace))
+				{
+					log_received().trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				}
 
 				list::set(static_cast<size_t>(index), std::move(value));
 				break;
 			}
 			case Op::REMOVE:
 			{
-				spdlog::get("logReceived")->trace(logmsg(op, version, index));
+				if (util::should_log(log_received(), spdlog::level::trace))
+				{
+					log_received().trace(logmsg(op, version, index));
+				}
 
 				list::removeAt(static_cast<size_t>(index));
 				break;
@@ -36,7 +36,10 @@ private:
 
 	using map = ViewableMap<K, V>;
 	mutable int64_t next_version = 0;
-	mutable ordered_map<K const*, int64_t, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> pendingForAck;
+	// keys are owned, an entry may be removed from the map before its change is acknowledged
+	mutable ordered_map<WK, int64_t, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> pendingForAck;
+	// acknowledgements sent so far, changes batched on either side of one don't supersede each other
+	mutable int64_t acks_sent = 0;
 
 	std::string logmsg(Op op, int64_t version, K const* key, V const* value = nullptr) const
 	{
@@ -50,6 +53,27 @@ private:
 		return logmsg(op, version, key, value ? &(wrapper::get(*value)) : nullptr);
 	}
 
+	/**
+	 * \brief Sends the change [writer] writes about [key]. With batches agreed on, a later change of the same key
+	 * supersedes it, unless an acknowledgement was sent in between, see [IWire::send_batched]. The master
+	 * accepts a change only once its latest version is acknowledged, so a change mustn't move ahead of one.
+	 */
+	template <typename F>
+	void send_keyed(K const& key, F&& writer) const
+	{
+		if (get_wire()->has_capability(IWire::Capability::CollectionBatches))
+		{
+			Buffer serialized_key;
+			KS::write(this->get_serialization_context(), serialized_key, key);
+			serialized_key.write_integral(acks_sent);
+			get_wire()->send_batched(rdid, std::move(serialized_key).getRealArray(), std::forward<F>(writer));
+		}
+		else
+		{
+			get_wire()->send(rdid, std::forward<F>(writer));
+		}
+	}
+
 public:
 	bool is_master = false;
 
@@ -103,7 +127,7 @@ public:
 					identifyPolymorphic(*new_value, *identity, identity->next(rdid));
 				}
 
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
+				send_keyed(*e.get_key(), [this, e](Buffer& buffer) {
 					int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
 					Op op = static_cast<Op>(e.v.index());
 
@@ -113,7 +137,8 @@ public:
 
 					if (is_master)
 					{
-						pendingForAck.emplace(e.get_key(), version);
+						// only the latest version is acknowledged when changes of the key are batched
+						pendingForAck.insert_or_assign(WK(*e.get_key()), version);
 						buffer.write_integral(version);
 					}
 
@@ -125,7 +150,10 @@ public:
 						VS::write(this->get_serialization_context(), buffer, *new_value);
 					}
 
-					spdlog::get("logSend")->trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
+					if (util::should_log(log_send(), spdlog::level::trace))
+					{
+						log_send().trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
+					}
 				});
 			});
 		});
@@ -186,18 +214,18 @@ public:
 			}
 			if (errmsg.empty())
 			{
-				spdlog::get("logReceived")->trace(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
+				if (util::should_log(log_received(), spdlog::level::trace))
+				{
+					log_received().trace(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
+				}
 			}
 			else
 			{
-				spdlog::get("logReceived")->error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
+				log_received().error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
 			}
 		}
 		else
 		{
-			Buffer serialized_key;
-			KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
-
 			bool is_put = (op == Op::ADD || op == Op::UPDATE);
 			optional<WV> value;
 			if (is_put)
@@ -205,9 +233,28 @@ public:
 				value = VS::read(this->get_serialization_context(), buffer);
 			}
 
+			if (msg_versioned)
+			{
+				// acknowledged before the key is moved into the map, the writer runs before the send returns.
+				// Batched without a key, so neither a local change of the key nor a later acknowledgement supersedes it
+				get_wire()->send_batched(rdid, {}, [this, version, &key](Buffer& innerBuffer) {
+					innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
+					innerBuffer.write_integral<int64_t>(version);
+					KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
+				});
+				++acks_sent;
+				if (is_master)
+				{
+					log_received().error("Both ends are masters: {}", to_string(location));
+				}
+			}
+
 			if (msg_versioned || !is_master || pendingForAck.count(key) == 0)
 			{
-				spdlog::get("logReceived")->trace("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
+				if (util::should_log(log_received(), spdlog::level::trace))
+				{
+					log_received().trace("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
+				}
 				if (value.has_value())
 				{
 					map::set(std::move(key), *std::move(value));
@@ -219,23 +266,9 @@ public:
 			}
 			else
 			{
-				spdlog::get("logReceived")->trace("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
-			}
-
-			if (msg_versioned)
-			{
-				auto writer =
-					util::make_shared_function([version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
-						innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
-						innerBuffer.write_integral<int64_t>(version);
-						// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
-						innerBuffer.write_byte_array_raw(serialized_key.getArray());
-						// logSend.trace(logmsg(Op::ACK, version, serialized_key));
-					});
-				get_wire()->send(rdid, std::move(writer));
-				if (is_master)
+				if (util::should_log(log_received(), spdlog::level::trace))
 				{
-					spdlog::get("logReceived")->error("Both ends are masters: {}", to_string(location));
+					log_received().trace("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
 				}
 			}
 		}
@@ -69,12 +69,26 @@ public:
 				if (!is_local_change)
 					return;
 
-				get_wire()->send(rdid, [this, kind, &v](Buffer& buffer) {
+				auto writer = [this, kind, &v](Buffer& buffer) {
 					buffer.write_enum<AddRemove>(kind);
 					S::write(this->get_serialization_context(), buffer, v);
 
-					spdlog::get("logSend")->trace("SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
-				});
+					if (util::should_log(log_send(), spdlog::level::trace))
+					{
+						log_send().trace("SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
+					}
+				};
+				if (get_wire()->has_capability(IWire::Capability::CollectionBatches))
+				{
+					// adding or removing the value once more supersedes this change, see IWire::send_batched
+					Buffer serialized_value;
+					S::write(this->get_serialization_context(), serialized_value, v);
+					get_wire()->send_batched(rdid, std::move(serialized_value).getRealArray(), std::move(writer));
+				}
+				else
+				{
+					get_wire()->send(rdid, std::move(writer));
+				}
 			});
 		});
 
@@ -82,7 +82,10 @@ public:
 	void on_wire_received(Buffer buffer) const override
 	{
 		auto value = S::read(this->get_serialization_context(), buffer);
-		spdlog::get("logReceived")->trace("RECV{}", logmsg(wrapper::get<T>(value)));
+		if (util::should_log(log_received(), spdlog::level::trace))
+		{
+			log_received().trace("RECV{}", logmsg(wrapper::get<T>(value)));
+		}
 
 		signal.fire(wrapper::get<T>(value));
 	}
@@ -103,7 +106,10 @@ public:
 		if (async && !is_bound()) return;
 
 		get_wire()->send(rdid, [this, &value](Buffer& buffer) {
-			spdlog::get("logSend")->trace("SEND{}", logmsg(value));
+			if (util::should_log(log_send(), spdlog::level::trace))
+			{
+				log_send().trace("SEND{}", logmsg(value));
+			}
 			S::write(get_serialization_context(), buffer, value);
 		});
 		signal.fire(value);
@@ -5,11 +5,87 @@
 
 namespace rd
 {
+constexpr size_t InternedItems::FIRST_CHUNK_SIZE;
+constexpr size_t InternedItems::MAX_CHUNKS;
+
+InternedItems::~InternedItems()
+{
+	clear();
+}
+
+size_t InternedItems::chunk_of(size_t index, size_t& offset)
+{
+	// chunk k holds FIRST_CHUNK_SIZE << k elements and starts at FIRST_CHUNK_SIZE * (2^k - 1)
+	const size_t scaled = index / FIRST_CHUNK_SIZE + 1;
+	size_t chunk = 0;
+	while ((scaled >> (chunk + 1)) != 0)
+	{
+		++chunk;
+	}
+	offset = index - FIRST_CHUNK_SIZE * ((size_t(1) << chunk) - 1);
+	return chunk;
+}
+
+InternedAny const& InternedItems::get(size_t index) const
+{
+	size_t offset = 0;
+	const size_t chunk = chunk_of(index, offset);
+	RD_ASSERT_MSG(chunk < MAX_CHUNKS, "Interned index is out of range: " + std::to_string(index));
+	InternedAny const* items = chunks[chunk].load(std::memory_order_acquire);
+	RD_ASSERT_MSG(items != nullptr, "Value with index " + std::to_string(index) + " hasn't been interned");
+	return items[offset];
+}
+
+void InternedItems::set(size_t index, InternedAny value)
+{
+	size_t offset = 0;
+	const size_t chunk = chunk_of(index, offset);
+	RD_ASSERT_MSG(chunk < MAX_CHUNKS, "Interned index is out of range: " + std::to_string(index));
+
+	std::lock_guard<decltype(grow_lock)> guard(grow_lock);
+	InternedAny* items = chunks[chunk].load(std::memory_order_relaxed);
+	if (items == nullptr)
+	{
+		items = new InternedAny[FIRST_CHUNK_SIZE << chunk];
+		chunks[chunk].store(items, std::memory_order_release);
+	}
+	items[offset] = std::move(value);
+}
+
+void InternedItems::clear()
+{
+	std::lock_guard<decltype(grow_lock)> guard(grow_lock);
+	for (auto& chunk : chunks)
+	{
+		delete[] chunk.exchange(nullptr, std::memory_order_acq_rel);
+	}
+}
+
+constexpr size_t InternRoot::SHARD_COUNT;
+
 InternRoot::InternRoot()
 {
 	async = true;
 }
 
+InternRoot::Shard& InternRoot::shard_of(InternedAny const& value) const
+{
+	// fibonacci hashing, the top bits of the mixed hash pick the shard
+	const uint64_t mixed = static_cast<uint64_t>(any::TransparentHash()(value)) * 0x9E3779B97F4A7C15ull;
+	return inverse_map[static_cast<size_t>(mixed >> 60) % SHARD_COUNT];
+}
+
+optional<int32_t> InternRoot::find_index(Shard const& shard, InternedAny const& value) const
+{
+	std::shared_lock<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.ids.find(value);
+	if (it == shard.ids.end())
+	{
+		return nullopt;
+	}
+	return it->second;
+}
+
 IScheduler* InternRoot::get_wire_scheduler() const
 {
 	return &intern_scheduler;
@@ -44,10 +120,14 @@ void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) c
 
 	{
 		// if something's interned before bind
-		std::lock_guard<decltype(lock)> guard(lock);
-		my_items_lis.clear();
+		my_items_list.clear();
+		my_items_count = 0;
 		other_items_list.clear();
-		inverse_map.clear();
+		for (auto& shard : inverse_map)
+		{
+			std::unique_lock<decltype(shard.lock)> guard(shard.lock);
+			shard.ids.clear();
+		}
 	}
 	get_protocol()->get_wire()->advise(lf, this);
 }
@@ -64,8 +144,9 @@ void InternRoot::set_interned_correspondence(int32_t id, InternedAny&& value) co
 {
 	RD_ASSERT_MSG(!is_index_owned(id), "Setting interned correspondence for object that we should have written, bug?")
 
-	std::lock_guard<decltype(lock)> guard(lock);
-	other_items_list[id / 2] = value;
-	inverse_map[value] = id;
+	other_items_list.set(id / 2, value);
+	Shard& shard = shard_of(value);
+	std::unique_lock<decltype(shard.lock)> guard(shard.lock);
+	shard.ids[std::move(value)] = id;
 }
 }	 // namespace rd
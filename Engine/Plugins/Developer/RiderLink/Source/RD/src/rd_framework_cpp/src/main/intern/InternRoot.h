@@ -8,11 +8,13 @@
 #include "serialization/RdAny.h"
 #include "util/core_traits.h"
 
-#include "tsl/ordered_map.h"
+#include "std/unordered_map.h"
 
-#include <vector>
+#include <array>
+#include <atomic>
 #include <string>
 #include <mutex>
+#include <shared_mutex>
 
 #include <rd_framework_export.h>
 
@@ -30,23 +32,75 @@ class Identities;
 
 // endregion
 
+/**
+ * \brief Append-only list of interned values indexed by id / 2. Values are kept in chunks of growing size
+ * which never move, so reading an element by index takes no lock.
+ */
+class RD_FRAMEWORK_API InternedItems final
+{
+private:
+	static constexpr size_t FIRST_CHUNK_SIZE = 64;
+	static constexpr size_t MAX_CHUNKS = 26;
+
+	std::array<std::atomic<InternedAny*>, MAX_CHUNKS> chunks{};
+
+	std::mutex grow_lock;
+
+	static size_t chunk_of(size_t index, size_t& offset);
+
+public:
+	// region ctor/dtor
+
+	InternedItems() = default;
+
+	InternedItems(InternedItems const&) = delete;
+
+	InternedItems& operator=(InternedItems const&) = delete;
+
+	~InternedItems();
+	// endregion
+
+	/**
+	 * \brief Element must've been set before and the index must be made known to the reader after that,
+	 * i.e. through the wire or the thread which set it.
+	 */
+	InternedAny const& get(size_t index) const;
+
+	void set(size_t index, InternedAny value);
+
+	void clear();
+};
+
 /**
  * \brief Node in graph for storing interned objects.
  */
 class RD_FRAMEWORK_API InternRoot final : public RdReactiveBase
 {
 private:
-	// template<typename T>
-	mutable std::vector<InternedAny> my_items_lis;
+	/**
+	 * \brief Part of the value to id index. Lookups of already interned values share the lock.
+	 */
+	struct Shard
+	{
+		mutable std::shared_mutex lock;
+		rd::unordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual> ids;
+	};
+
+	static constexpr size_t SHARD_COUNT = 16;
+
+	mutable InternedItems my_items_list;
+
+	mutable std::atomic<int32_t> my_items_count{0};
 
-	// template<typename T>
-	mutable ordered_map<int32_t, InternedAny> other_items_list;
-	// template<typename T>
-	mutable ordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual> inverse_map;
+	mutable InternedItems other_items_list;
+
+	mutable std::array<Shard, SHARD_COUNT> inverse_map;
 
 	mutable InternScheduler intern_scheduler;
 
-	mutable std::recursive_mutex lock;
+	Shard& shard_of(InternedAny const& value) const;
+
+	optional<int32_t> find_index(Shard const& shard, InternedAny const& value) const;
 
 	void set_interned_correspondence(int32_t id, InternedAny&& value) const;
 
@@ -96,7 +150,7 @@ template <typename T>
 Wrapper<T> InternRoot::un_intern_value(int32_t id) const
 {
 	// don't need lock because value's already exists and never removes
-	return any::get<T>(is_index_owned(id) ? my_items_lis[id / 2] : other_items_list[id / 2]);
+	return any::get<T>(is_index_owned(id) ? my_items_list.get(id / 2) : other_items_list.get(id / 2));
 }
 
 template <typename T>
@@ -104,30 +158,33 @@ int32_t InternRoot::intern_value(Wrapper<T> value) const
 {
 	InternedAny any = any::make_interned_any<T>(value);
 
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	auto it = inverse_map.find(any);
-	int32_t index = 0;
-	if (it == inverse_map.end())
+	Shard& shard = shard_of(any);
+	if (auto index = find_index(shard, any))
 	{
-		get_protocol()->get_wire()->send(this->rdid, [this, &index, value, any](Buffer& buffer) {
-			InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				index = static_cast<int32_t>(my_items_lis.size()) * 2;
-				my_items_lis.emplace_back(any);
-			}
-			buffer.write_integral<int32_t>(index);
-		});
+		return *index;
 	}
-	else
-	{
-		index = it->second;
-	}
-	if (inverse_map.count(any) == 0)
+
+	// value may intern nested values itself, so it's serialized before taking the lock
+	const Buffer::Encoding encoding = get_protocol()->get_wire()->get_encoding();
+	Buffer serialized;
+	serialized.set_encoding(encoding);
+	InternedAnySerializer::write<T>(get_serialization_context(), serialized, wrapper::get<T>(value));
+	const Buffer::ByteArray bytes = std::move(serialized).getRealArray();
+
+	std::unique_lock<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.ids.find(any);
+	if (it != shard.ids.end())
 	{
-		inverse_map[any] = index;
+		return it->second;
 	}
+	const int32_t index = my_items_count.fetch_add(1, std::memory_order_relaxed) * 2;
+	my_items_list.set(index / 2, any);
+	// id must reach the wire before any other thread may find it and send a message referring to it
+	get_protocol()->get_wire()->send_encoded(this->rdid, encoding, [&bytes, index](Buffer& buffer) {
+		buffer.write_byte_array_raw(bytes);
+		buffer.write_integral<int32_t>(index);
+	});
+	shard.ids.emplace(std::move(any), index);
 	return index;
 }
 }	 // namespace rd
@@ -20,7 +20,7 @@ public:
 	InternScheduler();
 	// endregion
 
-	void queue(std::function<void()> action) override;
+	void queue(util::unique_function<void()> action) override;
 
 	void flush() override;
 
@@ -7,6 +7,129 @@
 
 namespace rd
 {
+namespace
+{
+constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+/**
+ * \brief Converts UTF-16 or UTF-32 code units to UTF-8. Unpaired surrogates are kept as 3-byte sequences,
+ * so any string survives the round trip.
+ */
+template <typename CodeUnit>
+std::string encode_utf8(CodeUnit const* data, size_t len)
+{
+	std::string result;
+	result.reserve(len + len / 2);
+	for (size_t i = 0; i < len; ++i)
+	{
+		uint32_t cp = static_cast<std::make_unsigned_t<CodeUnit>>(data[i]);
+		if (sizeof(CodeUnit) == 2 && cp >= 0xD800 && cp < 0xDC00 && i + 1 < len)
+		{
+			const uint32_t low = static_cast<std::make_unsigned_t<CodeUnit>>(data[i + 1]);
+			if (low >= 0xDC00 && low < 0xE000)
+			{
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				++i;
+			}
+		}
+		if (cp > 0x10FFFF)
+		{
+			cp = REPLACEMENT_CHARACTER;
+		}
+
+		if (cp < 0x80)
+		{
+			result.push_back(static_cast<char>(cp));
+		}
+		else if (cp < 0x800)
+		{
+			result.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+			result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+		}
+		else if (cp < 0x10000)
+		{
+			result.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+			result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+			result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+		}
+		else
+		{
+			result.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+			result.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+			result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+			result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+		}
+	}
+	return result;
+}
+
+/**
+ * \brief Appends code units of UTF-8 [data] to [out]. Malformed sequences become U+FFFD.
+ */
+template <typename CodeUnit, typename Container>
+void decode_utf8(uint8_t const* data, size_t len, Container& out)
+{
+	out.reserve(out.size() + len);
+	size_t i = 0;
+	while (i < len)
+	{
+		const uint8_t lead = data[i];
+		size_t count = 0;
+		uint32_t cp = lead;
+		uint32_t min = 0;
+		bool valid = true;
+		if ((lead & 0xE0) == 0xC0)
+		{
+			count = 1;
+			cp = lead & 0x1F;
+			min = 0x80;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			count = 2;
+			cp = lead & 0x0F;
+			min = 0x800;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			count = 3;
+			cp = lead & 0x07;
+			min = 0x10000;
+		}
+		else if (lead >= 0x80)
+		{
+			valid = false;
+		}
+
+		valid = valid && i + count < len;
+		for (size_t k = 1; valid && k <= count; ++k)
+		{
+			const uint8_t next = data[i + k];
+			valid = (next & 0xC0) == 0x80;
+			cp = (cp << 6) | (next & 0x3F);
+		}
+		if (!valid || cp < min || cp > 0x10FFFF)
+		{
+			out.push_back(static_cast<CodeUnit>(REPLACEMENT_CHARACTER));
+			++i;
+			continue;
+		}
+		i += count + 1;
+
+		if (sizeof(CodeUnit) == 2 && cp >= 0x10000)
+		{
+			cp -= 0x10000;
+			out.push_back(static_cast<CodeUnit>(0xD800 + (cp >> 10)));
+			out.push_back(static_cast<CodeUnit>(0xDC00 + (cp & 0x3FF)));
+		}
+		else
+		{
+			out.push_back(static_cast<CodeUnit>(cp));
+		}
+	}
+}
+}	 // namespace
+
 Buffer::Buffer() : Buffer(16)
 {
 }
@@ -70,6 +193,33 @@ void Buffer::rewind()
 	set_position(0);
 }
 
+Buffer::Encoding Buffer::get_encoding() const
+{
+	return encoding;
+}
+
+void Buffer::set_encoding(Encoding value)
+{
+	encoding = value;
+}
+
+int32_t Buffer::read_compact_int32()
+{
+	return encoding == Encoding::Compact ? read_varint<int32_t>() : read_integral<int32_t>();
+}
+
+void Buffer::write_compact_int32(int32_t value)
+{
+	if (encoding == Encoding::Compact)
+	{
+		write_varint<int32_t>(value);
+	}
+	else
+	{
+		write_integral<int32_t>(value);
+	}
+}
+
 Buffer::ByteArray Buffer::getArray() const&
 {
 	return data_;
@@ -151,6 +301,16 @@ std::wstring read_wstring_spec<2>(Buffer& buffer)
 
 std::wstring Buffer::read_wstring()
 {
+	if (encoding == Encoding::Compact)
+	{
+		const int32_t len = read_compact_int32();
+		RD_ASSERT_THROW_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+		check_available(len);
+		std::wstring result;
+		decode_utf8<wchar_t>(current_pointer(), len, result);
+		offset += len;
+		return result;
+	}
 	return read_wstring_spec<sizeof(wchar_t)>(*this);
 }
 
@@ -175,12 +335,32 @@ void Buffer::write_wstring(std::wstring const& value)
 
 void Buffer::write_char16_string(const uint16_t* data, size_t len)
 {
+	if (encoding == Encoding::Compact)
+	{
+		const std::string utf8 = encode_utf8(data, len);
+		write_compact_int32(static_cast<int32_t>(utf8.size()));
+		write(reinterpret_cast<word_t const*>(utf8.data()), utf8.size());
+		return;
+	}
 	write_integral<int32_t>(static_cast<int32_t>(len));
 	write(reinterpret_cast<word_t const*>(data), sizeof(uint16_t) * len);
 }
 
 uint16_t* Buffer::read_char16_string()
-{	
+{
+	if (encoding == Encoding::Compact)
+	{
+		const int32_t utf8_len = read_compact_int32();
+		RD_ASSERT_THROW_MSG(utf8_len >= 0, "read null string(length =" + std::to_string(utf8_len) + ")");
+		check_available(utf8_len);
+		std::vector<uint16_t> units;
+		decode_utf8<uint16_t>(current_pointer(), utf8_len, units);
+		offset += utf8_len;
+		uint16_t* result = new uint16_t[units.size() + 1];
+		std::copy(units.begin(), units.end(), result);
+		result[units.size()] = 0;
+		return result;
+	}
 	const int32_t len = read_integral<int32_t>();
 	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
 	uint16_t * result = new uint16_t[len+1];
@@ -191,6 +371,13 @@ uint16_t* Buffer::read_char16_string()
 
 void Buffer::write_wstring(wstring_view value)
 {
+	if (encoding == Encoding::Compact)
+	{
+		const std::string utf8 = encode_utf8(value.data(), value.size());
+		write_compact_int32(static_cast<int32_t>(utf8.size()));
+		write(reinterpret_cast<word_t const*>(utf8.data()), utf8.size());
+		return;
+	}
 	write_wstring_spec<sizeof(wchar_t)>(*this, value);
 }
 
@@ -239,7 +426,7 @@ void Buffer::write_char(wchar_t value)
 
 void Buffer::read_byte_array(ByteArray& array)
 {
-	const int32_t length = read_integral<int32_t>();
+	const int32_t length = read_compact_int32();
 	array.resize(length);
 	read_byte_array_raw(array);
 }
@@ -12,6 +12,7 @@
 #include "std/allocator.h"
 #include "std/list.h"
 
+#include <cstring>
 #include <vector>
 #include <type_traits>
 #include <functional>
@@ -35,6 +36,17 @@ public:
 
 	using ByteArray = std::vector<word_t, Allocator>;
 
+	/**
+	 * \brief Layout of lengths, enums and strings. [Fixed] is understood by every RD implementation: 4-byte integers
+	 * and UTF-16 code units. [Compact] writes LEB128 varints and UTF-8 instead and may only be used when the
+	 * counterpart reads it too. Plain integrals are written with fixed width in both.
+	 */
+	enum class Encoding : uint8_t
+	{
+		Fixed,
+		Compact
+	};
+
 private:
 	template <int>
 	friend std::wstring read_wstring_spec(Buffer&);
@@ -46,6 +58,8 @@ private:
 
 	size_t offset = 0;
 
+	Encoding encoding = Encoding::Fixed;
+
 	// read
 	void read(word_t* dst, size_t size);
 
@@ -54,6 +68,13 @@ private:
 
 	size_t size() const;
 
+	/**
+	 * \brief Lengths and enums, 4 bytes in [Encoding::Fixed], zigzag varint in [Encoding::Compact].
+	 */
+	int32_t read_compact_int32();
+
+	void write_compact_int32(int32_t value);
+
 public:
 	// region ctor/dtor
 
@@ -83,6 +104,10 @@ public:
 
 	void rewind();
 
+	Encoding get_encoding() const;
+
+	void set_encoding(Encoding value);
+
 	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
 	T read_integral()
 	{
@@ -97,6 +122,52 @@ public:
 		write(reinterpret_cast<word_t const*>(&value), sizeof(T));
 	}
 
+	/**
+	 * \brief Reads LEB128 varint, signed values are zigzag encoded.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
+	T read_varint()
+	{
+		using unsigned_t = std::make_unsigned_t<T>;
+		unsigned_t x = 0;
+		for (size_t shift = 0;; shift += 7)
+		{
+			RD_ASSERT_THROW_MSG(shift < sizeof(T) * 8, "varint is too long for " + std::to_string(sizeof(T)) + " bytes");
+			word_t byte;
+			read(&byte, 1);
+			x |= static_cast<unsigned_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				break;
+			}
+		}
+		if (std::is_signed<T>::value)
+		{
+			x = (x >> 1) ^ (~(x & 1) + 1);
+		}
+		return static_cast<T>(x);
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	void write_varint(T const& value)
+	{
+		using unsigned_t = std::make_unsigned_t<T>;
+		unsigned_t x = static_cast<unsigned_t>(value);
+		if (std::is_signed<T>::value)
+		{
+			x = (x << 1) ^ static_cast<unsigned_t>(value < 0 ? ~unsigned_t(0) : unsigned_t(0));
+		}
+		word_t bytes[(sizeof(T) * 8 + 6) / 7];
+		size_t count = 0;
+		while (x >= 0x80)
+		{
+			bytes[count++] = static_cast<word_t>(x | 0x80);
+			x >>= 7;
+		}
+		bytes[count++] = static_cast<word_t>(x);
+		write(bytes, count);
+	}
+
 	template <typename T, typename = typename std::enable_if_t<std::is_floating_point<T>::value, T>>
 	T read_floating_point()
 	{
@@ -111,66 +182,80 @@ public:
 		write(reinterpret_cast<word_t const*>(&value), sizeof(T));
 	}
 
+	/**
+	 * \brief Trivially copyable elements are copied in one go. The length is checked against the bytes left once,
+	 * before the array is allocated, so a corrupt length throws instead of allocating more than the message holds.
+	 */
 	template <template <class, class> class C, typename T, typename A = allocator<T>,
-		typename = typename std::enable_if_t<util::is_pod_v<T>>>
+		typename = typename std::enable_if_t<std::is_trivially_copyable<T>::value>>
 	C<T, A> read_array()
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_compact_int32();
 		RD_ASSERT_MSG(len >= 0, "read null array(length = " + std::to_string(len) + ")");
+		const size_t bytes = sizeof(T) * static_cast<size_t>(len);
+		check_available(bytes);
 		C<T, A> result;
 		using rd::resize;
 		resize(result, len);
 		if (len > 0)
 		{
-			read(reinterpret_cast<word_t*>(&result[0]), sizeof(T) * len);
+			std::memcpy(&result[0], current_pointer(), bytes);
+			offset += bytes;
 		}
 		return result;
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>>
-	C<value_or_wrapper<T>, A> read_array(std::function<value_or_wrapper<T>()> reader)
+	/**
+	 * \brief [reader] is taken as a template parameter rather than std::function, so reading an element is inlined
+	 * into the loop.
+	 */
+	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>, typename F>
+	C<value_or_wrapper<T>, A> read_array(F&& reader)
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_compact_int32();
 		C<value_or_wrapper<T>, A> result;
 		using rd::resize;
 		resize(result, len);
 		for (int32_t i = 0; i < len; ++i)
 		{
-			result[i] = std::move(reader());
+			result[i] = reader();
 		}
 		return result;
 	}
 
 	template <template <class, class> class C, typename T, typename A = allocator<T>,
-		typename = typename std::enable_if_t<util::is_pod_v<T>>>
+		typename = typename std::enable_if_t<std::is_trivially_copyable<T>::value>>
 	void write_array(C<T, A> const& container)
 	{
 		using rd::size;
-		const int32_t& len = rd::size(container);
-		write_integral<int32_t>(static_cast<int32_t>(len));
+		const int32_t len = size(container);
+		write_compact_int32(len);
 		if (len > 0)
 		{
-			write(reinterpret_cast<word_t const*>(&container[0]), sizeof(T) * len);
+			const size_t bytes = sizeof(T) * static_cast<size_t>(len);
+			require_available(bytes);
+			std::memcpy(current_pointer(), &container[0], bytes);
+			offset += bytes;
 		}
 	}
 
 	template <template <class, class> class C, typename T, typename A = allocator<T>,
-		typename = typename std::enable_if_t<!rd::util::in_heap_v<T>>>
-	void write_array(C<T, A> const& container, std::function<void(T const&)> writer)
+		typename = typename std::enable_if_t<!rd::util::in_heap_v<T>>, typename F>
+	void write_array(C<T, A> const& container, F&& writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_compact_int32(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(e);
 		}
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>>
-	void write_array(C<Wrapper<T>, A> const& container, std::function<void(T const&)> writer)
+	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>, typename F>
+	void write_array(C<Wrapper<T>, A> const& container, F&& writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_compact_int32(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(*e);
@@ -214,27 +299,27 @@ public:
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	T read_enum()
 	{
-		int32_t x = read_integral<int32_t>();
+		int32_t x = read_compact_int32();
 		return static_cast<T>(x);
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	void write_enum(T const& x)
 	{
-		write_integral<int32_t>(static_cast<int32_t>(x));
+		write_compact_int32(static_cast<int32_t>(x));
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	T read_enum_set()
 	{
-		int32_t x = read_integral<int32_t>();
+		int32_t x = read_compact_int32();
 		return static_cast<T>(x);
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	void write_enum_set(T const& x)
 	{
-		write_integral<int32_t>(static_cast<int32_t>(x));
+		write_compact_int32(static_cast<int32_t>(x));
 	}
 
 	template <typename T, typename F, typename = typename std::enable_if_t<util::is_same_v<typename util::result_of_t<F()>, T>>>
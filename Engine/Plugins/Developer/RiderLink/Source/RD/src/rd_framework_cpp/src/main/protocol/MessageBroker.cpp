@@ -1,11 +1,12 @@
 #include "protocol/MessageBroker.h"
 
-#include "spdlog/sinks/stdout_color_sinks.h"
+#include "util/logging.h"
+
+#include <algorithm>
 
 namespace rd
 {
-std::shared_ptr<spdlog::logger> MessageBroker::logger =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logger", spdlog::color_mode::automatic);
+std::shared_ptr<spdlog::logger> MessageBroker::logger = util::create_logger("logger");
 
 static void execute(const IRdReactive* that, Buffer msg)
 {
@@ -13,6 +14,63 @@ static void execute(const IRdReactive* that, Buffer msg)
 	that->on_wire_received(std::move(msg));
 }
 
+constexpr size_t MessageBroker::SHARD_COUNT;
+constexpr size_t MessageBroker::MAX_RETIRED_LOCATIONS_PER_SHARD;
+
+MessageBroker::Shard& MessageBroker::shard_of(RdId const& id) const
+{
+	// fibonacci hashing, ids of one model often differ only in their low bits
+	const uint64_t mixed = static_cast<uint64_t>(id.get_hash()) * 0x9E3779B97F4A7C15ull;
+	return shards[static_cast<size_t>(mixed >> 60) % SHARD_COUNT];
+}
+
+IRdReactive const* MessageBroker::find_subscription(RdId const& id) const
+{
+	Shard const& shard = shard_of(id);
+	std::shared_lock<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.subscriptions.find(id);
+	return it != shard.subscriptions.end() ? it->second.entity : nullptr;
+}
+
+IRdReactive const* MessageBroker::find_subscription(
+	RdId const& id, size_t message_size, util::intrusive_ptr<IRdResponseReceiver const>& response) const
+{
+	Shard& shard = shard_of(id);
+	std::shared_lock<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.subscriptions.find(id);
+	if (it == shard.subscriptions.end())
+	{
+		auto response_it = shard.responses.find(id);
+		if (response_it != shard.responses.end())
+		{
+			response = util::intrusive_ptr<IRdResponseReceiver const>(response_it->second);
+			return nullptr;
+		}
+		unadvised_messages.fetch_add(1, std::memory_order_relaxed);
+		unadvised_bytes.fetch_add(message_size, std::memory_order_relaxed);
+		return nullptr;
+	}
+	it->second.messages.fetch_add(1, std::memory_order_relaxed);
+	it->second.bytes.fetch_add(message_size, std::memory_order_relaxed);
+	return it->second.entity;
+}
+
+void MessageBroker::account_response(IRdResponseReceiver const& response, size_t message_size) const
+{
+	const RdId call_id = response.get_call()->get_id();
+	Shard& shard = shard_of(call_id);
+	std::shared_lock<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.subscriptions.find(call_id);
+	if (it == shard.subscriptions.end())
+	{
+		unadvised_messages.fetch_add(1, std::memory_order_relaxed);
+		unadvised_bytes.fetch_add(message_size, std::memory_order_relaxed);
+		return;
+	}
+	it->second.messages.fetch_add(1, std::memory_order_relaxed);
+	it->second.bytes.fetch_add(message_size, std::memory_order_relaxed);
+}
+
 void MessageBroker::invoke(const IRdReactive* that, Buffer msg, bool sync) const
 {
 	if (sync)
@@ -22,22 +80,16 @@ void MessageBroker::invoke(const IRdReactive* that, Buffer msg, bool sync) const
 	else
 	{
 		auto action = [this, that, message = std::move(msg)]() mutable {
-			bool exists_id = false;
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				exists_id = subscriptions.count(that->get_id()) > 0;
-			}
-			if (exists_id)
+			if (find_subscription(that->get_id()) != nullptr)
 			{
 				execute(that, std::move(message));
 			}
 			else
 			{
-				logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(that->get_id()));
+				SPDLOG_LOGGER_TRACE(logger, "Disappeared Handler for Reactive entities with id: {}", to_string(that->get_id()));
 			}
 		};
-		std::function<void()> function = util::make_shared_function(std::move(action));
-		that->get_wire_scheduler()->queue(std::move(function));
+		that->get_wire_scheduler()->queue(std::move(action));
 	}
 }
 
@@ -45,13 +97,38 @@ MessageBroker::MessageBroker(IScheduler* defaultScheduler) : default_scheduler(d
 {
 }
 
-void MessageBroker::dispatch(RdId id, Buffer message) const
+MessageBroker::~MessageBroker()
+{
+	for (Shard& shard : shards)
+	{
+		for (auto const& it : shard.responses)
+		{
+			it.second->release();
+		}
+	}
+}
+
+void MessageBroker::dispatch(RdId id, Buffer message, size_t message_size) const
 {
 	RD_ASSERT_MSG(!id.isNull(), "id mustn't be null")
 
+	util::intrusive_ptr<IRdResponseReceiver const> response;
+	IRdReactive const* s = find_subscription(id, message_size, response);
+	if (response)
+	{
+		account_response(*response, message_size);
+		message.read_integral<int16_t>();	 // skip context
+		response->on_response_received(std::move(message));
+		return;
+	}
+	if (s != nullptr && (s->get_wire_scheduler() == default_scheduler || s->get_wire_scheduler()->out_of_order_execution))
+	{
+		invoke(s, std::move(message));
+		return;
+	}
+
 	{	 // synchronized recursively
 		std::lock_guard<decltype(lock)> guard(lock);
-		IRdReactive const* s = subscriptions[id];
 		if (s == nullptr)
 		{
 			auto it = broker.find(id);
@@ -60,19 +137,19 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 				it = broker.emplace(id, Mq{}).first;
 			}
 
-			broker[id].default_scheduler_messages.emplace(std::move(message));
+			it->second.default_scheduler_messages.emplace(std::move(message));
 
-			auto action = [this, it, id]() mutable {
-				auto& current = it->second;
-				IRdReactive const* subscription = subscriptions[id];
+			auto action = [this, id]() mutable {
+				IRdReactive const* subscription = find_subscription(id);
 
 				optional<Buffer> message;
 				{
 					std::lock_guard<decltype(lock)> guard(lock);
-					if (!current.default_scheduler_messages.empty())
+					auto it = broker.find(id);
+					if (it != broker.end() && !it->second.default_scheduler_messages.empty())
 					{
-						message = make_optional<Buffer>(std::move(current.default_scheduler_messages.front()));
-						current.default_scheduler_messages.pop();
+						message = make_optional<Buffer>(std::move(it->second.default_scheduler_messages.front()));
+						it->second.default_scheduler_messages.pop();
 					}
 				}
 				if (subscription != nullptr)
@@ -84,47 +161,40 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 				}
 				else
 				{
-					logger->trace("No handler for id: {}", to_string(id));
+					SPDLOG_LOGGER_TRACE(logger, "No handler for id: {}", to_string(id));
 				}
 
-				if (current.default_scheduler_messages.empty())
+				std::lock_guard<decltype(lock)> guard(lock);
+				auto it = broker.find(id);
+				if (it != broker.end() && it->second.default_scheduler_messages.empty())
 				{
-					auto t = std::move(broker[id]);
-					broker.erase(id);
-					for (auto& it : t.custom_scheduler_messages)
+					auto t = std::move(it->second);
+					broker.erase(it);
+					for (auto& custom_message : t.custom_scheduler_messages)
 					{
 						RD_ASSERT_MSG(subscription->get_wire_scheduler() != default_scheduler,
 							"require equals of wire and default schedulers")
-						invoke(subscription, std::move(it));
+						invoke(subscription, std::move(custom_message));
 					}
 				}
 			};
-			std::function<void()> function = util::make_shared_function(std::move(action));
-			default_scheduler->queue(std::move(function));
+			default_scheduler->queue(std::move(action));
 		}
 		else
 		{
-			if (s->get_wire_scheduler() == default_scheduler || s->get_wire_scheduler()->out_of_order_execution)
+			// In order custom scheduler: keep behind messages still waiting on the default scheduler.
+			auto it = broker.find(id);
+			if (it == broker.end())
 			{
 				invoke(s, std::move(message));
 			}
 			else
 			{
-				auto it = broker.find(id);
-				if (it == broker.end())
-				{
-					invoke(s, std::move(message));
-				}
-				else
-				{
-					Mq& mq = it->second;
-					mq.custom_scheduler_messages.push_back(std::move(message));
-				}
+				Mq& mq = it->second;
+				mq.custom_scheduler_messages.push_back(std::move(message));
 			}
 		}
 	}
-
-	//        }
 }
 
 void MessageBroker::advise_on(Lifetime lifetime, IRdReactive const* entity) const
@@ -138,9 +208,168 @@ void MessageBroker::advise_on(Lifetime lifetime, IRdReactive const* entity) cons
 	if (!lifetime->is_terminated())
 	{
 		auto key = entity->get_id();
-		IRdReactive const* value = entity;
-		subscriptions[key] = value;
-		lifetime->add_action([this, key]() { subscriptions.erase(key); });
+		{
+			Shard& shard = shard_of(key);
+			std::unique_lock<decltype(shard.lock)> shard_guard(shard.lock);
+			Subscription& subscription = shard.subscriptions[key];
+			subscription.entity = entity;
+			subscription.location = entity->get_location();
+		}
+		lifetime->add_action([this, key]() {
+			Shard& shard = shard_of(key);
+			std::unique_lock<decltype(shard.lock)> shard_guard(shard.lock);
+			auto it = shard.subscriptions.find(key);
+			if (it == shard.subscriptions.end())
+			{
+				return;
+			}
+			Subscription const& subscription = it->second;
+			if (subscription.messages.load(std::memory_order_relaxed) != 0)
+			{
+				std::string location = to_string(subscription.location);
+				auto retired_it = shard.retired.find(location);
+				if (retired_it == shard.retired.end() && shard.retired.size() < MAX_RETIRED_LOCATIONS_PER_SHARD)
+				{
+					retired_it = shard.retired.emplace(location, EntityStats{RdId::Null(), location, 0, 0}).first;
+				}
+				EntityStats& retired = retired_it != shard.retired.end() ? retired_it->second : shard.retired_overflow;
+				retired.id = key;
+				retired.messages += subscription.messages.load(std::memory_order_relaxed);
+				retired.bytes += subscription.bytes.load(std::memory_order_relaxed);
+			}
+			shard.subscriptions.erase(it);
+		});
+	}
+}
+
+void MessageBroker::advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const
+{
+	RD_ASSERT_MSG(!task_id.isNull(), "task id mustn't be null")
+
+	receiver->add_ref();
+	IRdResponseReceiver const* replaced = nullptr;
+	{
+		Shard& shard = shard_of(task_id);
+		std::unique_lock<decltype(shard.lock)> guard(shard.lock);
+		IRdResponseReceiver const*& advised = shard.responses[task_id];
+		replaced = advised;
+		advised = receiver;
+	}
+	if (replaced != nullptr)
+	{
+		replaced->release();
+	}
+}
+
+void MessageBroker::unadvise_response(RdId const& task_id) const
+{
+	IRdResponseReceiver const* receiver = nullptr;
+	{
+		Shard& shard = shard_of(task_id);
+		std::unique_lock<decltype(shard.lock)> guard(shard.lock);
+		auto it = shard.responses.find(task_id);
+		if (it == shard.responses.end())
+		{
+			return;
+		}
+		receiver = it->second;
+		shard.responses.erase(it);
+	}
+	// outside of the lock, the receiver may be recycled
+	receiver->release();
+}
+
+std::vector<MessageBroker::EntityStats> MessageBroker::get_stats() const
+{
+	std::vector<EntityStats> result;
+	// entities of one location are spread over the shards by their ids
+	rd::unordered_map<std::string, size_t> retired_by_location;
+	EntityStats retired_overflow{RdId::Null(), "<retired>", 0, 0};
+	for (Shard const& shard : shards)
+	{
+		std::shared_lock<decltype(shard.lock)> guard(shard.lock);
+		for (auto const& it : shard.retired)
+		{
+			auto inserted = retired_by_location.emplace(it.first, result.size());
+			if (inserted.second)
+			{
+				result.push_back(it.second);
+			}
+			else
+			{
+				EntityStats& entry = result[inserted.first->second];
+				entry.messages += it.second.messages;
+				entry.bytes += it.second.bytes;
+			}
+		}
+		retired_overflow.messages += shard.retired_overflow.messages;
+		retired_overflow.bytes += shard.retired_overflow.bytes;
+	}
+
+	for (Shard const& shard : shards)
+	{
+		std::shared_lock<decltype(shard.lock)> guard(shard.lock);
+		for (auto const& it : shard.subscriptions)
+		{
+			Subscription const& subscription = it.second;
+			const uint64_t messages = subscription.messages.load(std::memory_order_relaxed);
+			if (messages == 0)
+			{
+				continue;
+			}
+			const uint64_t bytes = subscription.bytes.load(std::memory_order_relaxed);
+			std::string location = to_string(subscription.location);
+
+			// an entity advised again after it was retired continues the entry of its location
+			auto retired_it = retired_by_location.find(location);
+			if (retired_it != retired_by_location.end())
+			{
+				EntityStats& entry = result[retired_it->second];
+				entry.id = it.first;
+				entry.messages += messages;
+				entry.bytes += bytes;
+				retired_by_location.erase(retired_it);
+				continue;
+			}
+			result.push_back(EntityStats{it.first, std::move(location), messages, bytes});
+		}
+	}
+
+	const uint64_t messages = unadvised_messages.load(std::memory_order_relaxed);
+	if (messages != 0)
+	{
+		result.push_back(EntityStats{RdId::Null(), "<unadvised>", messages, unadvised_bytes.load(std::memory_order_relaxed)});
+	}
+	if (retired_overflow.messages != 0)
+	{
+		result.push_back(std::move(retired_overflow));
+	}
+	return result;
+}
+
+std::string MessageBroker::dump_stats() const
+{
+	std::vector<EntityStats> stats = get_stats();
+	std::sort(stats.begin(), stats.end(), [](EntityStats const& lhs, EntityStats const& rhs) { return lhs.bytes > rhs.bytes; });
+
+	std::string result;
+	for (EntityStats const& entry : stats)
+	{
+		std::string frames = entry.location.empty() ? to_string(entry.id) : entry.location;
+		// locations are dot separated, with "::" before some of the parts
+		std::string::size_type pos = 0;
+		while ((pos = frames.find("::", pos)) != std::string::npos)
+		{
+			frames.replace(pos, 2, ".");
+		}
+		std::replace(frames.begin(), frames.end(), '.', ';');
+		std::replace(frames.begin(), frames.end(), ' ', '_');
+
+		result += frames;
+		result += ' ';
+		result += std::to_string(entry.bytes);
+		result += '\n';
 	}
+	return result;
 }
 }	 // namespace rd
@@ -7,12 +7,19 @@
 #endif
 
 #include "base/IRdReactive.h"
+#include "base/IRdResponseReceiver.h"
 
 #include "std/unordered_map.h"
+#include "util/intrusive_ptr.h"
 
 #include "spdlog/spdlog.h"
 
+#include <array>
+#include <atomic>
 #include <queue>
+#include <shared_mutex>
+#include <string>
+#include <vector>
 
 #include <rd_framework_export.h>
 
@@ -40,26 +47,133 @@ public:
 
 class RD_FRAMEWORK_API MessageBroker final
 {
+public:
+	/**
+	 * \brief Messages received for one entity and their total size, for diagnostics.
+	 */
+	struct EntityStats
+	{
+		RdId id;
+		std::string location;
+		uint64_t messages = 0;
+		uint64_t bytes = 0;
+	};
+
 private:
+	/**
+	 * \brief Counters are bumped by dispatch under the shared lock of the shard.
+	 */
+	struct Subscription
+	{
+		IRdReactive const* entity = nullptr;
+		RName location;
+		std::atomic<uint64_t> messages{0};
+		std::atomic<uint64_t> bytes{0};
+	};
+
+	/**
+	 * \brief Part of the subscription table. Dispatch only reads it, so readers share the lock
+	 * and the receiver thread doesn't contend with schedulers advising entities in other shards.
+	 */
+	struct Shard
+	{
+		mutable std::shared_mutex lock;
+		rd::unordered_map<RdId, Subscription> subscriptions;
+
+		/**
+		 * \brief Counters of entities which are no longer advised, so a snapshot covers the whole session. Entities
+		 * created and destroyed over and over share a location, so they are summed up by it.
+		 */
+		rd::unordered_map<std::string, EntityStats> retired;
+
+		/**
+		 * \brief Counters of retired entities whose location didn't fit into [retired] anymore.
+		 */
+		EntityStats retired_overflow;
+
+		/**
+		 * \brief Receivers of pending call responses by task id, each holding a reference.
+		 */
+		rd::unordered_map<RdId, IRdResponseReceiver const*> responses;
+	};
+
+	static constexpr size_t SHARD_COUNT = 16;
+
+	/**
+	 * \brief Bound of [Shard::retired], so entities with unique locations can't grow it for the whole session.
+	 */
+	static constexpr size_t MAX_RETIRED_LOCATIONS_PER_SHARD = 256;
+
 	IScheduler* default_scheduler = nullptr;
-	mutable rd::unordered_map<RdId, IRdReactive const*> subscriptions;
+	mutable std::array<Shard, SHARD_COUNT> shards;
+
+	/**
+	 * \brief Messages which arrived before their entity was advised, or have to wait behind such ones.
+	 */
 	mutable rd::unordered_map<RdId, Mq> broker;
 
 	mutable std::recursive_mutex lock;
 
+	// messages which arrived before their entity was advised
+	mutable std::atomic<uint64_t> unadvised_messages{0};
+	mutable std::atomic<uint64_t> unadvised_bytes{0};
+
 	static std::shared_ptr<spdlog::logger> logger;
 
+	Shard& shard_of(RdId const& id) const;
+
+	IRdReactive const* find_subscription(RdId const& id) const;
+
+	/**
+	 * \brief Same as [find_subscription], also accounts a message of [message_size] bytes to the entity found. If it's
+	 * the response to a call instead, its receiver is returned in [response].
+	 */
+	IRdReactive const* find_subscription(
+		RdId const& id, size_t message_size, util::intrusive_ptr<IRdResponseReceiver const>& response) const;
+
+	/**
+	 * \brief Accounts a response of [message_size] bytes to the call [response] belongs to.
+	 */
+	void account_response(IRdResponseReceiver const& response, size_t message_size) const;
+
 	void invoke(const IRdReactive* that, Buffer msg, bool sync = false) const;
 
 public:
 	// region ctor/dtor
 
 	explicit MessageBroker(IScheduler* defaultScheduler);
+
+	~MessageBroker();
 	// endregion
 
-	void dispatch(RdId id, Buffer message) const;
+	/**
+	 * \brief Routes [message] to the entity advised with [id]. [message_size] is the size of the message on the wire.
+	 */
+	void dispatch(RdId id, Buffer message, size_t message_size) const;
 
 	void advise_on(Lifetime lifetime, IRdReactive const* entity) const;
+
+	/**
+	 * \brief See [IWire::advise_response]. Responses are delivered on the thread calling [dispatch], the receiver
+	 * hands them over to the scheduler it wants them on.
+	 */
+	void advise_response(RdId const& task_id, IRdResponseReceiver const* receiver) const;
+
+	void unadvise_response(RdId const& task_id) const;
+
+	/**
+	 * \brief Traffic received per entity since the broker was created, in no particular order. Entities which are
+	 * no longer advised are summed up per location, under the id of one of them, and into an entry with a null id
+	 * and the location "<retired>" past [MAX_RETIRED_LOCATIONS_PER_SHARD]. Messages which arrived before their
+	 * entity was advised are accounted to an entry with a null id and the location "<unadvised>".
+	 */
+	std::vector<EntityStats> get_stats() const;
+
+	/**
+	 * \brief [get_stats] in the folded stacks format of flame graph tools: a line per entity with its location
+	 * split into frames and the bytes received, heaviest first.
+	 */
+	std::string dump_stats() const;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
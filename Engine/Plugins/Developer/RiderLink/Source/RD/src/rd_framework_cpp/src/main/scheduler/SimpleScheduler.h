@@ -21,7 +21,7 @@ public:
 
 	void flush() override;
 
-	void queue(std::function<void()> action) override;
+	void queue(util::unique_function<void()> action) override;
 
 	bool is_active() const override;
 };
@@ -23,7 +23,7 @@ public:
 	virtual ~SynchronousScheduler() = default;
 	// endregion
 
-	void queue(std::function<void()> action) override;
+	void queue(util::unique_function<void()> action) override;
 
 	void flush() override;
 
@@ -6,6 +6,8 @@
 #pragma warning(disable:4251)
 #endif
 
+#include <util/unique_function.h>
+
 #include <functional>
 #include <thread>
 
@@ -34,7 +36,7 @@ public:
 	 *
 	 * \param action to be queued.
 	 */
-	virtual void queue(std::function<void()> action) = 0;
+	virtual void queue(util::unique_function<void()> action) = 0;
 
 	// TO-DO
 	bool out_of_order_execution = false;
@@ -45,7 +47,7 @@ public:
 	 * \brief invoke action immediately if scheduler is active, queue it otherwise.
 	 * \param action to be invoked
 	 */
-	virtual void invoke_or_queue(std::function<void()> action);
+	virtual void invoke_or_queue(util::unique_function<void()> action);
 
 	virtual void flush() = 0;
 
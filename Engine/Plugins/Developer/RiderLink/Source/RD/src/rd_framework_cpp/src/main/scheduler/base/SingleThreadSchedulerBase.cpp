@@ -1,55 +1,154 @@
 #include "SingleThreadSchedulerBase.h"
 
 #include "util/core_util.h"
+#include <util/thread_util.h>
 
-#include "ctpl_stl.h"
-#include "spdlog/include/spdlog/sinks/stdout_color_sinks.h"
+#include "util/logging.h"
 
 namespace rd
 {
-SingleThreadSchedulerBase::PoolTask::PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler)
-	: f(std::move(f)), scheduler(scheduler)
+SingleThreadSchedulerBase::SingleThreadSchedulerBase(std::string name)
+	: log(util::create_logger(name)), name(std::move(name))
 {
+	thread = std::thread(&SingleThreadSchedulerBase::ThreadProc, this);
+	thread_id = thread.get_id();
 }
 
-void SingleThreadSchedulerBase::PoolTask::operator()(int id) const
+void SingleThreadSchedulerBase::run(Task* batch)
 {
-	try
+	const auto started_at = clock_t::now();
+	clock_t::duration batch_time_in_queue{0};
+	clock_t::duration batch_max_time_in_queue{0};
+	uint32_t count = 0;
+
+	Task* last = nullptr;
+	for (Task* task = batch; task != nullptr; task = task->next)
 	{
-		f();
-		--scheduler->tasks_executing;
+		const auto time_in_queue = started_at - task->queued_at;
+		batch_time_in_queue += time_in_queue;
+		batch_max_time_in_queue = (std::max)(batch_max_time_in_queue, time_in_queue);
+
+		try
+		{
+			task->action();
+		}
+		catch (std::exception const& e)
+		{
+			log->error("Background task failed, scheduler={} | {}", name, e.what());
+		}
+		task->action = nullptr;
+		last = task;
+		++count;
 	}
-	catch (std::exception const& e)
+
 	{
-		scheduler->log->error("Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
-		--scheduler->tasks_executing;
+		std::lock_guard<decltype(lock)> guard(lock);
+		last->next = free_tasks;
+		free_tasks = batch;
+
+		++stats.batches_executed;
+		stats.tasks_executed += count;
+		stats.total_time_in_queue += batch_time_in_queue;
+		stats.max_time_in_queue = (std::max)(stats.max_time_in_queue, batch_max_time_in_queue);
+
+		tasks_executing -= count;
 	}
+	idle_cv.notify_all();
 }
 
-SingleThreadSchedulerBase::SingleThreadSchedulerBase(std::string name)
-	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
-	, name(std::move(name))
-	, pool(std::make_unique<ctpl::thread_pool>(1))
+void SingleThreadSchedulerBase::ThreadProc()
 {
-	RD_ASSERT_THROW_MSG(pool->size() == 1, "Thread pool wasn't properly initalized");
-	thread_id = pool->get_thread(0).get_id();
+	rd::util::set_thread_name(name.c_str());
+
+	while (true)
+	{
+		Task* batch = nullptr;
+		{
+			std::unique_lock<decltype(lock)> ul(lock);
+			queue_cv.wait(ul, [this]() -> bool { return head != nullptr || stopping; });
+			if (head == nullptr)
+			{
+				return;
+			}
+			// drain everything queued so far in one go
+			batch = head;
+			head = tail = nullptr;
+			stats.queue_depth = 0;
+		}
+		run(batch);
+	}
 }
 
-void SingleThreadSchedulerBase::flush()
+void SingleThreadSchedulerBase::stop()
 {
-	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (stopping)
+		{
+			return;
+		}
+		stopping = true;
+	}
+	queue_cv.notify_all();
 
-	while (tasks_executing != 0)
+	// A thread can't join itself, when stopped from one of its own tasks the destructor joins it.
+	if (!is_active() && thread.joinable())
 	{
-		std::this_thread::yield();
+		thread.join();
 	}
 }
 
-void SingleThreadSchedulerBase::queue(std::function<void()> action)
+void SingleThreadSchedulerBase::flush()
+{
+	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
+
+	std::unique_lock<decltype(lock)> ul(lock);
+	idle_cv.wait(ul, [this]() -> bool { return tasks_executing == 0; });
+}
+
+void SingleThreadSchedulerBase::queue(util::unique_function<void()> action)
 {
-	++tasks_executing;
-	PoolTask task(action, this);
-	pool->push(std::move(task));
+	bool was_empty = false;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (stopping)
+		{
+			log->debug("Task queued after termination is dropped, scheduler={}", name);
+			return;
+		}
+
+		Task* task = free_tasks;
+		if (task != nullptr)
+		{
+			free_tasks = task->next;
+			task->next = nullptr;
+		}
+		else
+		{
+			task = new Task();
+		}
+		task->action = std::move(action);
+		task->queued_at = clock_t::now();
+
+		was_empty = head == nullptr;
+		if (was_empty)
+		{
+			head = task;
+		}
+		else
+		{
+			tail->next = task;
+		}
+		tail = task;
+
+		++tasks_executing;
+		stats.max_queue_depth = (std::max)(stats.max_queue_depth, ++stats.queue_depth);
+	}
+	// a non-empty queue means the scheduler thread is already awake or about to drain it
+	if (was_empty)
+	{
+		queue_cv.notify_one();
+	}
 }
 
 bool SingleThreadSchedulerBase::is_active() const
@@ -57,5 +156,27 @@ bool SingleThreadSchedulerBase::is_active() const
 	return thread_id == std::this_thread::get_id();
 }
 
-SingleThreadSchedulerBase::~SingleThreadSchedulerBase() = default;
-}	 // namespace rd
\ No newline at end of file
+SingleThreadSchedulerBase::Stats SingleThreadSchedulerBase::get_stats() const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	return stats;
+}
+
+SingleThreadSchedulerBase::~SingleThreadSchedulerBase()
+{
+	stop();
+
+	RD_ASSERT_MSG(!is_active(), "Scheduler " + name + " must not be destroyed by one of its own tasks");
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+
+	for (Task* task = free_tasks; task != nullptr;)
+	{
+		Task* next = task->next;
+		delete task;
+		task = next;
+	}
+}
+}	 // namespace rd
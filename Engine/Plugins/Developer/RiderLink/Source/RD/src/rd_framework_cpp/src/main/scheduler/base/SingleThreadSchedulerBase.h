@@ -10,37 +10,75 @@
 #include "lifetime/Lifetime.h"
 #include "spdlog/spdlog.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 #include <rd_framework_export.h>
 
-namespace ctpl
-{
-class thread_pool;
-}
-
 namespace rd
 {
 class RD_FRAMEWORK_API SingleThreadSchedulerBase : public IScheduler
 {
+public:
+	using clock_t = std::chrono::steady_clock;
+
+	/**
+	 * \brief Snapshot of the scheduler queue, for diagnostics.
+	 */
+	struct Stats
+	{
+		uint32_t queue_depth = 0;
+		uint32_t max_queue_depth = 0;
+		uint64_t tasks_executed = 0;
+		uint64_t batches_executed = 0;
+		clock_t::duration total_time_in_queue{0};
+		clock_t::duration max_time_in_queue{0};
+	};
+
 protected:
 	std::shared_ptr<spdlog::logger> log;
 	std::string name;
 
 	std::atomic_uint32_t tasks_executing{0};
 	std::atomic_uint32_t active{0};
-	std::unique_ptr<ctpl::thread_pool> pool;
 
-	class PoolTask
+	/**
+	 * \brief Intrusive queue node. Nodes are recycled through [free_tasks], so queueing doesn't allocate
+	 * once the scheduler has warmed up.
+	 */
+	struct Task
 	{
-		std::function<void()> f;
-		SingleThreadSchedulerBase* scheduler;
+		util::unique_function<void()> action;
+		clock_t::time_point queued_at;
+		Task* next = nullptr;
+	};
 
-	public:
-		explicit PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler);
+	mutable std::mutex lock;
+	std::condition_variable queue_cv;
+	std::condition_variable idle_cv;
 
-		void operator()(int id) const;
-	};
+	Task* head = nullptr;
+	Task* tail = nullptr;
+	Task* free_tasks = nullptr;
+	bool stopping = false;
+
+	Stats stats;
+
+	std::thread thread;
+
+	void run(Task* batch);
+
+	void ThreadProc();
+
+	/**
+	 * \brief Stops accepting tasks, everything already queued still executes. Joins the scheduler thread, unless
+	 * called from one of its own tasks, then the join is left to the destructor, which must run on another thread.
+	 */
+	void stop();
 
 public:
 	// region ctor/dtor
@@ -51,9 +89,11 @@ public:
 
 	void flush() override;
 
-	void queue(std::function<void()> action) override;
+	void queue(util::unique_function<void()> action) override;
 
 	bool is_active() const override;
+
+	Stats get_stats() const;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
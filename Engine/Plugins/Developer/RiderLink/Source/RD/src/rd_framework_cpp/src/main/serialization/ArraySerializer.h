@@ -2,25 +2,66 @@
 #define RD_CPP_ARRAYSERIALIZER_H
 
 #include "serialization/SerializationCtx.h"
+#include "serialization/Polymorphic.h"
 #include "framework_traits.h"
 
+#include <type_traits>
 #include <vector>
 
 namespace rd
 {
+namespace util
+{
+/**
+ * \brief Whether [S] writes a [T] as its raw bytes, so arrays of it can go through the bulk copy of [Buffer].
+ * bool and wchar_t have serializers of their own which don't.
+ */
+template <typename S, typename T>
+constexpr bool is_raw_serializer_v = std::is_same<S, Polymorphic<T>>::value && std::is_arithmetic<T>::value &&
+									 !std::is_same<T, bool>::value && !std::is_same<T, wchar_t>::value;
+}	 // namespace util
+
 template <typename S, template <class, class> class C, typename T = typename util::read_t<S>,
 	typename A = allocator<value_or_wrapper<T>>>
 class ArraySerializer
 {
+	template <typename U = T>
+	static std::enable_if_t<util::is_raw_serializer_v<S, U>, C<value_or_wrapper<T>, A>> read_elements(
+		SerializationCtx& /*ctx*/, Buffer& buffer)
+	{
+		return buffer.read_array<C, T, A>();
+	}
+
+	template <typename U = T>
+	static std::enable_if_t<!util::is_raw_serializer_v<S, U>, C<value_or_wrapper<T>, A>> read_elements(
+		SerializationCtx& ctx, Buffer& buffer)
+	{
+		return buffer.read_array<C, T, A>([&] { return S::read(ctx, buffer); });
+	}
+
+	template <typename U = T>
+	static std::enable_if_t<util::is_raw_serializer_v<S, U>> write_elements(
+		SerializationCtx& /*ctx*/, Buffer& buffer, C<value_or_wrapper<T>, A> const& value)
+	{
+		buffer.write_array<C, T, A>(value);
+	}
+
+	template <typename U = T>
+	static std::enable_if_t<!util::is_raw_serializer_v<S, U>> write_elements(
+		SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value)
+	{
+		buffer.write_array<C, T, A>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
+	}
+
 public:
 	static C<value_or_wrapper<T>, A> read(SerializationCtx& ctx, Buffer& buffer)
 	{
-		return buffer.read_array<C, T, A>([&] { return S::read(ctx, buffer); });
+		return read_elements(ctx, buffer);
 	}
 
 	static void write(SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value)
 	{
-		buffer.write_array<C, T, A>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
+		write_elements(ctx, buffer, value);
 	}
 };
 }	 // namespace rd
@@ -7,6 +7,7 @@
 #include "scheduler/SynchronousScheduler.h"
 #include "WiredRdTask.h"
 
+#include <memory>
 #include <thread>
 
 #if defined(_MSC_VER)
@@ -32,6 +33,12 @@ class RdCall : public virtual RdReactiveBase, public ISerializable
 
 	mutable optional<RdId> sync_task_id;
 
+	/**
+	 * \brief Tasks waiting for their response, boxed so that the call stays movable.
+	 */
+	std::unique_ptr<detail::PendingRdTasks<TRes, ResSer>> pending_tasks{
+		std::make_unique<detail::PendingRdTasks<TRes, ResSer>>()};
+
 public:
 	// region ctor/dtor
 	RdCall() = default;
@@ -61,6 +68,8 @@ public:
 		RdBindableBase::init(lifetime);
 		bind_lifetime = lifetime;
 		get_wire()->advise(lifetime, this);
+		pending_tasks->open();
+		lifetime->add_action([pending_tasks = pending_tasks.get()] { pending_tasks->cancel_all(); });
 	}
 
 	/**
@@ -102,6 +111,17 @@ public:
 		return start_internal(request, false, responseScheduler ? responseScheduler : get_default_scheduler());
 	}
 
+	/**
+	 * \brief Same as [start], also cancels the task if [lifetime] is terminated before the response arrives.
+	 */
+	WiredRdTask<TRes, ResSer> start(
+		Lifetime lifetime, TReq const& request, IScheduler* responseScheduler = nullptr) const
+	{
+		auto task = start(request, responseScheduler);
+		task.cancel_on(std::move(lifetime));
+		return task;
+	}
+
 	void on_wire_received(Buffer buffer) const override
 	{
 		RD_ASSERT_MSG(false, "RdCall.on_wire_received called")
@@ -117,7 +137,7 @@ private:
 		}
 
 		RdId task_id = get_protocol()->get_identity()->next(rdid);
-		WiredRdTask<TRes, ResSer> task{*bind_lifetime, *this, task_id, scheduler};
+		WiredRdTask<TRes, ResSer> task{detail::WiredRdTaskImpl<TRes, ResSer>::start(*pending_tasks, *this, task_id, scheduler)};
 
 		if (sync)
 		{
@@ -130,8 +150,11 @@ private:
 		}
 
 		get_wire()->send(rdid, [&](Buffer& buffer) {
-			spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
-				to_string(task_id), to_string(request));
+			if (util::should_log(log_send(), spdlog::level::trace))
+			{
+				log_send().trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
+					to_string(task_id), to_string(request));
+			}
 			task_id.write(buffer);
 			ReqSer::write(get_serialization_context(), buffer, request);
 		});
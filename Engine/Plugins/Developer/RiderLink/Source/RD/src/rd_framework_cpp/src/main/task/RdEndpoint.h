@@ -28,7 +28,14 @@ class RdEndpoint : public virtual RdReactiveBase, public ISerializable
 	using handler_t = std::function<RdTask<TRes, ResSer>(Lifetime, TReq const&)>;
 	mutable handler_t local_handler;
 
-	mutable tsl::ordered_map<RdId, RdTask<TRes, ResSer>, rd::hash<RdId>> awaiting_tasks;	// TO-DO get rid of it
+	void send_response(RdId const& task_id, RdTaskResult<TRes, ResSer> const& task_result) const
+	{
+		if (util::should_log(log_send(), spdlog::level::trace))
+		{
+			log_send().trace("endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(task_result));
+		}
+		get_wire()->send(task_id, [&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
+	}
 public:
 	// region ctor/dtor
 
@@ -94,29 +101,35 @@ public:
 	{
 		auto task_id = RdId::read(buffer);
 		auto value = ReqSer::read(get_serialization_context(), buffer);
-		spdlog::get("logReceived")->trace("endpoint {}::{} request = {}", to_string(location), to_string(rdid), to_string(value));
+		if (util::should_log(log_received(), spdlog::level::trace))
+		{
+			log_received().trace("endpoint {}::{} request = {}", to_string(location), to_string(rdid), to_string(value));
+		}
 		if (!local_handler)
 		{
 			throw std::invalid_argument("handler is empty for RdEndPoint");
 		}
-		auto task = awaiting_tasks[task_id] = {};
+		optional<RdTask<TRes, ResSer>> task;
 		try
 		{
-			task = local_handler(*bind_lifetime, wrapper::get<TReq>(value));
+			task.emplace(local_handler(*bind_lifetime, wrapper::get<TReq>(value)));
 		}
 		catch (std::exception const& e)
 		{
-			task.fault(e);
+			task.emplace();
+			task->fault(e);
 		}
-		task.advise(*bind_lifetime,
-			[this, task_id, &task](RdTaskResult<TRes, ResSer> const& task_result)
-			{
-				spdlog::get("logSend")->trace(
-					"endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(*task.result));
-				get_wire()->send(
-					task_id, [&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
-				// TO-DO remove from awaiting_tasks
-			});
+
+		// synchronous handlers are done already, nothing has to wait for them
+		if (task->has_value())
+		{
+			send_response(task_id, task->value_or_throw());
+			return;
+		}
+
+		// the task's state stays alive as long as whoever completes it holds the task
+		task->advise(*bind_lifetime,
+			[this, task_id](RdTaskResult<TRes, ResSer> const& task_result) { send_response(task_id, task_result); });
 	}
 
 	friend bool operator==(const RdEndpoint& lhs, const RdEndpoint& rhs)
@@ -5,12 +5,22 @@
 #include "serialization/Polymorphic.h"
 
 #include <functional>
+#include <type_traits>
+#include <utility>
+
+// co_await support for RdTask, for modules built as C++20
+#if defined(RD_TASK_COROUTINES) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define RD_TASK_HAS_COROUTINES 1
+#endif
 
 namespace rd
 {
 /**
  * \brief Represents a task that can be asynchronously executed.
  *
+ * Copies share one state, which is pooled, see [detail::RdTaskImpl].
+ *
  * \tparam T type of stored value
  * \tparam S "SerDes" for value
  */
@@ -22,9 +32,13 @@ protected:
 
 	using TRes = RdTaskResult<T, S>;
 
-	mutable std::shared_ptr<detail::RdTaskImpl<T, S>> impl{std::make_shared<detail::RdTaskImpl<T, S>>()};
+	using impl_t = detail::RdTaskImpl<T, S>;
+
+	util::intrusive_ptr<impl_t> impl{impl_t::create()};
 
-	Property<RdTaskResult<T, S>>* result{&impl->result};
+	explicit RdTask(util::intrusive_ptr<impl_t> impl) : impl(std::move(impl))
+	{
+	}
 
 public:
 	using result_type = RdTaskResult<T, S>;
@@ -55,40 +69,39 @@ public:
 
 	void set(WT value) const
 	{
-		typename TRes::Success t(std::move(value));
-		impl->result.set(std::move(t));
+		impl->set_if_empty(typename TRes::Success(std::move(value)));
 	}
 
 	void set_result(TRes value) const
 	{
-		impl->result.set(std::move(value));
+		impl->set_if_empty(std::move(value));
 	}
 
 	void set_result_if_empty(TRes value) const
 	{
-		impl->result.set_if_empty(std::move(value));
+		impl->set_if_empty(std::move(value));
 	}
 
 	void cancel() const
 	{
-		impl->result.set(typename TRes::Cancelled());
+		impl->set_if_empty(typename TRes::Cancelled());
 	}
 
 	void fault(std::exception const& e) const
 	{
-		impl->result.set(typename TRes::Fault(e));
+		impl->set_if_empty(typename TRes::Fault(e));
 	}
 
 	bool has_value() const
 	{
-		return impl->result.has_value();
+		return impl->has_value();
 	}
 
 	const TRes& value_or_throw() const
 	{
-		if (impl->result.has_value())
+		if (impl->has_value())
 		{
-			return impl->result.get();
+			return impl->get();
 		}
 		else
 		{
@@ -108,18 +121,97 @@ public:
 
 	bool is_faulted() const
 	{
-		return has_value() && value_or_throw().is_faulted();	// TO-DO atomic
+		return has_value() && value_or_throw().is_faulted();
 	}
 
-	void advise(Lifetime lifetime, std::function<void(TRes const&)> handler) const
+	/**
+	 * \brief Invokes [handler] with the result once the task is complete, unless [lifetime] is terminated by then.
+	 */
+	template <typename F>
+	void advise(Lifetime lifetime, F&& handler) const
 	{
-		impl->result.advise(lifetime, [handler = std::move(handler)](optional<TRes> const& opt_value) {
-			if (opt_value)
+		impl->advise(std::move(lifetime), std::forward<F>(handler));
+	}
+
+	/**
+	 * \brief Cancels the task if [lifetime] is terminated before the task completes.
+	 */
+	void cancel_on(Lifetime lifetime) const
+	{
+		impl->cancel_on(std::move(lifetime));
+	}
+
+	/**
+	 * \brief Task completed with [f] applied to the value of this task. If this task is cancelled or faulted, or [f]
+	 * throws, the returned one is cancelled or faulted as well. [f] runs on the thread completing this task.
+	 *
+	 * \tparam R type of the value returned by [f]
+	 */
+	template <typename F, typename R = std::decay_t<decltype(std::declval<F&>()(std::declval<T const&>()))>>
+	RdTask<R> then(F f) const
+	{
+		RdTask<R> next;
+		impl->advise(Lifetime::Eternal(), [next, f = std::move(f)](TRes const& result) mutable {
+			if (result.is_succeeded())
+			{
+				try
+				{
+					next.set(f(result.unwrap()));
+				}
+				catch (std::exception const& e)
+				{
+					next.fault(e);
+				}
+			}
+			else if (result.is_canceled())
 			{
-				handler(*opt_value);
+				next.cancel();
+			}
+			else
+			{
+				result.as_faulted([&next](typename TRes::Fault const& fault) {
+					using Fault = typename RdTaskResult<R>::Fault;
+					next.set_result(Fault(fault.reason_type_fqn, fault.reason_message, fault.reason_as_text));
+				});
 			}
 		});
+		return next;
+	}
+
+#ifdef RD_TASK_HAS_COROUTINES
+	/**
+	 * \brief Resumes the awaiting coroutine on the thread completing the task, with its result.
+	 */
+	class Awaiter
+	{
+		RdTask task;
+
+	public:
+		explicit Awaiter(RdTask task) : task(std::move(task))
+		{
+		}
+
+		bool await_ready() const
+		{
+			return task.has_value();
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) const
+		{
+			task.advise(Lifetime::Eternal(), [handle](TRes const&) { handle.resume(); });
+		}
+
+		TRes const& await_resume() const
+		{
+			return task.value_or_throw();
+		}
+	};
+
+	Awaiter operator co_await() const
+	{
+		return Awaiter(*this);
 	}
+#endif
 };
 }	 // namespace rd
 
@@ -3,25 +3,287 @@
 
 #include "serialization/Polymorphic.h"
 #include "RdTaskResult.h"
+#include "lifetime/Lifetime.h"
+#include "util/intrusive_ptr.h"
+#include "util/unique_function.h"
 
 #include "thirdparty.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 namespace rd
 {
-template <typename, typename>
-class RdTask;
-
 namespace detail
 {
+/**
+ * \brief Free list of task states of type [State], one per thread. States released on a thread are handed out again
+ * by the next tasks created on it, so a thread issuing calls in a loop stops allocating them after the first ones.
+ */
+template <typename State>
+class RdTaskPool
+{
+	static constexpr size_t CAPACITY = 256;
+
+	struct FreeList
+	{
+		std::vector<State*> states;
+
+		~FreeList()
+		{
+			closed() = true;
+			for (State* state : states)
+			{
+				delete state;
+			}
+		}
+	};
+
+	// stays readable after the free list of an exiting thread is destroyed, states released then are deleted
+	static bool& closed()
+	{
+		static thread_local bool value = false;
+		return value;
+	}
+
+	static FreeList& free_list()
+	{
+		static thread_local FreeList list;
+		return list;
+	}
+
+public:
+	static State* acquire()
+	{
+		if (!closed())
+		{
+			std::vector<State*>& states = free_list().states;
+			if (!states.empty())
+			{
+				State* state = states.back();
+				states.pop_back();
+				return state;
+			}
+		}
+		return new State();
+	}
+
+	/**
+	 * \brief Takes back [state] whose last reference is gone.
+	 */
+	static void recycle(State* state)
+	{
+		if (!closed())
+		{
+			std::vector<State*>& states = free_list().states;
+			if (states.size() < CAPACITY)
+			{
+				state->reset();
+				states.push_back(state);
+				return;
+			}
+		}
+		delete state;
+	}
+};
+
+/**
+ * \brief Shared state of RdTask: the result, once there is one, and the handlers waiting for it. Intrusively
+ * refcounted and pooled per thread, see [RdTaskPool].
+ *
+ * A task completes once, results set after the first one are dropped. Handlers run on the thread completing the task,
+ * or right away on the advising thread if it is complete already.
+ */
 template <typename T, typename S = Polymorphic<T>>
 class RdTaskImpl
 {
+public:
+	using result_type = RdTaskResult<T, S>;
+	using handler_t = util::unique_function<void(result_type const&)>;
+
 private:
-	mutable Property<RdTaskResult<T, S>> result;
+	friend class RdTaskPool<RdTaskImpl>;
+
+	struct Continuation
+	{
+		Lifetime lifetime;
+		handler_t handler;
+	};
+
+	mutable std::atomic<int32_t> ref_count{0};
+
+	std::mutex lock;
+	std::atomic<bool> completed{false};
+	optional<result_type> result;
+	// capacity is kept while the state is pooled
+	std::vector<Continuation> continuations;
+
+	// lifetime the task is cancelled with and the id of the action doing it, see [cancel_on]
+	optional<Lifetime> cancellation_lifetime;
+	LifetimeImpl::counter_t cancellation_id = -1;
+
+protected:
+	// region ctor/dtor
+	RdTaskImpl() = default;
+	// endregion
+
+	/**
+	 * \brief Invoked once the result is in, before the handlers run.
+	 */
+	virtual void on_completed()
+	{
+	}
+
+	/**
+	 * \brief Returns a state whose last reference is gone to its pool.
+	 */
+	virtual void recycle()
+	{
+		RdTaskPool<RdTaskImpl>::recycle(this);
+	}
+
+	/**
+	 * \brief Clears the state before it's pooled.
+	 */
+	virtual void reset()
+	{
+		result = nullopt;
+		completed.store(false, std::memory_order_relaxed);
+		continuations.clear();
+		cancellation_lifetime = nullopt;
+		cancellation_id = -1;
+	}
 
 public:
-	template <typename, typename>
-	friend class ::rd::RdTask;
+	RdTaskImpl(RdTaskImpl const&) = delete;
+
+	RdTaskImpl& operator=(RdTaskImpl const&) = delete;
+
+	virtual ~RdTaskImpl() = default;
+
+	static util::intrusive_ptr<RdTaskImpl> create()
+	{
+		return util::intrusive_ptr<RdTaskImpl>(RdTaskPool<RdTaskImpl>::acquire());
+	}
+
+	void add_ref() const
+	{
+		ref_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void release() const
+	{
+		if (ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			const_cast<RdTaskImpl*>(this)->recycle();
+		}
+	}
+
+	bool has_value() const
+	{
+		return completed.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * \brief The result, only to be read once [has_value] returned true.
+	 */
+	result_type const& get() const
+	{
+		return *result;
+	}
+
+	/**
+	 * \brief Completes the task with [value] unless it's complete already.
+	 * \return whether the task was completed by this call
+	 */
+	bool set_if_empty(result_type value)
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			if (result)
+			{
+				return false;
+			}
+			result.emplace(std::move(value));
+			completed.store(true, std::memory_order_release);
+		}
+
+		// nothing is added to the continuations or the cancellation once the result is in, see [advise]
+		if (cancellation_lifetime)
+		{
+			(*cancellation_lifetime)->remove_action(cancellation_id);
+		}
+		on_completed();
+
+		struct ClearOnExit
+		{
+			std::vector<Continuation>& continuations;
+
+			~ClearOnExit()
+			{
+				continuations.clear();
+			}
+		} clear_on_exit{continuations};
+		for (Continuation& continuation : continuations)
+		{
+			if (!continuation.lifetime->is_terminated())
+			{
+				continuation.handler(*result);
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * \brief Invokes [handler] with the result unless [lifetime] is terminated by then.
+	 */
+	void advise(Lifetime lifetime, handler_t handler)
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			if (!result)
+			{
+				continuations.push_back(Continuation{std::move(lifetime), std::move(handler)});
+				return;
+			}
+		}
+		if (!lifetime->is_terminated())
+		{
+			handler(*result);
+		}
+	}
+
+	/**
+	 * \brief Cancels the task when [lifetime] is terminated before it completes. A task is cancelled with one lifetime.
+	 */
+	void cancel_on(Lifetime lifetime)
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			if (result)
+			{
+				return;
+			}
+			RD_ASSERT_MSG(!cancellation_lifetime, "task is cancelled with a lifetime already")
+			if (!lifetime->is_terminated())
+			{
+				try
+				{
+					cancellation_id = lifetime->add_action([self = util::intrusive_ptr<RdTaskImpl>(this)] {
+						self->set_if_empty(typename result_type::Cancelled());
+					});
+					cancellation_lifetime = std::move(lifetime);
+					return;
+				}
+				catch (std::invalid_argument const&)
+				{
+					// terminated meanwhile
+				}
+			}
+		}
+		set_if_empty(typename result_type::Cancelled());
+	}
 };
 }	 // namespace detail
 }	 // namespace rd
@@ -147,7 +147,7 @@ public:
 		return v.index() == 2;
 	}
 
-	void as_faulted(std::function<void(Fault const&)> f)
+	void as_faulted(std::function<void(Fault const&)> f) const
 	{
 		f(rd::get<Fault>(v));
 	}
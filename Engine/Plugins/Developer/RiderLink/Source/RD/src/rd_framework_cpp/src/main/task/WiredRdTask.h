@@ -8,17 +8,17 @@
 
 namespace rd
 {
+/**
+ * \brief Task started by RdCall, completed with the response to the call's request.
+ */
 template <typename T, typename S = Polymorphic<T>>
 class WiredRdTask final : public RdTask<T, S>
 {
-	mutable std::shared_ptr<detail::WiredRdTaskImpl<T, S>> impl{};
-
 public:
 	// region ctor/dtor
 	WiredRdTask() = delete;
 
-	WiredRdTask(Lifetime lifetime, RdReactiveBase const& call, RdId rdid, IScheduler* scheduler)
-		: impl(std::make_shared<detail::WiredRdTaskImpl<T, S>>(lifetime, call, rdid, scheduler, RdTask<T, S>::result))
+	explicit WiredRdTask(util::intrusive_ptr<detail::WiredRdTaskImpl<T, S>> impl) : RdTask<T, S>(std::move(impl))
 	{
 	}
 
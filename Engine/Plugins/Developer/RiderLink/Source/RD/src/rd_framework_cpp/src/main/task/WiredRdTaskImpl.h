@@ -2,67 +2,243 @@
 #define RD_CPP_WIREDRDTASKIMPL_H
 
 #include "serialization/Polymorphic.h"
+#include "RdTaskImpl.h"
 #include "RdTaskResult.h"
+#include "base/IRdResponseReceiver.h"
+#include "base/RdReactiveBase.h"
+
+#include <atomic>
+#include <mutex>
 
 namespace rd
 {
-template <typename, typename>
-class WiredRdTask;
-
 namespace detail
 {
+template <typename T, typename S>
+class WiredRdTaskImpl;
+
+/**
+ * \brief Tasks of one call whose response is still to come, linked through the tasks themselves. The list holds
+ * a reference to each of them. Tasks left when the call is unbound are cancelled.
+ */
+template <typename T, typename S>
+class PendingRdTasks
+{
+	std::mutex lock;
+	bool closed = false;
+	WiredRdTaskImpl<T, S>* head = nullptr;
+
+public:
+	/**
+	 * \brief Accepts tasks again after the call is bound anew.
+	 */
+	void open()
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		closed = false;
+	}
+
+	/**
+	 * \return false if the call has been unbound, the task isn't linked then
+	 */
+	bool link(WiredRdTaskImpl<T, S>* task)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (closed)
+		{
+			return false;
+		}
+		task->add_ref();
+		task->next = head;
+		if (head)
+		{
+			head->prev = task;
+		}
+		head = task;
+		task->linked = true;
+		return true;
+	}
+
+	/**
+	 * \return whether [task] was linked, the reference the list held is the caller's then
+	 */
+	bool unlink(WiredRdTaskImpl<T, S>* task)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (!task->linked)
+		{
+			return false;
+		}
+		(task->prev ? task->prev->next : head) = task->next;
+		if (task->next)
+		{
+			task->next->prev = task->prev;
+		}
+		task->prev = task->next = nullptr;
+		task->linked = false;
+		return true;
+	}
+
+	/**
+	 * \brief Cancels the tasks linked and stops accepting new ones.
+	 */
+	void cancel_all()
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			closed = true;
+		}
+		while (true)
+		{
+			util::intrusive_ptr<WiredRdTaskImpl<T, S>> task;
+			{
+				std::lock_guard<decltype(lock)> guard(lock);
+				if (!head)
+				{
+					return;
+				}
+				task = util::intrusive_ptr<WiredRdTaskImpl<T, S>>(head);
+				head = head->next;
+				if (head)
+				{
+					head->prev = nullptr;
+				}
+				task->next = nullptr;
+				task->linked = false;
+				task->release();	// the list's reference, [task] holds another one
+			}
+			task->set_if_empty(typename RdTaskResult<T, S>::Cancelled());
+			task->unadvise();
+		}
+	}
+};
+
+/**
+ * \brief State of a task started by a call, which also receives the call's response. It's pooled like the state of
+ * other tasks, the wire and the call's [PendingRdTasks] hold references to it until it completes.
+ */
 template <typename T, typename S = Polymorphic<T>>
-class WiredRdTaskImpl : public RdReactiveBase
+class WiredRdTaskImpl final : public RdTaskImpl<T, S>, public IRdResponseReceiver
 {
 private:
-	Lifetime lifetime;
-	RdReactiveBase const* cutpoint{};
-	IScheduler* scheduler{};
-	Property<RdTaskResult<T, S>>* result{};
+	using result_type = RdTaskResult<T, S>;
+
+	friend class RdTaskPool<WiredRdTaskImpl>;
+
+	friend class PendingRdTasks<T, S>;
+
+	RdReactiveBase const* call = nullptr;
+	IWire const* wire = nullptr;
+	IScheduler* scheduler = nullptr;
+	PendingRdTasks<T, S>* pending = nullptr;
+	RdId task_id;
+
+	// links of [pending], guarded by its lock
+	WiredRdTaskImpl* prev = nullptr;
+	WiredRdTaskImpl* next = nullptr;
+	bool linked = false;
 
-	LifetimeImpl::counter_t termination_lifetime_id{};
+	// the response read on the wire's thread, until [scheduler] completes the task with it
+	mutable std::atomic<bool> response_received{false};
+	mutable optional<result_type> response;
+
+	WiredRdTaskImpl() = default;
+
+	void unadvise()
+	{
+		wire->unadvise_response(task_id);
+	}
+
+	void on_completed() override
+	{
+		// whoever completes the task holds a reference, so releasing the list's one doesn't recycle it
+		if (pending->unlink(this))
+		{
+			unadvise();
+			release();
+		}
+	}
+
+	void recycle() override
+	{
+		RdTaskPool<WiredRdTaskImpl>::recycle(this);
+	}
+
+	void reset() override
+	{
+		RdTaskImpl<T, S>::reset();
+		call = nullptr;
+		wire = nullptr;
+		scheduler = nullptr;
+		pending = nullptr;
+		task_id = RdId::Null();
+		response_received.store(false, std::memory_order_relaxed);
+		response = nullopt;
+	}
 
 public:
-	template <typename, typename>
-	friend class ::rd::WiredRdTask;
+	/**
+	 * \brief Task for the request [call] sends with [task_id]. Its response is subscribed to before the request goes
+	 * out, and the task is completed with it on [scheduler].
+	 */
+	static util::intrusive_ptr<WiredRdTaskImpl> start(
+		PendingRdTasks<T, S>& pending, RdReactiveBase const& call, RdId task_id, IScheduler* scheduler)
+	{
+		util::intrusive_ptr<WiredRdTaskImpl> task(RdTaskPool<WiredRdTaskImpl>::acquire());
+		task->call = &call;
+		task->wire = call.get_wire();
+		task->scheduler = scheduler;
+		task->pending = &pending;
+		task->task_id = task_id;
+
+		task->wire->advise_response(task_id, task.get());
+		if (!pending.link(task.get()))
+		{
+			task->unadvise();
+			task->set_if_empty(typename result_type::Cancelled());
+		}
+		return task;
+	}
 
-	WiredRdTaskImpl(
-		Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler, Property<RdTaskResult<T, S>>* result)
-		: lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), result(result)
+	void add_ref() const override
 	{
-		this->rdid = std::move(rdid);
-		cutpoint.get_wire()->advise(lifetime, this);
-		termination_lifetime_id =
-			lifetime->add_action([this]() { this->result->set_if_empty(typename RdTaskResult<T, S>::Cancelled{}); });
+		RdTaskImpl<T, S>::add_ref();
 	}
 
-	virtual ~WiredRdTaskImpl()
+	void release() const override
 	{
-		lifetime->remove_action(termination_lifetime_id);
+		RdTaskImpl<T, S>::release();
 	}
 
-	void on_wire_received(Buffer buffer) const override
+	IRdReactive const* get_call() const override
 	{
-		auto read_result = RdTaskResult<T, S>::read(cutpoint->get_serialization_context(), buffer);
-		spdlog::get("logReceived")
-			->trace("call {} {} received response {} : {}", to_string(cutpoint->get_location()), to_string(rdid), to_string(rdid),
-				to_string(read_result));
-		scheduler->queue([&, result = std::move(read_result)]() mutable {
-			if (this->result->has_value())
-			{
-				spdlog::get("logReceived")->trace("call {} {} response was dropped, task result is: {}", to_string(location), to_string(rdid),
-					to_string(result.unwrap()));
-			}
-			else
-			{
-				this->result->set_if_empty(std::move(result));
-			}
-		});
+		return call;
 	}
 
-	IScheduler* get_wire_scheduler() const override
+	void on_response_received(Buffer buffer) const override
 	{
-		return &SynchronousScheduler::Instance();
+		spdlog::logger& logger = RdReactiveBase::log_received();
+		auto read_result = result_type::read(call->get_serialization_context(), buffer);
+		if (util::should_log(logger, spdlog::level::trace))
+		{
+			logger.trace("call {} {} received response {} : {}", to_string(call->get_location()),
+				to_string(call->get_id()), to_string(task_id), to_string(read_result));
+		}
+		// a task id is answered once, anything after the first response is dropped
+		if (response_received.exchange(true, std::memory_order_acq_rel))
+		{
+			return;
+		}
+		response.emplace(std::move(read_result));
+
+		scheduler->queue([self = util::intrusive_ptr<WiredRdTaskImpl>(const_cast<WiredRdTaskImpl*>(this))] {
+			spdlog::logger& logger = RdReactiveBase::log_received();
+			if (!self->set_if_empty(std::move(*self->response)) && util::should_log(logger, spdlog::level::trace))
+			{
+				logger.trace("call {} {} response was dropped, task result is: {}",
+					to_string(self->call->get_location()), to_string(self->task_id), to_string(self->get()));
+			}
+		});
 	}
 };
 }	 // namespace detail
@@ -0,0 +1,39 @@
+#include "ByteArrayPool.h"
+
+namespace rd
+{
+ByteArrayPool::ByteArrayPool(size_t max_pooled_count, size_t max_pooled_capacity)
+	: max_pooled_count(max_pooled_count), max_pooled_capacity(max_pooled_capacity)
+{
+	free_list.reserve(max_pooled_count);
+}
+
+Buffer::ByteArray ByteArrayPool::acquire()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (!free_list.empty())
+		{
+			Buffer::ByteArray result = std::move(free_list.back());
+			free_list.pop_back();
+			return result;
+		}
+	}
+	return {};
+}
+
+void ByteArrayPool::release(Buffer::ByteArray&& array)
+{
+	if (array.capacity() == 0 || array.capacity() > max_pooled_capacity)
+	{
+		return;
+	}
+	array.clear();
+
+	std::lock_guard<decltype(lock)> guard(lock);
+	if (free_list.size() < max_pooled_count)
+	{
+		free_list.emplace_back(std::move(array));
+	}
+}
+}	 // namespace rd
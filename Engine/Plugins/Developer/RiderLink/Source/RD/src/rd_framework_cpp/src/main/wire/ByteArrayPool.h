@@ -0,0 +1,54 @@
+#ifndef RD_CPP_BYTEARRAYPOOL_H
+#define RD_CPP_BYTEARRAYPOOL_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/Buffer.h"
+
+#include <mutex>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Free list of byte arrays which keep their capacity between uses,
+ * so steady traffic of similarly sized packages stops hitting the allocator.
+ */
+class RD_FRAMEWORK_API ByteArrayPool
+{
+	std::mutex lock;
+	std::vector<Buffer::ByteArray> free_list;
+
+	size_t max_pooled_count;
+	size_t max_pooled_capacity;
+
+public:
+	// region ctor/dtor
+
+	explicit ByteArrayPool(size_t max_pooled_count = 1024, size_t max_pooled_capacity = 1u << 16);
+
+	// endregion
+
+	/**
+	 * \brief Returns an empty array, reusing the storage of a released one when there is any.
+	 */
+	Buffer::ByteArray acquire();
+
+	/**
+	 * \brief Gives the storage of [array] back to the pool. Oversized arrays are dropped
+	 * so that a single huge package doesn't stay resident.
+	 */
+	void release(Buffer::ByteArray&& array);
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_BYTEARRAYPOOL_H
@@ -1,22 +1,22 @@
 #include "ByteBufferAsyncProcessor.h"
 
-#include "util/guards.h"
 #include <util/thread_util.h>
 
-#include "spdlog/sinks/stdout_color_sinks.h"
+#include "util/logging.h"
+
+#include <algorithm>
 
 namespace rd
 {
-size_t ByteBufferAsyncProcessor::INITIAL_CAPACITY = 1024 * 1024;
+constexpr size_t ByteBufferAsyncProcessor::RING_CAPACITY;
+constexpr size_t ByteBufferAsyncProcessor::MAX_TRACKED_BATCHES;
+constexpr size_t ByteBufferAsyncProcessor::MAX_BATCH_SIZE;
 
-std::shared_ptr<spdlog::logger> ByteBufferAsyncProcessor::logger =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("byteBufferLog", spdlog::color_mode::automatic);
+std::shared_ptr<spdlog::logger> ByteBufferAsyncProcessor::logger = util::create_logger("byteBufferLog");
 
-ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(
-	std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor)
+ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(std::string id, processor_t processor)
 	: id(std::move(id)), processor(std::move(processor))
 {
-	data.reserve(INITIAL_CAPACITY);
 }
 
 void ByteBufferAsyncProcessor::cleanup0()
@@ -28,7 +28,7 @@ void ByteBufferAsyncProcessor::cleanup0()
 	}
 	// TO-DO clean data
 
-	cv.notify_all();
+	wakeup();
 }
 
 bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set, string_view action)
@@ -50,7 +50,7 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 
 		state = state_to_set;
 	}
-	cv.notify_all();
+	wakeup();
 
 	std::future_status status = async_future.wait_for(timeout);
 
@@ -67,39 +67,74 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 	return success;
 }
 
-void ByteBufferAsyncProcessor::add_data(std::vector<Buffer::ByteArray>&& new_data)
+void ByteBufferAsyncProcessor::wakeup()
 {
-	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-	std::move(new_data.begin(), new_data.end(), std::back_inserter(queue));
-	//		for (auto &&item : new_data) {
-	//			queue.emplace(std::move(item));
-	//		}
+	{
+		std::lock_guard<decltype(wakeup_lock)> guard(wakeup_lock);
+		wakeup_requested = true;
+	}
+	wakeup_cv.notify_all();
 }
 
-bool ByteBufferAsyncProcessor::reprocess()
+void ByteBufferAsyncProcessor::sleep()
 {
+	std::unique_lock<decltype(wakeup_lock)> ul(wakeup_lock);
+	consumer_sleeping = true;
+	// Pairs with the fence in put: either the producer sees the consumer asleep, or the consumer sees the package.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	wakeup_cv.wait(ul, [this]() -> bool { return wakeup_requested || !ring.empty(); });
+	wakeup_requested = false;
+	consumer_sleeping = false;
+}
+
+void ByteBufferAsyncProcessor::drain_ring()
+{
+	Buffer::ByteArray item;
+	while (ring.try_pop(item))
 	{
-		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+		queue.push_back(std::move(item));
+	}
+}
 
-		logger->debug("{}: reprocessing started", id);
+void ByteBufferAsyncProcessor::release_acknowledged()
+{
+	const sequence_number_t acknowledged = acknowledged_seqn;
+	while (current_seqn <= acknowledged && !pending_queue.empty())
+	{
+		pool.release(std::move(pending_queue.front()));
+		pending_queue.pop_front();
+		++current_seqn;
+	}
+}
 
-		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
-		processing_cv.wait(ul, [this]() -> bool { return !in_processing; });
+void ByteBufferAsyncProcessor::fill_batch(std::deque<Buffer::ByteArray>& source, size_t first)
+{
+	const size_t last = (std::min)(source.size(), first + MAX_BATCH_SIZE);
+	batch.clear();
+	for (size_t i = first; i < last; ++i)
+	{
+		batch.push_back(&source[i]);
+	}
+}
 
-		logger->debug("{}: reprocessing waited for main processing", id);
+bool ByteBufferAsyncProcessor::reprocess()
+{
+	std::lock_guard<decltype(processing_lock)> guard(processing_lock);
 
-		while (current_seqn <= acknowledged_seqn)
-		{
-			pending_queue.pop_front();
-			++current_seqn;
-		}
-		for (int i = 0; i < pending_queue.size(); ++i)
+	SPDLOG_LOGGER_DEBUG(logger, "{}: reprocessing started", id);
+
+	release_acknowledged();
+	if (pending_queue.empty())
+	{
+		return true;
+	}
+
+	for (size_t first = 0; first < pending_queue.size(); first += batch.size())
+	{
+		fill_batch(pending_queue, first);
+		if (!processor(batch, current_seqn + static_cast<sequence_number_t>(first)))
 		{
-			auto const& item = pending_queue[i];
-			if (!processor(item, current_seqn + i))
-			{
-				return false;
-			}
+			return false;
 		}
 	}
 	return true;
@@ -107,23 +142,34 @@ bool ByteBufferAsyncProcessor::reprocess()
 
 void ByteBufferAsyncProcessor::process()
 {
+	std::lock_guard<decltype(processing_lock)> guard(processing_lock);
+
+	SPDLOG_LOGGER_DEBUG(logger, "{}: processing started", id);
+
+	release_acknowledged();
+
+	// Everything queued since the last wake-up goes out in batches of at most [MAX_BATCH_SIZE],
+	// a batch the processor fails on stays queued with everything after it.
+	while (!queue.empty())
 	{
-		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
-		util::bool_guard bool_guard(in_processing);
+		fill_batch(queue, 0);
+		if (!processor(batch, max_sent_seqn + 1))
+		{
+			return;
+		}
 
-		logger->debug("{}: processing started", id);
+		const size_t count = batch.size();
+		max_sent_seqn += static_cast<sequence_number_t>(count);
+		std::move(queue.begin(), queue.begin() + count, std::back_inserter(pending_queue));
+		queue.erase(queue.begin(), queue.begin() + count);
 
-		while (!queue.empty() && processor(queue.front(), max_sent_seqn + 1))
+		std::lock_guard<decltype(stats_lock)> stats_guard(stats_lock);
+		if (sent_batches.size() == MAX_TRACKED_BATCHES)
 		{
-			++max_sent_seqn;
-			pending_queue.push_back(std::move(queue.front()));
-			queue.pop_front();
+			sent_batches.pop_front();
 		}
+		sent_batches.emplace_back(max_sent_seqn, clock_t::now());
 	}
-	processing_cv.notify_all();
-
-	cv.notify_all();
 }
 
 void ByteBufferAsyncProcessor::ThreadProc()
@@ -133,36 +179,40 @@ void ByteBufferAsyncProcessor::ThreadProc()
 
 	while (true)
 	{
+		if (state >= StateKind::Terminated)
 		{
-			std::lock_guard<decltype(lock)> guard(lock);
+			return;
+		}
 
-			if (state >= StateKind::Terminated)
+		// The ring is drained even while paused, so producers don't run into a full ring during a reconnect.
+		drain_ring();
+
+		if (queue.empty() || interrupt_balance != 0)
+		{
+			if (state >= StateKind::Stopping)
 			{
 				return;
 			}
+			sleep();
 
-			while (data.empty() || interrupt_balance != 0)
+			SPDLOG_LOGGER_DEBUG(logger, "{}'s ThreadProc waited for notify", id);
+
+			if (state >= StateKind::Terminating)
 			{
-				if (state >= StateKind::Stopping)
-				{
-					return;
-				}
-				cv.wait(lock);
-
-				logger->debug("{}'s ThreadProc waited for notify", id);
-
-				if (state >= StateKind::Terminating)
-				{
-					return;
-				}
+				return;
 			}
-			add_data(std::move(data));
-			data.clear();
 		}
 
 		try
 		{
-			process();
+			if (interrupt_balance == 0 && reprocess_requested.exchange(false))
+			{
+				reprocess();
+			}
+			if (interrupt_balance == 0)
+			{
+				process();
+			}
 		}
 		catch (std::exception const& e)
 		{
@@ -198,18 +248,34 @@ bool ByteBufferAsyncProcessor::terminate(time_t timeout)
 	return terminate0(timeout, StateKind::Terminating, "TERMINATE");
 }
 
+Buffer::ByteArray ByteBufferAsyncProcessor::acquire()
+{
+	return pool.acquire();
+}
+
 void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data)
 {
+	if (state >= StateKind::Stopping)
+	{
+		return;
+	}
+	while (!ring.try_push(std::move(new_data)))
 	{
-		std::lock_guard<decltype(lock)> guard(lock);
-
 		if (state >= StateKind::Stopping)
 		{
 			return;
 		}
-		data.emplace_back(std::move(new_data));
+		// Full ring: make sure the consumer runs, it never waits for producers.
+		wakeup();
+		std::this_thread::yield();
+	}
+	put_seqn.fetch_add(1, std::memory_order_relaxed);
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (consumer_sleeping)
+	{
+		wakeup();
 	}
-	cv.notify_all();
 }
 
 void ByteBufferAsyncProcessor::pause(const std::string& reason)
@@ -224,8 +290,7 @@ void ByteBufferAsyncProcessor::pause(const std::string& reason)
 	if (current_thread_id != async_thread_id)
 	{
 		logger->debug("{} paused from another thread : {}", id, to_string(current_thread_id));
-		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
-		processing_cv.wait(ul, [this]() -> bool { return !in_processing; });
+		std::lock_guard<decltype(processing_lock)> processing_guard(processing_lock);
 		logger->debug("{}: pausing waited for main processing", id);
 	}
 }
@@ -235,14 +300,15 @@ void ByteBufferAsyncProcessor::resume()
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
 
-		reprocess();
+		// Pending packages are resent by the consumer before anything queued after them.
+		reprocess_requested = true;
 
 		--interrupt_balance;
 
 		logger->debug("{} resumed", id);
 	}
 
-	cv.notify_all();
+	wakeup();
 }
 
 void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
@@ -251,15 +317,35 @@ void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 
 	if (seqn > acknowledged_seqn)
 	{
-		logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
+		SPDLOG_LOGGER_TRACE(logger, "{}: new acknowledged seqn: {}", this->id, seqn);
 		acknowledged_seqn = seqn;
+
+		const auto now = clock_t::now();
+		std::lock_guard<decltype(stats_lock)> stats_guard(stats_lock);
+		while (!sent_batches.empty() && sent_batches.front().first <= seqn)
+		{
+			const clock_t::duration latency = now - sent_batches.front().second;
+			sent_batches.pop_front();
+			++stats.acknowledged_batches;
+			stats.total_ack_latency += latency;
+			stats.max_ack_latency = (std::max)(stats.max_ack_latency, latency);
+		}
 	}
 	else
 	{
-		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn.load());
 	}
 }
 
+ByteBufferAsyncProcessor::Stats ByteBufferAsyncProcessor::get_stats() const
+{
+	std::lock_guard<decltype(stats_lock)> guard(stats_lock);
+	Stats result = stats;
+	const sequence_number_t unacknowledged = put_seqn.load(std::memory_order_relaxed) - acknowledged_seqn.load();
+	result.queue_depth = static_cast<uint64_t>((std::max)(unacknowledged, sequence_number_t{0}));
+	return result;
+}
+
 std::string to_string(ByteBufferAsyncProcessor::StateKind state)
 {
 	switch (state)
@@ -7,14 +7,17 @@
 #endif
 
 #include "protocol/Buffer.h"
+#include "ByteArrayPool.h"
+#include "MpscRing.h"
 #include "spdlog/spdlog.h"
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <mutex>
 #include <condition_variable>
 #include <future>
-#include <list>
+#include <deque>
 
 #include <rd_framework_export.h>
 
@@ -25,6 +28,27 @@ using sequence_number_t = int64_t;
 class RD_FRAMEWORK_API ByteBufferAsyncProcessor
 {
 public:
+	/**
+	 * \brief Packages flushed together, in sequence number order. The processor may patch them in place.
+	 */
+	using batch_t = std::vector<Buffer::ByteArray*>;
+
+	using processor_t = std::function<bool(batch_t const& batch, sequence_number_t first_seqn)>;
+
+	using clock_t = std::chrono::steady_clock;
+
+	/**
+	 * \brief Snapshot of the send queue, for diagnostics. Ack latency is measured per batch, from its first
+	 * send until the counterpart acknowledges its last package.
+	 */
+	struct Stats
+	{
+		uint64_t queue_depth = 0;
+		uint64_t acknowledged_batches = 0;
+		clock_t::duration total_ack_latency{0};
+		clock_t::duration max_ack_latency{0};
+	};
+
 	enum class StateKind
 	{
 		Initialized,
@@ -37,39 +61,66 @@ public:
 private:
 	using time_t = std::chrono::milliseconds;
 
-	static size_t INITIAL_CAPACITY;
+	static constexpr size_t RING_CAPACITY = 1u << 14;
+
+	/**
+	 * \brief Bound of [sent_batches], so a counterpart which never acknowledges doesn't grow it forever.
+	 */
+	static constexpr size_t MAX_TRACKED_BATCHES = 1024;
+
+	/**
+	 * \brief Most packages handed to [processor] at once, so a flood drained from the ring goes out in bounded writes.
+	 */
+	static constexpr size_t MAX_BATCH_SIZE = 1024;
 
 	std::recursive_mutex lock;
-	std::condition_variable_any cv;
 
 	std::string id;
 
-	std::function<bool(Buffer::ByteArray const&, sequence_number_t seqn)> processor;
+	processor_t processor;
 
-	StateKind state{StateKind::Initialized};
+	std::atomic<StateKind> state{StateKind::Initialized};
 	static std::shared_ptr<spdlog::logger> logger;
 
 	std::thread::id async_thread_id;
 	std::future<void> async_future;
 
-	std::vector<Buffer::ByteArray> data;
-	std::mutex queue_lock;
+	// producers
+	MpscRing<Buffer::ByteArray> ring{RING_CAPACITY};
+
+	// consumer wake-up, producers only touch it while the consumer sleeps
+	std::mutex wakeup_lock;
+	std::condition_variable wakeup_cv;
+	std::atomic<bool> consumer_sleeping{false};
+	bool wakeup_requested = false;
+
+	// consumer
 	std::deque<Buffer::ByteArray> queue{};
 	std::deque<Buffer::ByteArray> pending_queue{};
+	batch_t batch;
+
+	ByteArrayPool pool;
 
 	sequence_number_t max_sent_seqn = 0;
 	sequence_number_t current_seqn = 1;
-	sequence_number_t acknowledged_seqn = 0;
+	std::atomic<sequence_number_t> acknowledged_seqn{0};
+
+	// producers, every package put gets the next sequence number
+	std::atomic<sequence_number_t> put_seqn{0};
+
+	// last sequence number of every batch waiting for acknowledge, with the time it was sent
+	mutable std::mutex stats_lock;
+	std::deque<std::pair<sequence_number_t, clock_t::time_point>> sent_batches;
+	Stats stats;
 
-	int32_t interrupt_balance = 0;
-	bool in_processing = false;
+	std::atomic<int32_t> interrupt_balance{0};
+	std::atomic<bool> reprocess_requested{false};
 	std::mutex processing_lock;
-	std::condition_variable processing_cv;
 
 public:
 	// region ctor/dtor
 
-	explicit ByteBufferAsyncProcessor(std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor);
+	explicit ByteBufferAsyncProcessor(std::string id, processor_t processor);
 
 	// endregion
 private:
@@ -77,7 +128,18 @@ private:
 
 	bool terminate0(time_t timeout, StateKind state_to_set, string_view action);
 
-	void add_data(std::vector<Buffer::ByteArray>&& new_data);
+	void wakeup();
+
+	void sleep();
+
+	void drain_ring();
+
+	void release_acknowledged();
+
+	/**
+	 * \brief Fills [batch] with up to [MAX_BATCH_SIZE] packages of [source], starting at [first].
+	 */
+	void fill_batch(std::deque<Buffer::ByteArray>& source, size_t first);
 
 	bool reprocess();
 
@@ -92,6 +154,11 @@ public:
 
 	bool terminate(time_t timeout = time_t(0) /*InfiniteDuration*/);
 
+	/**
+	 * \brief Returns an empty array for the next package, backed by storage of already acknowledged ones.
+	 */
+	Buffer::ByteArray acquire();
+
 	void put(Buffer::ByteArray new_data);
 
 	void pause(const std::string& reason);
@@ -99,6 +166,8 @@ public:
 	void resume();
 
 	void acknowledge(int64_t seqn);
+
+	Stats get_stats() const;
 };
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state);
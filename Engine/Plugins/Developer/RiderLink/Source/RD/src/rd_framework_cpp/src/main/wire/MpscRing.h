@@ -0,0 +1,112 @@
+#ifndef RD_CPP_MPSCRING_H
+#define RD_CPP_MPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rd
+{
+/**
+ * \brief Bounded lock-free ring for many producers and a single consumer.
+ * Every cell carries a sequence number telling whether it is free for the producer
+ * which claimed its position, or holds a value published for the consumer.
+ */
+template <typename T>
+class MpscRing
+{
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos{0};
+	alignas(CACHE_LINE_SIZE) size_t dequeue_pos = 0;
+
+public:
+	// region ctor/dtor
+
+	/**
+	 * \param capacity must be a power of two
+	 */
+	explicit MpscRing(size_t capacity) : cells(new Cell[capacity]), mask(capacity - 1)
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpscRing(MpscRing const&) = delete;
+
+	MpscRing& operator=(MpscRing const&) = delete;
+
+	// endregion
+
+	/**
+	 * \brief Any thread. Returns false and leaves [value] untouched if the ring is full.
+	 */
+	bool try_push(T&& value)
+	{
+		size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Cell& cell = cells[pos & mask];
+			const size_t seq = cell.sequence.load(std::memory_order_acquire);
+			const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff == 0)
+			{
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.value = std::move(value);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * \brief Consumer thread only. Returns false if no value has been published yet.
+	 */
+	bool try_pop(T& result)
+	{
+		Cell& cell = cells[dequeue_pos & mask];
+		const size_t seq = cell.sequence.load(std::memory_order_acquire);
+		if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeue_pos + 1) < 0)
+		{
+			return false;
+		}
+		result = std::move(cell.value);
+		cell.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+		++dequeue_pos;
+		return true;
+	}
+
+	/**
+	 * \brief Consumer thread only.
+	 */
+	bool empty() const
+	{
+		const size_t seq = cells[dequeue_pos & mask].sequence.load(std::memory_order_acquire);
+		return static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeue_pos + 1) < 0;
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_MPSCRING_H
@@ -64,4 +64,19 @@ bool PkgInputStream::read(Buffer::word_t* res, size_t size)
 	}
 	return true;
 }
+
+bool PkgInputStream::try_take_rest(size_t size, Buffer& result)
+{
+	if (memory == static_cast<size_t>(-1) || buffer.get_position() + size != memory)
+	{
+		return false;
+	}
+	const size_t offset = buffer.get_position();
+	Buffer::ByteArray package = std::move(buffer).getArray();
+	package.resize(memory);
+	result = Buffer(std::move(package), offset);
+	// the stream is exhausted, next read requests a new package
+	memory = 0;
+	return true;
+}
 }	 // namespace rd
@@ -41,6 +41,12 @@ public:
 
 	bool read(Buffer::word_t* res, size_t size);
 
+	/**
+	 * \brief If exactly [size] unread bytes are left in the current package, moves the package storage into [result],
+	 * positioned at them, instead of copying. Returns false and leaves the stream untouched otherwise.
+	 */
+	bool try_take_rest(size_t size, Buffer& result);
+
 	template <typename T>
 	T read_integral()
 	{
@@ -20,7 +20,7 @@ void PumpScheduler::flush()
 	action();
 }
 
-void PumpScheduler::queue(std::function<void()> action)
+void PumpScheduler::queue(rd::util::unique_function<void()> action)
 {
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
@@ -29,7 +29,7 @@ public:
 	mutable std::mutex lock;
 
 	std::thread::id created_thread_id;
-	mutable std::queue<std::function<void()> > messages;
+	mutable std::queue<rd::util::unique_function<void()> > messages;
 
 	// region ctor/dtor
 
@@ -42,7 +42,7 @@ public:
 
 	void flush() override;
 
-	void queue(std::function<void()> action) override;
+	void queue(rd::util::unique_function<void()> action) override;
 
 	bool is_active() const override;
 
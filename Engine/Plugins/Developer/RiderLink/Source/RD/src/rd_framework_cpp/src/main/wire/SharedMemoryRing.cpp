@@ -0,0 +1,378 @@
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rd
+{
+constexpr size_t SharedMemoryRing::CAPACITY;
+
+namespace
+{
+constexpr uint32_t SEGMENT_MAGIC = 0x52445348;	  // "RDSH"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * \brief Position of one side of a ring. The side sleeping until the position moves sets [waiting] and waits for
+ * [wake] to change, the side moving it bumps [wake] if it sees [waiting].
+ */
+struct alignas(CACHE_LINE_SIZE) Cursor
+{
+	std::atomic<uint64_t> position{0};
+	std::atomic<uint32_t> wake{0};
+	std::atomic<uint32_t> waiting{0};
+};
+
+struct Ring
+{
+	Cursor written;
+	Cursor read;
+	// published by the reader with [SharedMemoryRing::acknowledge]
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> acknowledged{0};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+	"atomics in shared memory must be lock free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words must be plain 32-bit integers");
+}	 // namespace
+
+struct SharedMemoryRing::Segment
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t id;
+	uint64_t capacity;
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> closed{0};
+	Ring rings[2];
+
+	uint8_t* data(size_t index)
+	{
+		return reinterpret_cast<uint8_t*>(this) + sizeof(Segment) + index * CAPACITY;
+	}
+};
+
+#if defined(__linux__)
+
+namespace
+{
+constexpr size_t SEGMENT_SIZE = sizeof(SharedMemoryRing::Segment) + 2 * SharedMemoryRing::CAPACITY;
+
+std::atomic<uint32_t> next_segment{0};
+
+std::string segment_name(uint64_t id)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "/rd-wire-%016llx", static_cast<unsigned long long>(id));
+	return name;
+}
+
+// Not FUTEX_PRIVATE_FLAG, the words are shared with another process.
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout)
+{
+	timespec relative{};
+	relative.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+	relative.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>& word)
+{
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * \brief Wakes the side waiting for [cursor] to move without moving it, that side's wait ends as if it timed out.
+ */
+void nudge(Cursor& cursor)
+{
+	if (cursor.waiting.load(std::memory_order_seq_cst) != 0)
+	{
+		cursor.wake.fetch_add(1, std::memory_order_seq_cst);
+		futex_wake(cursor.wake);
+	}
+}
+
+/**
+ * \brief Moves [cursor] to [position] and wakes the counterpart if it waits for that.
+ */
+void advance(Cursor& cursor, uint64_t position)
+{
+	// sequentially consistent with the waiting side checking the position after announcing itself, so either that side
+	// sees the new position or this one sees it waiting
+	cursor.position.store(position, std::memory_order_seq_cst);
+	nudge(cursor);
+}
+
+/**
+ * \brief Waits at most [timeout] for [cursor] to move away from [position] or the segment to be closed.
+ */
+uint64_t await(Cursor& cursor, uint64_t position, std::atomic<uint32_t> const& closed, std::chrono::milliseconds timeout)
+{
+	const uint32_t wake = cursor.wake.load(std::memory_order_seq_cst);
+	cursor.waiting.store(1, std::memory_order_seq_cst);
+	uint64_t current = cursor.position.load(std::memory_order_seq_cst);
+	if (current == position && closed.load(std::memory_order_seq_cst) == 0)
+	{
+		futex_wait(cursor.wake, wake, timeout);
+		current = cursor.position.load(std::memory_order_acquire);
+	}
+	cursor.waiting.store(0, std::memory_order_relaxed);
+	return current;
+}
+}	 // namespace
+
+SharedMemoryRing::SharedMemoryRing(Segment* segment, int fd, std::string name, bool owner)
+	: segment(segment), fd(fd), name(std::move(name)), linked(owner), send_index(owner ? 0 : 1)
+{
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+	unlink();
+	munmap(segment, SEGMENT_SIZE);
+	::close(fd);
+}
+
+bool SharedMemoryRing::is_supported()
+{
+	return true;
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::create()
+{
+	const uint64_t id = (static_cast<uint64_t>(getpid()) << 32) | next_segment.fetch_add(1);
+	std::string name = segment_name(id);
+	const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd == -1)
+	{
+		return nullptr;
+	}
+	void* memory = MAP_FAILED;
+	if (ftruncate(fd, static_cast<off_t>(SEGMENT_SIZE)) == 0)
+	{
+		memory = mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (memory == MAP_FAILED)
+	{
+		shm_unlink(name.c_str());
+		::close(fd);
+		return nullptr;
+	}
+
+	// a fresh segment is zeroed, the header is only published to the counterpart by its id
+	Segment* segment = new (memory) Segment();
+	segment->magic = SEGMENT_MAGIC;
+	segment->version = SEGMENT_VERSION;
+	segment->id = id;
+	segment->capacity = CAPACITY;
+	return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(segment, fd, std::move(name), true));
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::open(uint64_t segment_id)
+{
+	std::string name = segment_name(segment_id);
+	const int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd == -1)
+	{
+		return nullptr;
+	}
+	struct stat info{};
+	void* memory = MAP_FAILED;
+	if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == SEGMENT_SIZE)
+	{
+		memory = mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (memory == MAP_FAILED)
+	{
+		::close(fd);
+		return nullptr;
+	}
+
+	Segment* segment = static_cast<Segment*>(memory);
+	if (segment->magic != SEGMENT_MAGIC || segment->version != SEGMENT_VERSION || segment->id != segment_id ||
+		segment->capacity != CAPACITY)
+	{
+		munmap(memory, SEGMENT_SIZE);
+		::close(fd);
+		return nullptr;
+	}
+	return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(segment, fd, std::move(name), false));
+}
+
+void SharedMemoryRing::unlink()
+{
+	if (linked)
+	{
+		shm_unlink(name.c_str());
+		linked = false;
+	}
+}
+
+int32_t SharedMemoryRing::send(void const* data, size_t size, std::chrono::milliseconds timeout)
+{
+	Ring& ring = segment->rings[send_index];
+	const uint64_t head = ring.written.position.load(std::memory_order_relaxed);
+	uint64_t tail = ring.read.position.load(std::memory_order_acquire);
+	if (segment->closed.load(std::memory_order_acquire) != 0)
+	{
+		return -1;
+	}
+	if (head - tail == CAPACITY)
+	{
+		tail = await(ring.read, tail, segment->closed, timeout);
+		if (segment->closed.load(std::memory_order_acquire) != 0)
+		{
+			return -1;
+		}
+		if (head - tail == CAPACITY)
+		{
+			return 0;
+		}
+	}
+
+	const size_t count = (std::min)(size, static_cast<size_t>(CAPACITY - (head - tail)));
+	const size_t offset = static_cast<size_t>(head % CAPACITY);
+	const size_t first = (std::min)(count, CAPACITY - offset);
+	uint8_t* buffer = segment->data(send_index);
+	std::memcpy(buffer + offset, data, first);
+	std::memcpy(buffer, static_cast<uint8_t const*>(data) + first, count - first);
+	advance(ring.written, head + count);
+	return static_cast<int32_t>(count);
+}
+
+int32_t SharedMemoryRing::receive(void* data, size_t size, std::chrono::milliseconds timeout)
+{
+	const size_t receive_index = 1 - send_index;
+	Ring& ring = segment->rings[receive_index];
+	const uint64_t tail = ring.read.position.load(std::memory_order_relaxed);
+	uint64_t head = ring.written.position.load(std::memory_order_acquire);
+	if (head == tail)
+	{
+		head = await(ring.written, tail, segment->closed, timeout);
+		if (head == tail)
+		{
+			return segment->closed.load(std::memory_order_acquire) != 0 ? -1 : 0;
+		}
+	}
+
+	const size_t count = (std::min)(size, static_cast<size_t>(head - tail));
+	const size_t offset = static_cast<size_t>(tail % CAPACITY);
+	const size_t first = (std::min)(count, CAPACITY - offset);
+	uint8_t const* buffer = segment->data(receive_index);
+	std::memcpy(data, buffer + offset, first);
+	std::memcpy(static_cast<uint8_t*>(data) + first, buffer, count - first);
+	advance(ring.read, tail + count);
+	return static_cast<int32_t>(count);
+}
+
+void SharedMemoryRing::acknowledge(uint64_t value)
+{
+	Ring& ring = segment->rings[1 - send_index];
+	if (value <= ring.acknowledged.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	ring.acknowledged.store(value, std::memory_order_seq_cst);
+	// the counterpart's receiver waits for the bytes this end writes
+	nudge(segment->rings[send_index].written);
+}
+
+uint64_t SharedMemoryRing::get_acknowledged() const
+{
+	return segment->rings[send_index].acknowledged.load(std::memory_order_acquire);
+}
+
+void SharedMemoryRing::close()
+{
+	segment->closed.store(1, std::memory_order_seq_cst);
+	for (Ring& ring : segment->rings)
+	{
+		for (Cursor* cursor : {&ring.written, &ring.read})
+		{
+			cursor->wake.fetch_add(1, std::memory_order_seq_cst);
+			futex_wake(cursor->wake);
+		}
+	}
+}
+
+#else
+
+// No futexes, the counterpart is never offered the shared memory transport.
+
+SharedMemoryRing::SharedMemoryRing(Segment* segment, int fd, std::string name, bool owner)
+	: segment(segment), fd(fd), name(std::move(name)), linked(false), send_index(0)
+{
+}
+
+SharedMemoryRing::~SharedMemoryRing() = default;
+
+bool SharedMemoryRing::is_supported()
+{
+	return false;
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::create()
+{
+	return nullptr;
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::open(uint64_t)
+{
+	return nullptr;
+}
+
+void SharedMemoryRing::unlink()
+{
+}
+
+int32_t SharedMemoryRing::send(void const*, size_t, std::chrono::milliseconds)
+{
+	return -1;
+}
+
+int32_t SharedMemoryRing::receive(void*, size_t, std::chrono::milliseconds)
+{
+	return -1;
+}
+
+void SharedMemoryRing::acknowledge(uint64_t)
+{
+}
+
+uint64_t SharedMemoryRing::get_acknowledged() const
+{
+	return 0;
+}
+
+void SharedMemoryRing::close()
+{
+}
+
+#endif
+
+uint64_t SharedMemoryRing::get_segment_id() const
+{
+	return segment->id;
+}
+
+bool SharedMemoryRing::is_closed() const
+{
+	return segment->closed.load(std::memory_order_acquire) != 0;
+}
+}	 // namespace rd
@@ -0,0 +1,117 @@
+#ifndef RD_CPP_SHAREDMEMORYRING_H
+#define RD_CPP_SHAREDMEMORYRING_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Pair of single producer, single consumer byte rings in a shared memory segment, one for each direction of a
+ * connection between two processes on the same host. The bytes are a stream like those of a socket, the package framing
+ * is up to the user. A side waiting for bytes or space sleeps on a futex in the segment, so idle rings cost no CPU time,
+ * and a side which sees the counterpart waiting wakes it.
+ *
+ * One end creates the segment with [create] and the other one maps it with [open], the segment is named after its id.
+ * Only supported on Linux, see [is_supported].
+ */
+class RD_FRAMEWORK_API SharedMemoryRing
+{
+public:
+	/**
+	 * \brief Bytes of each direction.
+	 */
+	static constexpr size_t CAPACITY = size_t{1} << 20;
+
+	struct Segment;
+
+private:
+	Segment* segment;
+	int fd;
+	std::string name;
+	// whether this end created the segment and its name is still there
+	bool linked;
+	// index of the ring this end writes to, the other one is read
+	size_t send_index;
+
+	SharedMemoryRing(Segment* segment, int fd, std::string name, bool owner);
+
+public:
+	// region ctor/dtor
+
+	SharedMemoryRing(SharedMemoryRing const&) = delete;
+
+	SharedMemoryRing& operator=(SharedMemoryRing const&) = delete;
+
+	~SharedMemoryRing();
+	// endregion
+
+	static bool is_supported();
+
+	/**
+	 * \brief Creates a new segment with an id unique on this host, or returns nullptr if that fails.
+	 */
+	static std::unique_ptr<SharedMemoryRing> create();
+
+	/**
+	 * \brief Maps the segment the counterpart created with [segment_id], or returns nullptr if there is none or it
+	 * isn't a segment of this version.
+	 */
+	static std::unique_ptr<SharedMemoryRing> open(uint64_t segment_id);
+
+	uint64_t get_segment_id() const;
+
+	/**
+	 * \brief Removes the name of the segment, to be called by the creator once the counterpart has mapped it. Done
+	 * on destruction otherwise.
+	 */
+	void unlink();
+
+	/**
+	 * \brief Writes as much of [data] as fits, waiting at most [timeout] for space if none is free.
+	 * \return bytes written, 0 if the wait timed out, -1 once [close] was called by either end.
+	 */
+	int32_t send(void const* data, size_t size, std::chrono::milliseconds timeout);
+
+	/**
+	 * \brief Reads at most [size] bytes, waiting at most [timeout] if there are none. Bytes written before [close]
+	 * are still read.
+	 * \return bytes read, 0 if the wait timed out, -1 once [close] was called by either end and nothing is left.
+	 */
+	int32_t receive(void* data, size_t size, std::chrono::milliseconds timeout);
+
+	/**
+	 * \brief Publishes [value] to the counterpart's [get_acknowledged] beside the bytes it sends, and wakes the
+	 * counterpart if it waits for bytes from this end. Never waits for space, so the reading end can confirm what it
+	 * read while both rings are full. Values only grow, smaller ones are ignored.
+	 */
+	void acknowledge(uint64_t value);
+
+	/**
+	 * \brief Latest value the counterpart passed to [acknowledge].
+	 */
+	uint64_t get_acknowledged() const;
+
+	/**
+	 * \brief Ends both directions for both ends and wakes whoever waits.
+	 */
+	void close();
+
+	bool is_closed() const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_SHAREDMEMORYRING_H
@@ -2,7 +2,7 @@
 
 #include <util/thread_util.h>
 
-#include "spdlog/sinks/stdout_color_sinks.h"
+#include "util/logging.h"
 
 #include <SimpleSocket.h>
 #include <ActiveSocket.h>
@@ -11,17 +11,48 @@
 #include <utility>
 #include <thread>
 #include <csignal>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
 
 namespace rd
 {
-std::shared_ptr<spdlog::logger> SocketWire::Base::logger =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("wireLog", spdlog::color_mode::automatic);
+std::shared_ptr<spdlog::logger> SocketWire::Base::logger = util::create_logger("wireLog");
 
 std::chrono::milliseconds SocketWire::timeout = std::chrono::milliseconds(500);
 
 constexpr int32_t SocketWire::Base::ACK_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PING_MESSAGE_LENGTH;
+constexpr int32_t SocketWire::Base::ENCODING_MESSAGE_LENGTH;
+constexpr RdId::hash_t SocketWire::Base::ENCODING_MARKER_ID;
+constexpr int32_t SocketWire::Base::CAPABILITIES_MESSAGE_LENGTH;
+constexpr RdId::hash_t SocketWire::Base::BATCH_ID;
+constexpr int32_t SocketWire::Base::SHARED_MEMORY_MESSAGE_LENGTH;
+constexpr std::chrono::milliseconds SocketWire::Base::SHARED_MEMORY_POLL_INTERVAL;
 constexpr int32_t SocketWire::Base::PACKAGE_HEADER_LENGTH;
+constexpr int32_t SocketWire::Base::DIRECT_RECEIVE_THRESHOLD;
+constexpr uint32_t SocketWire::Base::SOCKET_WINDOW_SIZE;
+constexpr uint64_t SocketWire::Base::TRACE_SAMPLE_PERIOD;
+
+/**
+ * \brief Whether a counter going from [before] to [after] passed a multiple of [period].
+ */
+static bool is_trace_sample(uint64_t before, uint64_t after, uint64_t period)
+{
+	return before / period != after / period;
+}
+
+#ifndef _WIN32
+#ifdef IOV_MAX
+static constexpr size_t MAX_SEND_IOV = IOV_MAX;
+#else
+static constexpr size_t MAX_SEND_IOV = 1024;
+#endif
+#endif
 
 SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler)
 	: WireBase(scheduler), id(std::move(id)), scheduler(scheduler), lifetimeDef(parentLifetime)
@@ -68,30 +99,92 @@ void SocketWire::Base::receiverProc() const
 	}
 }
 
-bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const
+bool SocketWire::Base::send0(ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) const
 {
 	try
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 
-		int32_t msglen = static_cast<int32_t>(msg.size());
+		size_t total_len = 0;
+		for (size_t i = 0; i < batch.size(); ++i)
+		{
+			Buffer::ByteArray& pkg = *batch[i];
+			const int32_t msglen = static_cast<int32_t>(pkg.size()) - PACKAGE_HEADER_LENGTH;
+			const sequence_number_t seqn = first_seqn + static_cast<sequence_number_t>(i);
+			std::memcpy(pkg.data(), &msglen, sizeof(msglen));
+			std::memcpy(pkg.data() + sizeof(msglen), &seqn, sizeof(seqn));
+			total_len += pkg.size();
+		}
 
-		send_package_header.rewind();
-		send_package_header.write_integral(msglen);
-		send_package_header.write_integral(seqn);
+		const auto check_sent = [this](int32_t sent) {
+			RD_ASSERT_THROW_MSG(sent > 0, this->id +
+											  ": failed to send packages over the network"
+											  ", reason: " +
+											  socket_provider->DescribeError());
+		};
 
-		RD_ASSERT_THROW_MSG(
-			socket_provider->Send(send_package_header.data(), send_package_header.get_position()) == PACKAGE_HEADER_LENGTH,
-			this->id +
-				": failed to send header over the network"
-				", reason: " +
-				socket_provider->DescribeError())
+		if (send_ring != nullptr)
+		{
+			for (Buffer::ByteArray const* pkg : batch)
+			{
+				RD_ASSERT_THROW_MSG(send_bytes(pkg->data(), pkg->size()) == static_cast<int32_t>(pkg->size()),
+					this->id + ": failed to send packages through shared memory, the connection is gone");
+			}
+		}
+		else
+		{
+			// Sockets may accept less than asked for, the rest is sent until the whole batch is out.
+#ifdef _WIN32
+			send_coalesced.clear();
+			for (Buffer::ByteArray const* pkg : batch)
+			{
+				send_coalesced.insert(send_coalesced.end(), pkg->begin(), pkg->end());
+			}
+			size_t offset = 0;
+			while (offset < send_coalesced.size())
+			{
+				const int32_t sent = socket_provider->Send(send_coalesced.data() + offset, send_coalesced.size() - offset);
+				check_sent(sent);
+				offset += static_cast<size_t>(sent);
+			}
+#else
+			std::vector<iovec> send_vector(batch.size());
+			for (size_t i = 0; i < batch.size(); ++i)
+			{
+				send_vector[i].iov_base = batch[i]->data();
+				send_vector[i].iov_len = batch[i]->size();
+			}
+			// writev takes at most IOV_MAX buffers, and a short write leaves the first unfinished one partially sent.
+			iovec* pending = send_vector.data();
+			size_t pending_count = send_vector.size();
+			while (pending_count > 0)
+			{
+				const size_t count = (std::min)(pending_count, MAX_SEND_IOV);
+				const int32_t sent = socket_provider->Send(pending, static_cast<int32_t>(count));
+				check_sent(sent);
+				size_t remaining = static_cast<size_t>(sent);
+				while (pending_count > 0 && remaining >= pending->iov_len)
+				{
+					remaining -= pending->iov_len;
+					++pending;
+					--pending_count;
+				}
+				if (remaining > 0)
+				{
+					pending->iov_base = static_cast<uint8_t*>(pending->iov_base) + remaining;
+					pending->iov_len -= remaining;
+				}
+			}
+#endif
+		}
 
-		RD_ASSERT_THROW_MSG(socket_provider->Send(msg.data(), msglen) == msglen, this->id +
-																					 ": failed to send package over the network"
-																					 ", reason: " +
-																					 socket_provider->DescribeError());
-		logger->info("{}: were sent {} bytes", this->id, msglen);
+		const uint64_t packages_before = sent_packages.fetch_add(batch.size(), std::memory_order_relaxed);
+		sent_bytes.fetch_add(total_len, std::memory_order_relaxed);
+		if (util::should_log(*logger, spdlog::level::trace) &&
+			is_trace_sample(packages_before, packages_before + batch.size(), TRACE_SAMPLE_PERIOD))
+		{
+			SPDLOG_LOGGER_TRACE(logger, "{}: were sent {} packages, {} bytes", this->id, batch.size(), total_len);
+		}
 		//        RD_ASSERT_MSG(socketProvider->Flush(), "{}: failed to flush");
 		return true;
 	}
@@ -105,20 +198,157 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 
 void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
 {
+	send_encoded(rd_id, get_encoding(), std::move(writer));
+}
+
+void SocketWire::Base::send_encoded(RdId const& rd_id, Buffer::Encoding message_encoding, std::function<void(Buffer& buffer)> writer) const
+{
+	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
+
+	Buffer::ByteArray package = write_package(rd_id, message_encoding, writer);
+
+	std::lock_guard<decltype(wire_send_lock)> guard(wire_send_lock);
+	flush_batch_locked();
+	put_package(std::move(package), message_encoding);
+}
+
+void SocketWire::Base::send_batched(RdId const& rd_id, Buffer::ByteArray key, std::function<void(Buffer& buffer)> writer) const
+{
+	if (!has_capability(Capability::CollectionBatches))
+	{
+		send(rd_id, std::move(writer));
+		return;
+	}
 	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
 
-	Buffer local_send_buffer;
-	local_send_buffer.write_integral<int32_t>(0);	 // placeholder for length
-	rd_id.write(local_send_buffer);					 // write id
-	local_send_buffer.write_integral<int16_t>(0);	 // placeholder for context
-	writer(local_send_buffer);						 // write rest
+	const Buffer::Encoding message_encoding = get_encoding();
+	Buffer message;
+	message.set_encoding(message_encoding);
+	writer(message);
+
+	bool queue_flush = false;
+	{
+		std::lock_guard<decltype(wire_send_lock)> guard(wire_send_lock);
+		if (batch.id != rd_id || batch.encoding != message_encoding)
+		{
+			flush_batch_locked();
+			batch.id = rd_id;
+			batch.encoding = message_encoding;
+		}
+
+		Buffer::ByteArray bytes = std::move(message).getRealArray();
+		if (key.empty())
+		{
+			batch.messages.push_back(std::move(bytes));
+		}
+		else
+		{
+			const auto it = batch.keys.emplace(std::move(key), batch.messages.size());
+			if (it.second)
+			{
+				batch.messages.push_back(std::move(bytes));
+			}
+			else
+			{
+				// supersedes the held message with the same key
+				batch.messages[it.first->second] = std::move(bytes);
+			}
+		}
+		queue_flush = !batch.flush_queued;
+		batch.flush_queued = true;
+	}
+	if (queue_flush)
+	{
+		// the scheduler may run it right away, so it's queued outside of the lock
+		scheduler->queue([this, lifetime = lifetimeDef.lifetime] {
+			if (!lifetime->is_terminated())
+			{
+				flush_batch();
+			}
+		});
+	}
+}
+
+Buffer::ByteArray SocketWire::Base::write_package(
+	RdId const& rd_id, Buffer::Encoding package_encoding, std::function<void(Buffer& buffer)> const& writer) const
+{
+	Buffer local_send_buffer{async_send_buffer.acquire()};
+	local_send_buffer.set_encoding(package_encoding);
+	local_send_buffer.write_integral<int32_t>(0);				   // placeholder for package length
+	local_send_buffer.write_integral<sequence_number_t>(0);	   // placeholder for seqn
+	local_send_buffer.write_integral<int32_t>(0);				   // placeholder for length
+	rd_id.write(local_send_buffer);							   // write id
+	local_send_buffer.write_integral<int16_t>(0);				   // placeholder for context
+	writer(local_send_buffer);								   // write rest
 
 	int32_t len = static_cast<int32_t>(local_send_buffer.get_position());
 
-	local_send_buffer.rewind();
-	local_send_buffer.write_integral<int32_t>(len - 4);
+	local_send_buffer.set_position(PACKAGE_HEADER_LENGTH);
+	local_send_buffer.write_integral<int32_t>(len - PACKAGE_HEADER_LENGTH - 4);
 	local_send_buffer.set_position(len);
-	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
+	return std::move(local_send_buffer).getRealArray();
+}
+
+void SocketWire::Base::put_package(Buffer::ByteArray package, Buffer::Encoding package_encoding) const
+{
+	if (package_encoding != framed_encoding)
+	{
+		// the counterpart switches its decoding at this message, packages queued before it keep the old encoding
+		async_send_buffer.put(write_package(RdId(ENCODING_MARKER_ID), Buffer::Encoding::Fixed, [package_encoding](Buffer& buffer) {
+			buffer.write_integral<uint8_t>(static_cast<uint8_t>(package_encoding));
+		}));
+		framed_encoding = package_encoding;
+	}
+	async_send_buffer.put(std::move(package));
+}
+
+void SocketWire::Base::flush_batch_locked() const
+{
+	batch.flush_queued = false;
+	if (batch.messages.empty())
+	{
+		return;
+	}
+
+	Buffer::ByteArray package;
+	if (batch.messages.size() == 1)
+	{
+		package = write_package(batch.id, batch.encoding, [this](Buffer& buffer) { buffer.write_byte_array_raw(batch.messages.front()); });
+	}
+	else
+	{
+		package = write_package(RdId(BATCH_ID), batch.encoding, [this](Buffer& buffer) {
+			batch.id.write(buffer);
+			buffer.write_integral<int32_t>(static_cast<int32_t>(batch.messages.size()));
+			for (Buffer::ByteArray const& message : batch.messages)
+			{
+				buffer.write_integral<int32_t>(static_cast<int32_t>(message.size()));
+				buffer.write_byte_array_raw(message);
+			}
+		});
+	}
+	put_package(std::move(package), batch.encoding);
+
+	batch.id = RdId::Null();
+	batch.messages.clear();
+	batch.keys.clear();
+}
+
+void SocketWire::Base::flush_batch() const
+{
+	std::lock_guard<decltype(wire_send_lock)> guard(wire_send_lock);
+	flush_batch_locked();
+}
+
+size_t SocketWire::Base::KeyHash::operator()(Buffer::ByteArray const& key) const
+{
+	// FNV-1a, keys are a few serialized bytes
+	uint64_t hash = 14695981039346656037ull;
+	for (const Buffer::word_t byte : key)
+	{
+		hash = (hash ^ byte) * 1099511628211ull;
+	}
+	return static_cast<size_t>(hash);
 }
 
 void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_socket)
@@ -139,13 +369,17 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	auto heartbeat = LifetimeDefinition::use([this](Lifetime heartbeatLifetime) {
 		const auto heartbeat = start_heartbeat(heartbeatLifetime).share();
 
+		send_encoding_offer();
+		send_capabilities_offer();
 		async_send_buffer.resume();
 
+		connections.fetch_add(1, std::memory_order_relaxed);
 		connected.set(true);
 
 		receiverProc();
 
 		connected.set(false);
+		reset_shared_memory();
 
 		async_send_buffer.pause("Disconnected");
 
@@ -166,6 +400,313 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	}
 }
 
+void SocketWire::Base::set_socket_windows(CSimpleSocket& target) const
+{
+	target.SetSendWindowSize(SOCKET_WINDOW_SIZE);
+	target.SetReceiveWindowSize(SOCKET_WINDOW_SIZE);
+	logger->debug("{}: socket windows: send={}, receive={}", this->id, target.GetSendWindowSize(), target.GetReceiveWindowSize());
+}
+
+Buffer::Encoding SocketWire::Base::get_encoding() const
+{
+	return encoding.load(std::memory_order_relaxed);
+}
+
+void SocketWire::Base::set_offered_encoding(Buffer::Encoding value)
+{
+	offered_encoding.store(value);
+	if (connected.get())
+	{
+		send_encoding_offer();
+	}
+}
+
+bool SocketWire::Base::send_encoding_offer() const
+{
+	const Buffer::Encoding offer = offered_encoding.load();
+	if (offer == Buffer::Encoding::Fixed)
+	{
+		// every counterpart reads the fixed encoding, and older ones don't know the offer package
+		return true;
+	}
+	return send_offer(encoding_offer_buffer, ENCODING_MESSAGE_LENGTH, static_cast<sequence_number_t>(offer), "encoding");
+}
+
+bool SocketWire::Base::send_offer(Buffer& buffer, int32_t length, sequence_number_t value, char const* what) const
+{
+	try
+	{
+		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+		buffer.rewind();
+		buffer.write_integral(length);
+		buffer.write_integral(value);
+		RD_ASSERT_THROW_MSG(send_bytes(buffer.data(), buffer.get_position()) == PACKAGE_HEADER_LENGTH,
+			this->id + ": failed to send " + what +
+				" offer over the network"
+				", reason: " +
+				socket_provider->DescribeError())
+		return true;
+	}
+	catch (std::exception const& e)
+	{
+		logger->warn("{}: exception raised during {} offer | {}", id, what, e.what());
+		return false;
+	}
+}
+
+void SocketWire::Base::on_encoding_offered(sequence_number_t value) const
+{
+	const Buffer::Encoding offer = offered_encoding.load();
+	const Buffer::Encoding agreed = value == static_cast<sequence_number_t>(offer) ? offer : Buffer::Encoding::Fixed;
+	logger->debug("{}: counterpart offered encoding {}, using {}", this->id, value, static_cast<uint32_t>(agreed));
+	// a counterpart which made its offer later than this side hasn't seen the offer yet, it gets it once more
+	if (encoding.exchange(agreed, std::memory_order_relaxed) != agreed && agreed != Buffer::Encoding::Fixed)
+	{
+		send_encoding_offer();
+	}
+}
+
+bool SocketWire::Base::has_capability(Capability capability) const
+{
+	return (capabilities.load(std::memory_order_relaxed) & static_cast<uint32_t>(capability)) != 0;
+}
+
+void SocketWire::Base::set_offered_capabilities(uint32_t value)
+{
+	if (!SharedMemoryRing::is_supported())
+	{
+		value &= ~static_cast<uint32_t>(Capability::SharedMemory);
+	}
+	offered_capabilities.store(value);
+	if (connected.get())
+	{
+		send_capabilities_offer();
+	}
+}
+
+bool SocketWire::Base::send_capabilities_offer() const
+{
+	const uint32_t offer = offered_capabilities.load();
+	if (offer == 0)
+	{
+		// older counterparts don't know the offer package
+		return true;
+	}
+	return send_offer(capabilities_offer_buffer, CAPABILITIES_MESSAGE_LENGTH, static_cast<sequence_number_t>(offer), "capabilities");
+}
+
+void SocketWire::Base::on_capabilities_offered(sequence_number_t value) const
+{
+	const uint32_t agreed = offered_capabilities.load() & static_cast<uint32_t>(value);
+	logger->debug("{}: counterpart offered capabilities {}, using {}", this->id, value, agreed);
+	// same as with the encoding, a counterpart which made its offer later gets this side's offer once more
+	if (capabilities.exchange(agreed, std::memory_order_relaxed) != agreed && agreed != 0)
+	{
+		send_capabilities_offer();
+	}
+
+	if (creates_shared_memory && (agreed & static_cast<uint32_t>(Capability::SharedMemory)) != 0)
+	{
+		uint64_t segment_id = 0;
+		{
+			std::lock_guard<decltype(shared_memory_lock)> guard(shared_memory_lock);
+			if (shared_memory != nullptr)
+			{
+				// offered on this connection already
+				return;
+			}
+			shared_memory = SharedMemoryRing::create();
+			if (shared_memory == nullptr)
+			{
+				logger->warn("{}: failed to create shared memory, staying on the socket", this->id);
+				return;
+			}
+			segment_id = shared_memory->get_segment_id();
+		}
+		send_offer(shared_memory_offer_buffer, SHARED_MEMORY_MESSAGE_LENGTH, static_cast<sequence_number_t>(segment_id),
+			"shared memory");
+	}
+}
+
+void SocketWire::Base::on_shared_memory_offered(sequence_number_t value) const
+{
+	const uint64_t segment_id = static_cast<uint64_t>(value);
+	std::shared_ptr<SharedMemoryRing> ring;
+	{
+		std::lock_guard<decltype(shared_memory_lock)> guard(shared_memory_lock);
+		ring = shared_memory;
+	}
+
+	if (creates_shared_memory)
+	{
+		if (ring == nullptr || segment_id != ring->get_segment_id())
+		{
+			logger->debug("{}: counterpart declined shared memory, staying on the socket", this->id);
+			reset_shared_memory();
+			return;
+		}
+		// the counterpart has mapped the segment and sends through it from now on
+		receive_ring = ring;
+		ring->unlink();
+		if (switch_to_shared_memory(ring))
+		{
+			logger->debug("{}: switched to shared memory", this->id);
+		}
+		return;
+	}
+
+	if (ring != nullptr)
+	{
+		if (segment_id == ring->get_segment_id())
+		{
+			// the reply to the acceptance, the counterpart sends through the ring from now on
+			receive_ring = ring;
+			logger->debug("{}: switched to shared memory", this->id);
+		}
+		return;
+	}
+
+	if ((offered_capabilities.load() & static_cast<uint32_t>(Capability::SharedMemory)) != 0)
+	{
+		ring = SharedMemoryRing::open(segment_id);
+	}
+	if (ring == nullptr)
+	{
+		logger->debug("{}: can't map shared memory {}, staying on the socket", this->id, segment_id);
+		send_offer(shared_memory_offer_buffer, SHARED_MEMORY_MESSAGE_LENGTH, 0, "shared memory");
+		return;
+	}
+	{
+		std::lock_guard<decltype(shared_memory_lock)> guard(shared_memory_lock);
+		shared_memory = ring;
+	}
+	switch_to_shared_memory(ring);
+}
+
+bool SocketWire::Base::switch_to_shared_memory(std::shared_ptr<SharedMemoryRing> const& ring) const
+{
+	std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+	shared_memory_offer_buffer.rewind();
+	shared_memory_offer_buffer.write_integral(SHARED_MEMORY_MESSAGE_LENGTH);
+	shared_memory_offer_buffer.write_integral(static_cast<sequence_number_t>(ring->get_segment_id()));
+	// the last bytes through the socket, nothing is sent in between
+	if (socket_provider->Send(shared_memory_offer_buffer.data(), shared_memory_offer_buffer.get_position()) != PACKAGE_HEADER_LENGTH)
+	{
+		logger->warn("{}: failed to switch to shared memory, reason: {}", this->id, socket_provider->DescribeError());
+		return false;
+	}
+	send_ring = ring;
+	return true;
+}
+
+void SocketWire::Base::close_shared_memory() const
+{
+	std::lock_guard<decltype(shared_memory_lock)> guard(shared_memory_lock);
+	if (shared_memory != nullptr)
+	{
+		shared_memory->close();
+	}
+}
+
+void SocketWire::Base::reset_shared_memory() const
+{
+	// a sender waiting for space in the ring holds the send lock, closing the ring first lets it go
+	close_shared_memory();
+	{
+		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+		send_ring.reset();
+	}
+	receive_ring.reset();
+	shared_memory_acknowledged = 0;
+	std::lock_guard<decltype(shared_memory_lock)> guard(shared_memory_lock);
+	shared_memory.reset();
+}
+
+bool SocketWire::Base::is_shared_memory_used() const
+{
+	std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+	return send_ring != nullptr;
+}
+
+int32_t SocketWire::Base::send_bytes(void const* data, size_t size) const
+{
+	if (send_ring == nullptr)
+	{
+		return socket_provider->Send(static_cast<uint8_t const*>(data), size);
+	}
+	size_t sent = 0;
+	while (sent < size)
+	{
+		const int32_t written = send_ring->send(static_cast<uint8_t const*>(data) + sent, size - sent, SHARED_MEMORY_POLL_INTERVAL);
+		if (written < 0 || (written == 0 && !is_counterpart_connected()))
+		{
+			break;
+		}
+		sent += static_cast<size_t>(written);
+	}
+	return static_cast<int32_t>(sent);
+}
+
+int32_t SocketWire::Base::receive_bytes(void* data, size_t size) const
+{
+	if (receive_ring == nullptr)
+	{
+		return socket_provider->Receive(static_cast<int32_t>(size), static_cast<uint8_t*>(data));
+	}
+	while (true)
+	{
+		const int32_t read = receive_ring->receive(data, size, SHARED_MEMORY_POLL_INTERVAL);
+		const uint64_t acknowledged = receive_ring->get_acknowledged();
+		if (acknowledged > shared_memory_acknowledged)
+		{
+			shared_memory_acknowledged = acknowledged;
+			async_send_buffer.acknowledge(static_cast<sequence_number_t>(acknowledged));
+		}
+		if (read > 0)
+		{
+			return read;
+		}
+		if (read < 0 || !is_counterpart_connected())
+		{
+			return 0;
+		}
+	}
+}
+
+bool SocketWire::Base::is_counterpart_connected() const
+{
+	if (!socket_provider->IsSocketValid())
+	{
+		return false;
+	}
+#ifdef _WIN32
+	return true;
+#else
+	pollfd descriptor{};
+	descriptor.fd = socket_provider->GetSocketDescriptor();
+	descriptor.events = POLLIN;
+	return poll(&descriptor, 1, 0) == 0;
+#endif
+}
+
+IWire::Stats SocketWire::Base::get_stats() const
+{
+	const ByteBufferAsyncProcessor::Stats send_stats = async_send_buffer.get_stats();
+
+	Stats result;
+	result.sent_packages = sent_packages.load(std::memory_order_relaxed);
+	result.sent_bytes = sent_bytes.load(std::memory_order_relaxed);
+	result.received_packages = received_packages.load(std::memory_order_relaxed);
+	result.received_bytes = received_bytes.load(std::memory_order_relaxed);
+	result.received_messages = received_messages.load(std::memory_order_relaxed);
+	result.queue_depth = send_stats.queue_depth;
+	result.acknowledged_batches = send_stats.acknowledged_batches;
+	result.total_ack_latency = send_stats.total_ack_latency;
+	result.max_ack_latency = send_stats.max_ack_latency;
+	result.connections = connections.load(std::memory_order_relaxed);
+	return result;
+}
+
 bool SocketWire::Base::connection_established(int32_t timestamp, int32_t notion_timestamp)
 {
 	return timestamp - notion_timestamp <= MaximumHeartbeatDelay;
@@ -201,12 +742,13 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 		}
 		else
 		{
-			if (hi == receiver_buffer.end())
-			{
-				hi = lo = receiver_buffer.begin();
-			}
-			logger->info("{}: receive started", this->id);
-			int32_t read = socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
+			// Nothing is buffered, so the next receive can use the whole buffer.
+			hi = lo = receiver_buffer.begin();
+
+			// Large packages skip the receive buffer, nothing past them is consumed from the socket.
+			const bool direct = rest >= DIRECT_RECEIVE_THRESHOLD;
+			SPDLOG_LOGGER_TRACE(logger, "{}: receive started", this->id);
+			int32_t read = direct ? receive_bytes(res + ptr, static_cast<size_t>(rest)) : receive_bytes(&*hi, receiver_buffer.size());
 			if (read == -1)
 			{
 				auto err = socket_provider->GetSocketError();
@@ -223,11 +765,15 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 				logger->info("{}: socket was shut down for receiving", this->id);
 				return false;
 			}
-			hi += read;
-			if (read > 0)
+			if (direct)
+			{
+				ptr += read;
+			}
+			else
 			{
-				logger->info("{}: receive finished: {} bytes read", this->id, read);
+				hi += read;
 			}
+			SPDLOG_LOGGER_TRACE(logger, "{}: receive finished: {} bytes read", this->id, read);
 		}
 	}
 	if (ptr != msglen)
@@ -294,6 +840,21 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 			async_send_buffer.acknowledge(seqn);
 			continue;
 		}
+		if (len == ENCODING_MESSAGE_LENGTH)
+		{
+			on_encoding_offered(seqn);
+			continue;
+		}
+		if (len == CAPABILITIES_MESSAGE_LENGTH)
+		{
+			on_capabilities_offered(seqn);
+			continue;
+		}
+		if (len == SHARED_MEMORY_MESSAGE_LENGTH)
+		{
+			on_shared_memory_offered(seqn);
+			continue;
+		}
 		return std::make_pair(len, seqn);
 	}
 }
@@ -311,7 +872,7 @@ int32_t SocketWire::Base::read_package() const
 	const auto len = pair.first;
 	const auto seqn = pair.second;
 
-	logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+	SPDLOG_LOGGER_TRACE(logger, "{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
 
 	receive_pkg.require_available(len);
 	if (!read_data_from_socket(receive_pkg.data(), len))
@@ -320,13 +881,18 @@ int32_t SocketWire::Base::read_package() const
 		return -1;
 	}
 	send_ack(seqn);
+	const uint64_t packages_before = received_packages.fetch_add(1, std::memory_order_relaxed);
+	received_bytes.fetch_add(static_cast<uint64_t>(len) + PACKAGE_HEADER_LENGTH, std::memory_order_relaxed);
 	if (seqn <= max_received_seqn && seqn != 1)
 	{
 		return true;
 	}
 	max_received_seqn = seqn;
 
-	logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+	if (util::should_log(*logger, spdlog::level::trace) && is_trace_sample(packages_before, packages_before + 1, TRACE_SAMPLE_PERIOD))
+	{
+		SPDLOG_LOGGER_TRACE(logger, "{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+	}
 	return len;
 }
 
@@ -344,20 +910,38 @@ bool SocketWire::Base::read_and_dispatch_message() const
 		logger->error("id == -1");
 		return false;
 	}
-	logger->trace("{}: message info: sz={}, id={}", this->id, sz, id_);
+	SPDLOG_LOGGER_TRACE(logger, "{}: message info: sz={}, id={}", this->id, sz, id_);
 	const RdId rd_id{id_};
 	sz -= 8;	// RdId
-	message.require_available(sz);
 
-	if (!receive_pkg.read(message.data() + message.get_position(), sz - message.get_position()))
+	// A message filling the rest of its package is handed over with the package storage, other ones are assembled.
+	if (!receive_pkg.try_take_rest(sz, message))
 	{
-		logger->error("{}: constructing message failed", this->id);
-		return false;
+		message.require_available(sz);
+
+		if (!receive_pkg.read(message.data() + message.get_position(), sz - message.get_position()))
+		{
+			logger->error("{}: constructing message failed", this->id);
+			return false;
+		}
 	}
 
-	logger->debug("{}: message received", this->id);
-	message_broker.dispatch(rd_id, std::move(message));
-	logger->debug("{}: message dispatched", this->id);
+	if (id_ == ENCODING_MARKER_ID)
+	{
+		message.read_integral<int16_t>();	 // context
+		received_encoding = static_cast<Buffer::Encoding>(message.read_integral<uint8_t>());
+		logger->debug("{}: counterpart switched to encoding {}", this->id, static_cast<uint32_t>(received_encoding));
+	}
+	else if (id_ == BATCH_ID)
+	{
+		dispatch_batch(message, sz);
+	}
+	else
+	{
+		message.set_encoding(received_encoding);
+		received_messages.fetch_add(1, std::memory_order_relaxed);
+		message_broker.dispatch(rd_id, std::move(message), static_cast<size_t>(sz));
+	}
 
 	sz = -1;
 	id_ = -1;
@@ -366,6 +950,32 @@ bool SocketWire::Base::read_and_dispatch_message() const
 	//		RD_ASSERT_MSG(summary_size == sz, "Broken message, read:%d bytes, expected:%d bytes", summary_size, sz)
 }
 
+void SocketWire::Base::dispatch_batch(Buffer& package, int32_t size) const
+{
+	// a message handed over with its package storage doesn't start at the beginning of it
+	const size_t end = package.get_position() + size;
+	package.read_integral<int16_t>();	 // context
+	const RdId rd_id = RdId::read(package);
+	const int32_t count = package.read_integral<int32_t>();
+	for (int32_t i = 0; i < count; ++i)
+	{
+		const int32_t length = package.read_integral<int32_t>();
+		const size_t position = package.get_position();
+		RD_ASSERT_THROW_MSG(length >= 0 && position + length <= end,
+			this->id + ": broken batch for " + to_string(rd_id))
+
+		// messages are dispatched as if they came in a package of their own, context included
+		Buffer::ByteArray bytes(sizeof(int16_t) + length);
+		std::memcpy(bytes.data() + sizeof(int16_t), package.data() + position, length);
+		package.set_position(position + length);
+
+		Buffer message{std::move(bytes)};
+		message.set_encoding(received_encoding);
+		received_messages.fetch_add(1, std::memory_order_relaxed);
+		message_broker.dispatch(rd_id, std::move(message), sizeof(int16_t) + length);
+	}
+}
+
 CSimpleSocket* SocketWire::Base::get_socket_provider() const
 {
 	return socket_provider.get();
@@ -393,7 +1003,7 @@ void SocketWire::Base::ping() const
 		ping_pkg_header.write_integral(counterpart_timestamp);
 		{
 			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
-			int32_t sent = socket_provider->Send(ping_pkg_header.data(), ping_pkg_header.get_position());
+			int32_t sent = send_bytes(ping_pkg_header.data(), ping_pkg_header.get_position());
 			if (sent == 0 && !socket_provider->IsSocketValid())
 			{
 				logger->debug("{}: failed to send ping over the network, reason: socket was shut down for sending", this->id);
@@ -413,7 +1023,13 @@ void SocketWire::Base::ping() const
 
 bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 {
-	logger->trace("{} send ack {}", id, seqn);
+	SPDLOG_LOGGER_TRACE(logger, "{} send ack {}", id, seqn);
+	if (receive_ring != nullptr)
+	{
+		// beside the stream, the ring this end would write to may be full while the counterpart waits for the ack
+		receive_ring->acknowledge(static_cast<uint64_t>(seqn));
+		return true;
+	}
 	try
 	{
 		ack_buffer.rewind();
@@ -421,7 +1037,7 @@ bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 		ack_buffer.write_integral(seqn);
 		{
 			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
-			RD_ASSERT_THROW_MSG(socket_provider->Send(ack_buffer.data(), ack_buffer.get_position()) == PACKAGE_HEADER_LENGTH,
+			RD_ASSERT_THROW_MSG(send_bytes(ack_buffer.data(), ack_buffer.get_position()) == PACKAGE_HEADER_LENGTH,
 				this->id +
 					": failed to send ack over the network"
 					", reason: " +
@@ -438,6 +1054,7 @@ bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 
 bool SocketWire::Base::try_shutdown_connection() const
 {
+	close_shared_memory();
 	auto s = get_socket_provider();
 	if (s == nullptr)
 		return false;
@@ -465,6 +1082,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 						fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, socket->DescribeError()));
 					RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
 						fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, socket->DescribeError()));
+					set_socket_windows(*socket);
 
 					// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
 					// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket any
@@ -521,6 +1139,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
 		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
 
+		close_shared_memory();
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
 			logger->debug("{}: closing socket", this->id);
@@ -556,7 +1175,10 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 #ifdef SIGPIPE
 	signal(SIGPIPE, SIG_IGN);
 #endif
+	creates_shared_memory = true;
 	RD_ASSERT_MSG(ss->Initialize(), fmt::format("{}: failed to initialize socket, reason: {}", this->id, socket->DescribeError()));
+	// accepted sockets inherit the buffers of the listening one
+	set_socket_windows(*ss);
 	RD_ASSERT_MSG(ss->Listen("127.0.0.1", port),
 		fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, std::to_string(port), ss->DescribeError()));
 
@@ -635,6 +1257,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 			logger->error("{}: failed to close server socket", this->id);
 		}
 
+		close_shared_memory();
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
 			logger->debug("{}: closing socket", this->id);
@@ -10,10 +10,14 @@
 #include "base/WireBase.h"
 #include "ByteBufferAsyncProcessor.h"
 #include "PkgInputStream.h"
+#include "SharedMemoryRing.h"
+#include "std/unordered_map.h"
 
 #include <string>
 #include <array>
+#include <atomic>
 #include <condition_variable>
+#include <vector>
 
 #include <rd_framework_export.h>
 
@@ -47,15 +51,56 @@ public:
 
 		mutable std::condition_variable socket_send_var;
 		mutable ByteBufferAsyncProcessor async_send_buffer{id + "-AsyncSendProcessor",
-			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); }};
+			[this](ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) -> bool {
+				return this->send0(batch, first_seqn);
+			}};
+
+		/**
+		 * \brief Kernel buffers of the loopback connection. Both ends are on the same host, so a large window lets
+		 * bulk model syncs go through in a few writes instead of stalling on the default one.
+		 */
+		static constexpr uint32_t SOCKET_WINDOW_SIZE = 1u << 20;
 
 		static constexpr size_t RECEIVE_BUFFER_SIZE = 1u << 16;
+		static constexpr int32_t DIRECT_RECEIVE_THRESHOLD = RECEIVE_BUFFER_SIZE / 4;
 		mutable std::array<Buffer::word_t, RECEIVE_BUFFER_SIZE> receiver_buffer{};
 		mutable decltype(receiver_buffer)::iterator lo = receiver_buffer.begin(), hi = receiver_buffer.begin();
 
 		static constexpr int32_t ACK_MESSAGE_LENGTH = -1;
 		static constexpr int32_t PING_MESSAGE_LENGTH = -2;
+		/**
+		 * \brief Offers the encoding stored in the sequence number field, see [set_offered_encoding].
+		 */
+		static constexpr int32_t ENCODING_MESSAGE_LENGTH = -3;
+		/**
+		 * \brief Reserved id of the in-order message after which the counterpart decodes messages in the encoding it
+		 * carries. Packages queued before the switch keep the encoding they were written in.
+		 */
+		static constexpr RdId::hash_t ENCODING_MARKER_ID = -2;
+		/**
+		 * \brief Offers the [IWire::Capability] flags stored in the sequence number field, see
+		 * [set_offered_capabilities].
+		 */
+		static constexpr int32_t CAPABILITIES_MESSAGE_LENGTH = -4;
+		/**
+		 * \brief Reserved id of a package holding several messages to one entity: the entity id, the number of
+		 * messages and each message prefixed with its length. See [send_batched].
+		 */
+		static constexpr RdId::hash_t BATCH_ID = -3;
+		/**
+		 * \brief Offers, accepts or declines a shared memory segment with the id stored in the sequence number field,
+		 * see [Capability::SharedMemory].
+		 */
+		static constexpr int32_t SHARED_MEMORY_MESSAGE_LENGTH = -5;
+		/**
+		 * \brief How long a wait on a shared memory ring lasts before the socket is checked for the counterpart having
+		 * gone away without closing the ring.
+		 */
+		static constexpr std::chrono::milliseconds SHARED_MEMORY_POLL_INTERVAL{100};
 		static constexpr int32_t PACKAGE_HEADER_LENGTH = sizeof(ACK_MESSAGE_LENGTH) + sizeof(sequence_number_t);
+		mutable Buffer encoding_offer_buffer{PACKAGE_HEADER_LENGTH};
+		mutable Buffer capabilities_offer_buffer{PACKAGE_HEADER_LENGTH};
+		mutable Buffer shared_memory_offer_buffer{PACKAGE_HEADER_LENGTH};
 		mutable Buffer ack_buffer{PACKAGE_HEADER_LENGTH};
 
 		/**
@@ -76,7 +121,13 @@ public:
 		mutable Buffer ping_pkg_header{PACKAGE_HEADER_LENGTH};
 
 		mutable sequence_number_t max_received_seqn = 0;
-		mutable Buffer send_package_header{PACKAGE_HEADER_LENGTH};
+
+#ifdef _WIN32
+		/**
+		 * \brief Batch staging area of [send0], winsock has no writev.
+		 */
+		mutable Buffer::ByteArray send_coalesced;
+#endif
 
 		static constexpr int32_t CHUNK_SIZE = 16370;
 		mutable int32_t sz = -1;
@@ -85,8 +136,98 @@ public:
 
 		mutable Buffer message{CHUNK_SIZE};
 
+		// negotiated encoding of new messages, see [get_encoding]
+		mutable std::atomic<Buffer::Encoding> encoding{Buffer::Encoding::Fixed};
+		std::atomic<Buffer::Encoding> offered_encoding{Buffer::Encoding::Fixed};
+		// encoding the counterpart decodes the next queued message with, guarded by [wire_send_lock]
+		mutable Buffer::Encoding framed_encoding = Buffer::Encoding::Fixed;
+		// only touched by the receiver thread
+		mutable Buffer::Encoding received_encoding = Buffer::Encoding::Fixed;
+
+		// [IWire::Capability] flags offered by this side and agreed with the counterpart, see [has_capability]
+		std::atomic<uint32_t> offered_capabilities{0};
+		mutable std::atomic<uint32_t> capabilities{0};
+
+		struct KeyHash
+		{
+			size_t operator()(Buffer::ByteArray const& key) const;
+		};
+
+		/**
+		 * \brief Messages held back by [send_batched], guarded by [wire_send_lock].
+		 */
+		struct OpenBatch
+		{
+			RdId id = RdId::Null();
+			Buffer::Encoding encoding = Buffer::Encoding::Fixed;
+			std::vector<Buffer::ByteArray> messages;
+			// index in [messages] of the held message with the key
+			rd::unordered_map<Buffer::ByteArray, size_t, KeyHash> keys;
+			bool flush_queued = false;
+		};
+
+		mutable OpenBatch batch;
+
+		/**
+		 * \brief Whether this end creates the shared memory segment once both ends offered [Capability::SharedMemory],
+		 * the server does.
+		 */
+		bool creates_shared_memory = false;
+		/**
+		 * \brief Segment of the current connection, offered or accepted. Guarded by [shared_memory_lock].
+		 */
+		mutable std::shared_ptr<SharedMemoryRing> shared_memory;
+		mutable std::mutex shared_memory_lock;
+		/**
+		 * \brief Ring everything is sent through instead of the socket once this end switched, guarded by
+		 * [socket_send_lock].
+		 */
+		mutable std::shared_ptr<SharedMemoryRing> send_ring;
+		/**
+		 * \brief Ring everything is received from once the counterpart switched, only touched by the receiver thread.
+		 */
+		mutable std::shared_ptr<SharedMemoryRing> receive_ring;
+		/**
+		 * \brief Latest acknowledgment of the counterpart through the ring, see [SharedMemoryRing::acknowledge]. Only
+		 * touched by the receiver thread.
+		 */
+		mutable uint64_t shared_memory_acknowledged = 0;
+
+		// traffic counters, see [get_stats]
+		mutable std::atomic<uint64_t> sent_packages{0};
+		mutable std::atomic<uint64_t> sent_bytes{0};
+		mutable std::atomic<uint64_t> received_packages{0};
+		mutable std::atomic<uint64_t> received_bytes{0};
+		mutable std::atomic<uint64_t> received_messages{0};
+		std::atomic<uint32_t> connections{0};
+
+		/**
+		 * \brief Only every [TRACE_SAMPLE_PERIOD]th package is traced, so trace logging stays usable on busy wires.
+		 */
+		static constexpr uint64_t TRACE_SAMPLE_PERIOD = 64;
+
 		bool read_from_socket(Buffer::word_t* res, int32_t msglen) const;
 
+		/**
+		 * \brief Sends [size] bytes through the socket, or the shared memory ring once this end switched to it. Requires
+		 * [socket_send_lock].
+		 * \return bytes sent, less than [size] if the connection is gone.
+		 */
+		int32_t send_bytes(void const* data, size_t size) const;
+
+		/**
+		 * \brief Receives at most [size] bytes from the socket, or the shared memory ring once the counterpart switched
+		 * to it.
+		 * \return bytes received, 0 once the connection is shut down and -1 on errors, like CSimpleSocket::Receive.
+		 */
+		int32_t receive_bytes(void* data, size_t size) const;
+
+		/**
+		 * \brief Whether the socket is still connected while the shared memory ring is used. Nothing is sent through the
+		 * socket anymore, so it being readable means that the counterpart closed it.
+		 */
+		bool is_counterpart_connected() const;
+
 		template <typename T>
 		bool read_integral_from_socket(T& x) const
 		{
@@ -100,6 +241,53 @@ public:
 
 		void set_socket_provider(std::shared_ptr<CActiveSocket> new_socket);
 
+		/**
+		 * \brief Package of a message to [rd_id], with the header fields left to [send0].
+		 */
+		Buffer::ByteArray write_package(RdId const& rd_id, Buffer::Encoding package_encoding,
+			std::function<void(Buffer& buffer)> const& writer) const;
+
+		/**
+		 * \brief Queues [package] written in [package_encoding], preceded by an encoding marker when the counterpart
+		 * decodes the previous package in another one. Requires [wire_send_lock].
+		 */
+		void put_package(Buffer::ByteArray package, Buffer::Encoding package_encoding) const;
+
+		/**
+		 * \brief Queues the messages held back by [send_batched], a single one as a plain message. Requires
+		 * [wire_send_lock].
+		 */
+		void flush_batch_locked() const;
+
+		void flush_batch() const;
+
+		/**
+		 * \brief Dispatches the messages of a package sent to [BATCH_ID], [size] bytes long.
+		 */
+		void dispatch_batch(Buffer& package, int32_t size) const;
+
+		bool send_offer(Buffer& buffer, int32_t length, sequence_number_t value, char const* what) const;
+
+		/**
+		 * \brief Sends the id of [ring] through the socket and everything after it through [ring].
+		 */
+		bool switch_to_shared_memory(std::shared_ptr<SharedMemoryRing> const& ring) const;
+
+		/**
+		 * \brief Closes the ring of the current connection, which also ends it for the counterpart.
+		 */
+		void close_shared_memory() const;
+
+		/**
+		 * \brief Drops the ring once the connection is over, the next one starts on the socket again.
+		 */
+		void reset_shared_memory() const;
+
+		/**
+		 * \brief Must be called before connecting or listening, the receive window is negotiated on connection.
+		 */
+		void set_socket_windows(CSimpleSocket& target) const;
+
 		CSimpleSocket* get_socket_provider() const;
 
 	public:
@@ -122,10 +310,63 @@ public:
 
 		void receiverProc() const;
 
-		bool send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const;
+		/**
+		 * \brief Sends [batch] with as few socket writes as the platform allows, resuming after short writes. Every
+		 * package starts with [PACKAGE_HEADER_LENGTH] reserved bytes, which are filled here with its length and
+		 * sequence number.
+		 */
+		bool send0(ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) const;
 
 		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
 
+		void send_encoded(RdId const& rd_id, Buffer::Encoding message_encoding, std::function<void(Buffer& buffer)> writer) const override;
+
+		void send_batched(RdId const& rd_id, Buffer::ByteArray key, std::function<void(Buffer& buffer)> writer) const override;
+
+		bool has_capability(Capability capability) const override;
+
+		Buffer::Encoding get_encoding() const override;
+
+		/**
+		 * \brief Offers [value] to the counterpart on every connection, and right away when already connected. New
+		 * messages use it once the counterpart offers the same one, until then and with counterparts which never offer
+		 * anything they stay [Buffer::Encoding::Fixed]. Each direction switches on its own. The offer is a control
+		 * package older RD implementations don't understand, so it's only to be enabled when the counterpart is known
+		 * to support it.
+		 */
+		void set_offered_encoding(Buffer::Encoding value);
+
+		bool send_encoding_offer() const;
+
+		void on_encoding_offered(sequence_number_t value) const;
+
+		/**
+		 * \brief Offers [value], a bit mask of [IWire::Capability] flags, to the counterpart the same way as
+		 * [set_offered_encoding]. A capability is used once the counterpart offers it too. The offer is a control
+		 * package older RD implementations don't understand, so it's only to be enabled when the counterpart is known
+		 * to support it.
+		 */
+		void set_offered_capabilities(uint32_t value);
+
+		bool send_capabilities_offer() const;
+
+		void on_capabilities_offered(sequence_number_t value) const;
+
+		/**
+		 * \brief Handles a shared memory package of the counterpart. The end creating the segment offers it, the other
+		 * end maps it and accepts or declines it. Each end sends everything through the ring right after its last
+		 * package through the socket, which for the creator is the reply to the acceptance, so each direction switches
+		 * on its own at a known point of the stream.
+		 */
+		void on_shared_memory_offered(sequence_number_t value) const;
+
+		/**
+		 * \brief Whether this end sends through a shared memory ring.
+		 */
+		bool is_shared_memory_used() const;
+
+		Stats get_stats() const override;
+
 		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
 
 		std::future<void> start_heartbeat(Lifetime lifetime);
@@ -31,6 +31,11 @@ bool BluePrintProvider::IsBlueprint(FString const& pathName) {
     return FPackageName::IsValidObjectPath(pathName);
 }
 
+FSimpleMulticastDelegate& BluePrintProvider::OnBlueprintsChanged() {
+    static FSimpleMulticastDelegate Delegate;
+    return Delegate;
+}
+
 void BluePrintProvider::OpenBlueprint(FString const& AssetPathName, TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> const& messageEndpoint) {
     // Just to create asset manager if it wasn't created already
 #if ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION <= 23
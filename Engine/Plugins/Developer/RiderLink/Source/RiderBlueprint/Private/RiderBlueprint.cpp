@@ -5,11 +5,13 @@
 #include "Model/RdEditorProtocol/RdEditorModel/RdEditorModel.Generated.h"
 
 #include "AssetRegistryModule.h"
+#include "Editor.h"
 #include "Engine/Blueprint.h"
 #include "Framework/Docking/TabManager.h"
 #include "HAL/PlatformProcess.h"
 #include "MessageEndpoint.h"
 #include "MessageEndpointBuilder.h"
+#include "Misc/CoreDelegates.h"
 #include "Modules/ModuleManager.h"
 
 #define LOCTEXT_NAMESPACE "RiderLink"
@@ -47,11 +49,37 @@ void FRiderBlueprintModule::StartupModule()
 
     MessageEndpoint = FMessageEndpoint::Builder(FName("FAssetEditorManager")).Build();
 
-    AssetRegistryModule->Get().OnAssetAdded().AddLambda([](const FAssetData& AssetData) {
+    IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+    AssetAddedHandle = AssetRegistry.OnAssetAdded().AddLambda([](const FAssetData& AssetData) {
         // TO-DO: Fix loading uasset's on 4.23-
         // BluePrintProvider::AddAsset(AssetData);
+        BluePrintProvider::OnBlueprintsChanged().Broadcast();
+    });
+    AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddLambda([](const FAssetData&) {
+        BluePrintProvider::OnBlueprintsChanged().Broadcast();
+    });
+    AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddLambda([](const FAssetData&, const FString&) {
+        BluePrintProvider::OnBlueprintsChanged().Broadcast();
     });
 
+    // GEditor doesn't exist yet while the Default loading phase runs
+    auto BindBlueprintCompiled = [this]() {
+        if (GEditor)
+        {
+            BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddLambda([]() {
+                BluePrintProvider::OnBlueprintsChanged().Broadcast();
+            });
+        }
+    };
+    if (GEditor)
+    {
+        BindBlueprintCompiled();
+    }
+    else
+    {
+        PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda(BindBlueprintCompiled);
+    }
+
     RiderLinkModule.ViewModel(ModuleLifetimeDef.lifetime, [this] (rd::Lifetime ModelLifetime, JetBrains::EditorPlugin::RdEditorModel const& UnrealToBackendModel)
     {
         UnrealToBackendModel.get_openBlueprint().advise(
@@ -95,6 +123,18 @@ void FRiderBlueprintModule::StartupModule()
 void FRiderBlueprintModule::ShutdownModule()
 {
     UE_LOG(FLogRiderBlueprintModule, Verbose, TEXT("SHUTDOWN START"));
+    FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+    if (GEditor)
+    {
+        GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+    }
+    if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+    {
+        IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+    }
     ModuleLifetimeDef.terminate();
     UE_LOG(FLogRiderBlueprintModule, Verbose, TEXT("SHUTDOWN FINISH"));
 }
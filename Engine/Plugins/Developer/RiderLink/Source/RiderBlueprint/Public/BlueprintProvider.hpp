@@ -13,5 +13,8 @@ public:
 
     static bool IsBlueprint(FString const& pathName);
 
+    /** Broadcast when assets are added, removed, renamed or a blueprint is recompiled, so cached IsBlueprint results go stale. */
+    static FSimpleMulticastDelegate& OnBlueprintsChanged();
+
     static void OpenBlueprint(FString const& path, TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> const& messageEndpoint);
 };
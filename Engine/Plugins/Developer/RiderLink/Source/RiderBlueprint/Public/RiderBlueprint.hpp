@@ -2,6 +2,7 @@
 
 #include "lifetime/LifetimeDefinition.h"
 
+#include "Delegates/IDelegateInstance.h"
 #include "Logging/LogMacros.h"
 #include "Logging/LogVerbosity.h"
 #include "MessageEndpoint.h"
@@ -22,5 +23,10 @@ public:
     virtual bool SupportsDynamicReloading() override { return true; };
 private:
     TSharedPtr<FMessageEndpoint, ESPMode::ThreadSafe> MessageEndpoint;
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+    FDelegateHandle BlueprintCompiledHandle;
+    FDelegateHandle PostEngineInitHandle;
     rd::LifetimeDefinition ModuleLifetimeDef;
 };
@@ -11,7 +11,9 @@
 #include "HAL/PlatformFilemanager.h"
 #endif
 #include "Misc/App.h"
+#include "Misc/CommandLine.h"
 #include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
 #include "Misc/Paths.h"
 
 #if PLATFORM_WINDOWS
@@ -99,9 +101,28 @@ void ProtocolFactory::InitRdLogging()
 std::shared_ptr<rd::SocketWire::Server> ProtocolFactory::CreateWire(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime)
 {
     const FString ProjectName = GetProjectName();
-    return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0,
+    auto Wire = std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0,
                                                          TCHAR_TO_UTF8(*FString::Printf(TEXT("UnrealEditorServer-%s"),
                                                              *ProjectName)));
+    // Only IDE builds which understand the encoding offer may be asked for it, older ones would misread it.
+    // The IDE connects after the port file is written, so the offer is set before the first connection.
+    if (FParse::Param(FCommandLine::Get(), TEXT("RiderLinkCompactEncoding")))
+    {
+        Wire->set_offered_encoding(rd::Buffer::Encoding::Compact);
+    }
+    // Same for collection batches: bound collections are sent in one package and bursts of changes coalesce.
+    uint32_t Capabilities = 0;
+    if (FParse::Param(FCommandLine::Get(), TEXT("RiderLinkCollectionBatches")))
+    {
+        Capabilities |= static_cast<uint32_t>(rd::IWire::Capability::CollectionBatches);
+    }
+    // And for the shared memory transport, Linux only. Elsewhere, or if the IDE doesn't offer it, the socket is used.
+    if (FParse::Param(FCommandLine::Get(), TEXT("RiderLinkSharedMemory")))
+    {
+        Capabilities |= static_cast<uint32_t>(rd::IWire::Capability::SharedMemory);
+    }
+    Wire->set_offered_capabilities(Capabilities);
+    return Wire;
 }
 
 
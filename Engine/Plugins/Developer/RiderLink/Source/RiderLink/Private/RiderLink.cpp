@@ -2,6 +2,7 @@
 
 #include "ProtocolFactory.h"
 #include "UE4Library/UE4Library.Generated.h"
+#include "util/logging.h"
 
 #include "Misc/ScopeRWLock.h"
 #include "Modules/ModuleManager.h"
@@ -17,6 +18,8 @@ void FRiderLinkModule::ShutdownModule()
 {
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN START"));
 	ModuleLifetimeDef.terminate();
+	// Flushes the RD log file and stops the log writer thread before the module is unloaded
+	rd::util::shutdown_logging();
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN FINISH"));
 }
 
@@ -22,6 +22,8 @@ public class RiderLink : ModuleRules
 			"Public/Model/RdEditorProtocol",
 		};
 		
+		// Outside Debug builds RD compiles trace and debug messages out (SPDLOG_ACTIVE_LEVEL in RD.Build.cs),
+		// so the log file only gets info and above there even though its sink takes everything.
 		PrivateDefinitions.Add("ENABLE_LOG_FILE=0");
 
 		foreach(var Item in Paths)
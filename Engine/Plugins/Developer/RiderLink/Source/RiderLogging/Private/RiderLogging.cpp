@@ -6,10 +6,11 @@
 #include "Model/Library/UE4Library/StringRange.Generated.h"
 #include "Model/Library/UE4Library/UnrealLogEvent.Generated.h"
 
-#include "Internationalization/Regex.h"
 #include "Misc/DateTime.h"
 #include "Modules/ModuleManager.h"
 
+#include <atomic>
+
 #define LOCTEXT_NAMESPACE "RiderLink"
 
 DEFINE_LOG_CATEGORY(FLogRiderLoggingModule);
@@ -18,75 +19,188 @@ IMPLEMENT_MODULE(FRiderLoggingModule, RiderLogging);
 
 namespace LoggingExtensionImpl
 {
-static TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>> GetPathRanges(
-	const FRegexPattern& Pattern,
-	const FString& Str)
+using JetBrains::EditorPlugin::LogMessageInfo;
+using JetBrains::EditorPlugin::StringRange;
+using JetBrains::EditorPlugin::UnrealLogEvent;
+
+// Events are only touched on the LoggingScheduler thread.
+static TArray<UnrealLogEvent> PendingEvents;
+static TMap<FString, bool> BlueprintPathCache;
+// Set from the game thread when assets or blueprints change, the cache is dropped on its next use.
+static std::atomic<bool> bBlueprintPathCacheStale{false};
+
+static constexpr int32 MAX_BATCH_SIZE = 256;
+static constexpr int32 MAX_CACHED_PATHS = 4096;
+
+static bool IsPathChar(TCHAR C)
+{
+	return FChar::IsAlnum(C) || C == TEXT('_') || C == TEXT('.');
+}
+
+static bool IsIdentifierChar(TCHAR C)
+{
+	return (C >= TEXT('0') && C <= TEXT('9')) || (C >= TEXT('a') && C <= TEXT('z')) || (C >= TEXT('A') && C <= TEXT('Z')) || C == TEXT('_');
+}
+
+static bool IsBlueprintCached(const FString& PathName)
 {
-	using JetBrains::EditorPlugin::StringRange;
-	FRegexMatcher Matcher(Pattern, Str);
-	TArray<rd::Wrapper<StringRange>> Ranges;
-	while (Matcher.FindNext())
+	if (bBlueprintPathCacheStale.exchange(false))
+	{
+		BlueprintPathCache.Reset();
+	}
+	if (const bool* Cached = BlueprintPathCache.Find(PathName))
+	{
+		return *Cached;
+	}
+	if (BlueprintPathCache.Num() >= MAX_CACHED_PATHS)
 	{
-		const int Start = Matcher.GetMatchBeginning();
-		const int End = Matcher.GetMatchEnding();
-		FString PathName = Str.Mid(Start, End - Start);
-		if (BluePrintProvider::IsBlueprint(PathName))
-			Ranges.Emplace(StringRange(Start, End));
+		BlueprintPathCache.Reset();
 	}
-	return Ranges;
+	return BlueprintPathCache.Add(PathName, BluePrintProvider::IsBlueprint(PathName));
 }
 
-static TArray<rd::Wrapper<JetBrains::EditorPlugin::StringRange>> GetMethodRanges(
-	const FRegexPattern& Pattern,
-	const FString& Str)
+/** Matches "::~?[0-9a-z_A-Z]+" right after an identifier ending at NameEnd, returns the end of the method or INDEX_NONE. */
+static int32 MatchMethodTail(const TCHAR* Chars, int32 Len, int32 NameEnd)
 {
-	using JetBrains::EditorPlugin::StringRange;
-	FRegexMatcher Matcher(Pattern, Str);
-	TArray<rd::Wrapper<StringRange>> Ranges;
-	while (Matcher.FindNext())
+	if (NameEnd + 2 >= Len || Chars[NameEnd] != TEXT(':') || Chars[NameEnd + 1] != TEXT(':'))
 	{
-		Ranges.Emplace(StringRange(Matcher.GetMatchBeginning(), Matcher.GetMatchEnding()));
+		return INDEX_NONE;
 	}
-	return Ranges;
+	int32 End = NameEnd + 2;
+	if (Chars[End] == TEXT('~'))
+	{
+		End++;
+	}
+	const int32 MethodStart = End;
+	while (End < Len && IsIdentifierChar(Chars[End]))
+	{
+		End++;
+	}
+	return End > MethodStart ? End : INDEX_NONE;
 }
 
-static bool SendMessageToRider(const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo, const FString& Message)
+/** Single pass over the message, collecting blueprint paths "(/[\w\.]+)+" and methods "[0-9a-z_A-Z]+::~?[0-9a-z_A-Z]+". */
+static void ScanRanges(const FString& Str,
+	TArray<rd::Wrapper<StringRange>>& PathRanges,
+	TArray<rd::Wrapper<StringRange>>& MethodRanges)
 {
-	static const FRegexPattern PathPattern = FRegexPattern(TEXT("(/[\\w\\.]+)+"));
-	static const FRegexPattern MethodPattern = FRegexPattern(TEXT("[0-9a-z_A-Z]+::~?[0-9a-z_A-Z]+"));
-	
-	return IRiderLinkModule::Get().FireAsyncAction(
-	[&MessageInfo, &Message] (JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+	const TCHAR* Chars = *Str;
+	const int32 Len = Str.Len();
+
+	int32 I = 0;
+	while (I < Len)
 	{
-		rd::ISignal<JetBrains::EditorPlugin::UnrealLogEvent> const& UnrealLog = RdEditorModel.get_unrealLog();
-		UnrealLog.fire({
-			MessageInfo,
-			Message,
-			GetPathRanges(PathPattern, Message),
-			GetMethodRanges(MethodPattern, Message)
-		});
+		if (Chars[I] == TEXT('/'))
+		{
+			const int32 Start = I;
+			while (I + 1 < Len && Chars[I] == TEXT('/') && IsPathChar(Chars[I + 1]))
+			{
+				I += 2;
+				while (I < Len && IsPathChar(Chars[I]))
+				{
+					I++;
+				}
+			}
+			if (I == Start)
+			{
+				I++;
+				continue;
+			}
+			if (IsBlueprintCached(Str.Mid(Start, I - Start)))
+			{
+				PathRanges.Emplace(StringRange(Start, I));
+			}
+
+			// A path may end with the class part of a method, as in "/Script/Module.Class::Method".
+			int32 NameStart = I;
+			while (NameStart > Start && IsIdentifierChar(Chars[NameStart - 1]))
+			{
+				NameStart--;
+			}
+			const int32 MethodEnd = NameStart < I ? MatchMethodTail(Chars, Len, I) : INDEX_NONE;
+			if (MethodEnd != INDEX_NONE)
+			{
+				MethodRanges.Emplace(StringRange(NameStart, MethodEnd));
+				I = MethodEnd;
+			}
+		}
+		else if (IsIdentifierChar(Chars[I]))
+		{
+			const int32 Start = I;
+			while (I < Len && IsIdentifierChar(Chars[I]))
+			{
+				I++;
+			}
+			const int32 MethodEnd = MatchMethodTail(Chars, Len, I);
+			if (MethodEnd != INDEX_NONE)
+			{
+				MethodRanges.Emplace(StringRange(Start, MethodEnd));
+				I = MethodEnd;
+			}
+		}
+		else
+		{
+			I++;
+		}
+	}
+}
+
+void FlushMessages()
+{
+	if (PendingEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// One model access for the whole batch, the wire coalesces the queued events into a single write.
+	IRiderLinkModule::Get().FireAsyncAction(
+	[] (JetBrains::EditorPlugin::RdEditorModel const& RdEditorModel)
+	{
+		rd::ISignal<UnrealLogEvent> const& UnrealLog = RdEditorModel.get_unrealLog();
+		for (const UnrealLogEvent& Event : PendingEvents)
+		{
+			UnrealLog.fire(Event);
+		}
 	});
+	PendingEvents.Reset();
+}
+
+static void AddMessage(const LogMessageInfo& MessageInfo, FString Message)
+{
+	TArray<rd::Wrapper<StringRange>> PathRanges;
+	TArray<rd::Wrapper<StringRange>> MethodRanges;
+	ScanRanges(Message, PathRanges, MethodRanges);
+	PendingEvents.Emplace(MessageInfo, MoveTemp(Message), MoveTemp(PathRanges), MoveTemp(MethodRanges));
+
+	if (PendingEvents.Num() >= MAX_BATCH_SIZE)
+	{
+		FlushMessages();
+	}
 }
 
-void SendMessageInChunks(FString* Msg, const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo)
+void AddMessageInChunks(FString* Msg, const LogMessageInfo& MessageInfo)
 {
 	static int NUMBER_OF_CHUNKS = 1024;
 	while (!Msg->IsEmpty())
 	{
-		SendMessageToRider(MessageInfo, Msg->Left(NUMBER_OF_CHUNKS));
+		AddMessage(MessageInfo, Msg->Left(NUMBER_OF_CHUNKS));
 		*Msg = Msg->RightChop(NUMBER_OF_CHUNKS);
 	}
 }
 
-void ScheduledSendMessage(FString* Msg, const JetBrains::EditorPlugin::LogMessageInfo& MessageInfo)
+/** Returns true if the batch was empty, the caller then schedules a flush behind the messages queued so far. */
+bool ScheduledAddMessage(FString* Msg, const LogMessageInfo& MessageInfo)
 {
+	const bool bStartedBatch = PendingEvents.Num() == 0;
+
 	FString ToSend;
 	while (Msg->Split("\n", &ToSend, Msg))
 	{
-		SendMessageInChunks(&ToSend, MessageInfo);
+		AddMessageInChunks(&ToSend, MessageInfo);
 	}
 
-	SendMessageInChunks(Msg, MessageInfo);
+	AddMessageInChunks(Msg, MessageInfo);
+	return bStartedBatch;
 }
 }
 
@@ -106,6 +220,10 @@ void FRiderLoggingModule::StartupModule()
 	ModuleLifetimeDef.lifetime->bracket(
 	[this]()
 	{
+		BlueprintsChangedHandle = BluePrintProvider::OnBlueprintsChanged().AddLambda([]()
+		{
+			LoggingExtensionImpl::bBlueprintPathCacheStale = true;
+		});
 		OutputDevice.onSerializeMessage.BindLambda(
 		[this](const TCHAR* msg, ELogVerbosity::Type Type, const class FName& Name, TOptional<double> Time)
 		{
@@ -118,14 +236,18 @@ void FRiderLoggingModule::StartupModule()
 			}
 			const FString PlainName = Name.GetPlainNameString();
 			const JetBrains::EditorPlugin::LogMessageInfo MessageInfo{Type, PlainName, DateTime};
-			LoggingScheduler->queue([Msg = FString(msg), MessageInfo]() mutable
+			LoggingScheduler->queue([this, Msg = FString(msg), MessageInfo]() mutable
 			{
-				LoggingExtensionImpl::ScheduledSendMessage(&Msg, MessageInfo);
+				if (LoggingExtensionImpl::ScheduledAddMessage(&Msg, MessageInfo))
+				{
+					LoggingScheduler->queue([]() { LoggingExtensionImpl::FlushMessages(); });
+				}
 			});
 		});
 	},
 	[this]()
 	{
+		BluePrintProvider::OnBlueprintsChanged().Remove(BlueprintsChangedHandle);
 		if (OutputDevice.onSerializeMessage.IsBound())
 			OutputDevice.onSerializeMessage.Unbind();
 	});
@@ -136,6 +258,11 @@ void FRiderLoggingModule::StartupModule()
 void FRiderLoggingModule::ShutdownModule()
 {
 	UE_LOG(FLogRiderLoggingModule, Verbose, TEXT("SHUTDOWN START"));
+	if (OutputDevice.onSerializeMessage.IsBound())
+		OutputDevice.onSerializeMessage.Unbind();
+	// Send the last batch while the scheduler still runs, tasks queued once it stops are dropped.
+	LoggingScheduler->queue([]() { LoggingExtensionImpl::FlushMessages(); });
+	LoggingScheduler->flush();
 	ModuleLifetimeDef.terminate();
 	UE_LOG(FLogRiderLoggingModule, Verbose, TEXT("SHUTDOWN FINISH"));
 }
@@ -27,5 +27,6 @@ public:
 private:
     TUniquePtr<rd::SingleThreadScheduler> LoggingScheduler;
     FRiderOutputDevice OutputDevice;
+    FDelegateHandle BlueprintsChangedHandle;
     rd::LifetimeDefinition ModuleLifetimeDef;
 };
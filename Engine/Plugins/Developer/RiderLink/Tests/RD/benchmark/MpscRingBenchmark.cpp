@@ -0,0 +1,232 @@
+// Producer-side throughput of ByteBufferAsyncProcessor's queue at 1 to 16 producer threads. Prints one JSON document
+// to stdout comparing:
+//
+//   mpsc_ring    MpscRing alone, the consumer polls it
+//   processor    ByteBufferAsyncProcessor::put up to the processor callback, acknowledging every batch
+//   mutex_deque  the put path the processor had before MpscRing: a recursive mutex around a vector the consumer
+//                swaps out into a deque, and a condition variable notified on every put
+//
+//   rd_ring_bench [--quick]
+//
+// --quick   runs a tenth of the packages, enough to check the harness itself
+
+#include "wire/ByteBufferAsyncProcessor.h"
+#include "wire/MpscRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using clock_t = std::chrono::steady_clock;
+
+constexpr size_t PACKAGE_SIZE = 32;
+
+struct Result
+{
+	std::string name;
+	int32_t producers;
+	int64_t packages;
+	double seconds;
+
+	Result(std::string name, int32_t producers, int64_t packages, double seconds)
+		: name(std::move(name)), producers(producers), packages(packages), seconds(seconds)
+	{
+	}
+};
+
+/**
+ * \brief Starts [producers] threads each calling [put] for its share of [packages], waits for them and for [drained].
+ */
+template <typename Put, typename Drained>
+double run_producers(int32_t producers, int64_t packages, Put&& put, Drained&& drained)
+{
+	std::atomic<bool> go{false};
+	std::vector<std::thread> threads;
+	for (int32_t p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&, p] {
+			while (!go.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			for (int64_t i = p; i < packages; i += producers)
+			{
+				put(Buffer::ByteArray(PACKAGE_SIZE, static_cast<uint8_t>(i)));
+			}
+		});
+	}
+
+	const auto started_at = clock_t::now();
+	go.store(true, std::memory_order_release);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	drained();
+	return std::chrono::duration<double>(clock_t::now() - started_at).count();
+}
+
+Result bench_ring(int32_t producers, int64_t packages)
+{
+	MpscRing<Buffer::ByteArray> ring(1u << 14);
+	std::atomic<int64_t> consumed{0};
+	std::thread consumer([&] {
+		Buffer::ByteArray package;
+		int64_t count = 0;
+		while (count < packages)
+		{
+			if (ring.try_pop(package))
+			{
+				++count;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		consumed.store(count, std::memory_order_release);
+	});
+
+	const double seconds = run_producers(
+		producers, packages,
+		[&](Buffer::ByteArray&& package) {
+			while (!ring.try_push(std::move(package)))
+			{
+				std::this_thread::yield();
+			}
+		},
+		[&] { consumer.join(); });
+	return Result("mpsc_ring", producers, consumed.load(), seconds);
+}
+
+Result bench_processor(int32_t producers, int64_t packages)
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	int64_t processed = 0;
+	ByteBufferAsyncProcessor* self = nullptr;
+	ByteBufferAsyncProcessor processor("RingBench", [&](ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) {
+		// acknowledged right away, so pending packages go back to the pool like on a live connection
+		self->acknowledge(first_seqn + static_cast<sequence_number_t>(batch.size()) - 1);
+		std::lock_guard<std::mutex> guard(lock);
+		processed += static_cast<int64_t>(batch.size());
+		cv.notify_all();
+		return true;
+	});
+	self = &processor;
+	processor.start();
+
+	const double seconds = run_producers(
+		producers, packages, [&](Buffer::ByteArray&& package) { processor.put(std::move(package)); },
+		[&] {
+			std::unique_lock<std::mutex> ul(lock);
+			cv.wait(ul, [&] { return processed >= packages; });
+		});
+	processor.terminate(std::chrono::milliseconds(1000));
+	return Result("processor", producers, processed, seconds);
+}
+
+/**
+ * \brief The producer side ByteBufferAsyncProcessor had before MpscRing, with the consumer moving packages into its
+ * queue the way add_data did.
+ */
+class MutexDeque
+{
+	std::recursive_mutex lock;
+	std::condition_variable_any cv;
+	std::vector<Buffer::ByteArray> data;
+	std::deque<Buffer::ByteArray> queue;
+
+public:
+	void put(Buffer::ByteArray&& package)
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			data.emplace_back(std::move(package));
+		}
+		cv.notify_all();
+	}
+
+	int64_t consume(int64_t packages)
+	{
+		int64_t count = 0;
+		while (count < packages)
+		{
+			{
+				std::unique_lock<decltype(lock)> ul(lock);
+				cv.wait(ul, [this] { return !data.empty(); });
+				std::move(data.begin(), data.end(), std::back_inserter(queue));
+				data.clear();
+			}
+			count += static_cast<int64_t>(queue.size());
+			queue.clear();
+		}
+		return count;
+	}
+};
+
+Result bench_mutex_deque(int32_t producers, int64_t packages)
+{
+	MutexDeque queue;
+	int64_t consumed = 0;
+	std::thread consumer([&] { consumed = queue.consume(packages); });
+
+	const double seconds = run_producers(
+		producers, packages, [&](Buffer::ByteArray&& package) { queue.put(std::move(package)); }, [&] { consumer.join(); });
+	return Result("mutex_deque", producers, consumed, seconds);
+}
+
+void print(std::vector<Result> const& results)
+{
+	std::printf("{\n  \"package_bytes\": %zu,\n  \"benchmarks\": [\n", PACKAGE_SIZE);
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		Result const& r = results[i];
+		std::printf("    {\"name\": \"%s\", \"producers\": %d, \"packages\": %lld, \"seconds\": %.6f, \"packages_per_sec\": %.1f}%s\n",
+			r.name.c_str(), r.producers, static_cast<long long>(r.packages), r.seconds,
+			static_cast<double>(r.packages) / r.seconds, i + 1 < results.size() ? "," : "");
+	}
+	std::printf("  ]\n}\n");
+}
+}	 // namespace
+
+int main(int argc, char** argv)
+{
+	int64_t packages = int64_t{1} << 21;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--quick")
+		{
+			packages /= 10;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+	spdlog::set_level(spdlog::level::warn);
+
+	std::vector<Result> results;
+	for (int32_t producers : {1, 2, 4, 8, 16})
+	{
+		results.push_back(bench_ring(producers, packages));
+		results.push_back(bench_processor(producers, packages));
+		results.push_back(bench_mutex_deque(producers, packages));
+	}
+	print(results);
+	return 0;
+}
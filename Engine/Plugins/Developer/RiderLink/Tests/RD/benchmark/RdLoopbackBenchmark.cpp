@@ -0,0 +1,527 @@
+// Loopback throughput and latency of the RD protocol: a server and a client SocketWire in one process, connected over
+// 127.0.0.1. Prints one JSON document to stdout, so numbers can be compared across engine upgrades.
+//
+// Ping-pong and call scenarios report round-trip latency, one message in flight at a time. Flood scenarios report the
+// one-way delay of each message while producers saturate the wire, which is mostly time spent queued. Scenarios that
+// don't time single messages print null percentiles. The call scenario also counts heap allocations per call, on both
+// ends of the loopback.
+//
+//   rd_bench [--quick] [--compact] [--shared-memory]
+//
+// --quick         runs a tenth of the messages, enough to check the harness itself
+// --compact       offers Buffer::Encoding::Compact on both ends
+// --shared-memory offers IWire::Capability::SharedMemory on both ends, where SharedMemoryRing is supported
+
+#include "impl/RdMap.h"
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SimpleScheduler.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "serialization/InternedSerializer.h"
+#include "task/RdCall.h"
+#include "task/RdEndpoint.h"
+#include "wire/SharedMemoryRing.h"
+#include "wire/SocketWire.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+std::atomic<int64_t> allocations{0};
+}	 // namespace
+
+// Counts heap allocations for the call scenario. The replaced operators allocate and release with malloc and free on
+// both sides, but GCC pairs the free with the operator new it inlined into callers and reports every such site.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+using clock_t = std::chrono::steady_clock;
+
+struct Options
+{
+	int64_t scale = 10;
+	Buffer::Encoding encoding = Buffer::Encoding::Fixed;
+	bool shared_memory = false;
+};
+
+enum class Latency
+{
+	None,
+	OneWayUnderLoad,
+	RoundTrip
+};
+
+struct Result
+{
+	std::string name;
+	int32_t producers;
+	size_t payload_bytes;
+	int64_t messages;
+	Latency latency;
+	double seconds = 0;
+	std::vector<int64_t> latencies_ns;
+	// heap allocations during the run, -1 if not counted
+	int64_t allocations = -1;
+
+	Result(std::string name, int32_t producers, size_t payload_bytes, int64_t messages, Latency latency)
+		: name(std::move(name)), producers(producers), payload_bytes(payload_bytes), messages(messages), latency(latency)
+	{
+	}
+};
+
+/**
+ * \brief Server and client protocols connected over loopback, entities are bound on both with [bind]. Protocols run
+ * on [scheduler], by default a SimpleScheduler that executes everything on the calling thread.
+ */
+class Loopback
+{
+public:
+	LifetimeDefinition def;
+	SimpleScheduler simple_scheduler;
+	IScheduler* scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<SocketWire::Client> client_wire;
+	std::unique_ptr<Protocol> server;
+	std::unique_ptr<Protocol> client;
+
+	Loopback(std::string const& name, Options const& options, IScheduler* protocol_scheduler = nullptr)
+		: scheduler(protocol_scheduler ? protocol_scheduler : &simple_scheduler)
+	{
+		const uint32_t capabilities = options.shared_memory ? static_cast<uint32_t>(IWire::Capability::SharedMemory) : 0;
+		server_wire = std::make_shared<SocketWire::Server>(def.lifetime, scheduler, 0, name + "Server");
+		server_wire->set_offered_encoding(options.encoding);
+		server_wire->set_offered_capabilities(capabilities);
+		client_wire = std::make_shared<SocketWire::Client>(def.lifetime, scheduler, server_wire->port, name + "Client");
+		client_wire->set_offered_encoding(options.encoding);
+		client_wire->set_offered_capabilities(capabilities);
+		server = std::make_unique<Protocol>(Identities::SERVER, scheduler, server_wire, def.lifetime);
+		client = std::make_unique<Protocol>(Identities::CLIENT, scheduler, client_wire, def.lifetime);
+		// binds the intern roots, otherwise the server only does it on the first message read and drops the ids
+		// interned before that
+		server->get_serialization_context();
+		client->get_serialization_context();
+
+		const bool shared_memory = options.shared_memory && SharedMemoryRing::is_supported();
+		while (!client_wire->connected.get() || client_wire->get_encoding() != options.encoding ||
+			   server_wire->get_encoding() != options.encoding ||
+			   (shared_memory && (!client_wire->is_shared_memory_used() || !server_wire->is_shared_memory_used())))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	/**
+	 * \brief Unbinds everything, to be called before the bound entities and the state their handlers use go away.
+	 */
+	void stop()
+	{
+		def.terminate();
+	}
+
+	~Loopback()
+	{
+		stop();
+	}
+
+	template <typename S, typename C>
+	void bind(S& on_server, C& on_client, int64_t id, std::string const& name)
+	{
+		statics(on_server, id).bind(def.lifetime, server.get(), name);
+		statics(on_client, id).bind(def.lifetime, client.get(), name);
+	}
+};
+
+/**
+ * \brief Counts received messages and wakes the producer thread once all of them are in.
+ */
+class Countdown
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	int64_t left = 0;
+
+public:
+	explicit Countdown(int64_t count) : left(count)
+	{
+	}
+
+	void count_down()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (--left == 0)
+		{
+			cv.notify_all();
+		}
+	}
+
+	void wait()
+	{
+		std::unique_lock<std::mutex> ul(lock);
+		cv.wait(ul, [this] { return left <= 0; });
+	}
+};
+
+int64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now().time_since_epoch()).count();
+}
+
+/**
+ * \brief Runs [producers] threads each calling [produce] with its share of [messages] indices.
+ */
+template <typename F>
+double run_producers(int32_t producers, int64_t messages, Countdown& received, F&& produce)
+{
+	const auto started_at = clock_t::now();
+	std::vector<std::thread> threads;
+	for (int32_t p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&, p] {
+			for (int64_t i = p; i < messages; i += producers)
+			{
+				produce(i);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	received.wait();
+	return std::chrono::duration<double>(clock_t::now() - started_at).count();
+}
+
+Result bench_signal_small(Options const& options, int32_t producers)
+{
+	Loopback loopback("SignalSmall", options);
+	RdSignal<int64_t> on_server;
+	RdSignal<int64_t> on_client;
+	loopback.bind(on_server, on_client, 1, "small");
+
+	Result result("signal_small", producers, sizeof(int64_t), 20000 * options.scale, Latency::OneWayUnderLoad);
+	std::vector<std::atomic<int64_t>> sent_at(static_cast<size_t>(result.messages));
+	result.latencies_ns.resize(static_cast<size_t>(result.messages));
+	Countdown received(result.messages);
+	on_server.advise(loopback.def.lifetime, [&](int64_t const& i) {
+		result.latencies_ns[static_cast<size_t>(i)] = now_ns() - sent_at[static_cast<size_t>(i)].load();
+		received.count_down();
+	});
+
+	result.seconds = run_producers(producers, result.messages, received, [&](int64_t i) {
+		sent_at[static_cast<size_t>(i)].store(now_ns());
+		on_client.fire(i);
+	});
+	loopback.stop();
+	return result;
+}
+
+Result bench_signal_bytes(Options const& options, int32_t producers, size_t payload_bytes)
+{
+	Loopback loopback("SignalBytes", options);
+	RdSignal<std::vector<uint8_t>> on_server;
+	RdSignal<std::vector<uint8_t>> on_client;
+	loopback.bind(on_server, on_client, 1, "bytes");
+
+	const int64_t total_bytes = (int64_t{64} << 20) * options.scale / 10;
+	Result result("signal_bytes", producers, payload_bytes,
+		(std::max)(int64_t{100}, total_bytes / static_cast<int64_t>(payload_bytes)), Latency::OneWayUnderLoad);
+	std::vector<std::atomic<int64_t>> sent_at(static_cast<size_t>(result.messages));
+	result.latencies_ns.resize(static_cast<size_t>(result.messages));
+	Countdown received(result.messages);
+	on_server.advise(loopback.def.lifetime, [&](std::vector<uint8_t> const& payload) {
+		int64_t i = 0;
+		std::memcpy(&i, payload.data(), sizeof(i));
+		result.latencies_ns[static_cast<size_t>(i)] = now_ns() - sent_at[static_cast<size_t>(i)].load();
+		received.count_down();
+	});
+
+	result.seconds = run_producers(producers, result.messages, received, [&](int64_t i) {
+		std::vector<uint8_t> payload(payload_bytes, static_cast<uint8_t>(i));
+		std::memcpy(payload.data(), &i, sizeof(i));
+		sent_at[static_cast<size_t>(i)].store(now_ns());
+		on_client.fire(payload);
+	});
+	loopback.stop();
+	return result;
+}
+
+/**
+ * \brief The client fires [payload_bytes] up, the server echoes them down, and the client sends the next message only
+ * once the echo is in.
+ */
+Result bench_signal_pingpong(Options const& options, size_t payload_bytes)
+{
+	Loopback loopback("PingPong", options);
+	RdSignal<std::vector<uint8_t>> up_server;
+	RdSignal<std::vector<uint8_t>> up_client;
+	RdSignal<std::vector<uint8_t>> down_server;
+	RdSignal<std::vector<uint8_t>> down_client;
+	loopback.bind(up_server, up_client, 1, "up");
+	loopback.bind(down_server, down_client, 2, "down");
+
+	const int64_t messages = payload_bytes > 4096 ? 200 * options.scale : 2000 * options.scale;
+	Result result("signal_pingpong", 1, payload_bytes, messages, Latency::RoundTrip);
+	std::mutex lock;
+	std::condition_variable cv;
+	int64_t echoed = 0;
+	up_server.advise(loopback.def.lifetime, [&](std::vector<uint8_t> const& payload) { down_server.fire(payload); });
+	down_client.advise(loopback.def.lifetime, [&](std::vector<uint8_t> const&) {
+		std::lock_guard<std::mutex> guard(lock);
+		++echoed;
+		cv.notify_all();
+	});
+
+	const std::vector<uint8_t> payload(payload_bytes, 0x5A);
+	const auto started_at = clock_t::now();
+	for (int64_t i = 0; i < result.messages; ++i)
+	{
+		const int64_t before = now_ns();
+		up_client.fire(payload);
+		std::unique_lock<std::mutex> ul(lock);
+		cv.wait(ul, [&] { return echoed > i; });
+		result.latencies_ns.push_back(now_ns() - before);
+	}
+	result.seconds = std::chrono::duration<double>(clock_t::now() - started_at).count();
+	loopback.stop();
+	return result;
+}
+
+Result bench_map_bulk(Options const& options)
+{
+	// maps aren't thread safe, puts and the acks coming back from the client have to run on one protocol thread
+	LifetimeDefinition protocol_thread_def;
+	SingleThreadScheduler protocol_thread(protocol_thread_def.lifetime, "MapBulkProtocol");
+	Loopback loopback("MapBulk", options, &protocol_thread);
+	RdMap<int32_t, std::wstring> on_server;
+	RdMap<int32_t, std::wstring> on_client;
+	on_server.is_master = true;
+
+	Result result("map_bulk_put", 1, 0, 10000 * options.scale, Latency::None);
+	const std::wstring value(L"/Game/Blueprints/BP_Character.BP_Character_C");
+	result.payload_bytes = sizeof(int32_t) + value.size() * sizeof(uint16_t);
+	Countdown received(result.messages);
+	protocol_thread.queue([&] {
+		loopback.bind(on_server, on_client, 1, "map");
+		on_client.advise_add_remove(loopback.def.lifetime, [&](AddRemove kind, int32_t const&, std::wstring const&) {
+			if (kind == AddRemove::ADD)
+			{
+				received.count_down();
+			}
+		});
+	});
+	protocol_thread.flush();
+
+	result.seconds = run_producers(1, result.messages, received, [&](int64_t i) {
+		protocol_thread.queue([&, i] { on_server.set(static_cast<int32_t>(i), value); });
+	});
+	// drains what is still queued and joins, so nothing touches the maps while they are unbound
+	protocol_thread_def.terminate();
+	loopback.stop();
+	return result;
+}
+
+Result bench_call(Options const& options)
+{
+	Loopback loopback("Call", options);
+	RdEndpoint<int32_t, int32_t> on_server([](int32_t const& request) { return request + 1; });
+	RdCall<int32_t, int32_t> on_client;
+	loopback.bind(on_server, on_client, 1, "call");
+
+	Result result("call_roundtrip", 1, sizeof(int32_t), 2000 * options.scale, Latency::RoundTrip);
+	result.latencies_ns.reserve(static_cast<size_t>(result.messages));
+	const int64_t allocations_before = allocations.load();
+	const auto started_at = clock_t::now();
+	for (int64_t i = 0; i < result.messages; ++i)
+	{
+		const int64_t before = now_ns();
+		on_client.sync(static_cast<int32_t>(i), std::chrono::seconds(10));
+		result.latencies_ns.push_back(now_ns() - before);
+	}
+	result.seconds = std::chrono::duration<double>(clock_t::now() - started_at).count();
+	result.allocations = allocations.load() - allocations_before;
+	loopback.stop();
+	return result;
+}
+
+Result bench_interned(Options const& options)
+{
+	using interned_t = InternedSerializer<Polymorphic<std::wstring>, util::getPlatformIndependentHash("Protocol")>;
+
+	Loopback loopback("Interned", options);
+	RdSignal<std::wstring, interned_t> on_server;
+	RdSignal<std::wstring, interned_t> on_client;
+	loopback.bind(on_server, on_client, 1, "interned");
+
+	std::vector<std::wstring> strings;
+	for (int32_t i = 0; i < 64; ++i)
+	{
+		strings.push_back(L"/Game/Maps/Level_" + std::to_wstring(i) + L".Level_" + std::to_wstring(i));
+	}
+
+	Result result(
+		"signal_interned_string", 1, strings[0].size() * sizeof(uint16_t), 20000 * options.scale, Latency::None);
+	Countdown received(result.messages);
+	on_server.advise(loopback.def.lifetime, [&](std::wstring const&) { received.count_down(); });
+
+	result.seconds = run_producers(1, result.messages, received,
+		[&](int64_t i) { on_client.fire(strings[static_cast<size_t>(i) % strings.size()]); });
+	loopback.stop();
+	return result;
+}
+
+/**
+ * \brief JSON number of microseconds at percentile [p] of [sorted], or null if nothing was timed.
+ */
+std::string percentile_us(std::vector<int64_t> const& sorted, double p)
+{
+	if (sorted.empty())
+	{
+		return "null";
+	}
+	const size_t index = (std::min)(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+	char text[32];
+	std::snprintf(text, sizeof(text), "%.1f", static_cast<double>(sorted[index]) / 1000.0);
+	return text;
+}
+
+std::string per_message(Result const& result)
+{
+	if (result.allocations < 0)
+	{
+		return "null";
+	}
+	char text[32];
+	std::snprintf(text, sizeof(text), "%.1f", static_cast<double>(result.allocations) / static_cast<double>(result.messages));
+	return text;
+}
+
+char const* to_json(Latency latency)
+{
+	switch (latency)
+	{
+		case Latency::OneWayUnderLoad:
+			return "\"one_way_under_load\"";
+		case Latency::RoundTrip:
+			return "\"round_trip\"";
+		default:
+			return "null";
+	}
+}
+
+void print(std::vector<Result>& results, Options const& options)
+{
+	std::printf("{\n  \"encoding\": \"%s\",\n  \"transport\": \"%s\",\n  \"benchmarks\": [\n",
+		options.encoding == Buffer::Encoding::Compact ? "compact" : "fixed",
+		options.shared_memory && SharedMemoryRing::is_supported() ? "shared_memory" : "socket");
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		Result& r = results[i];
+		std::sort(r.latencies_ns.begin(), r.latencies_ns.end());
+		std::printf(
+			"    {\"name\": \"%s\", \"producers\": %d, \"payload_bytes\": %zu, \"messages\": %lld, \"seconds\": %.6f, "
+			"\"messages_per_sec\": %.1f, \"mbytes_per_sec\": %.2f, \"latency\": %s, \"p50_us\": %s, \"p99_us\": %s, "
+			"\"allocs_per_message\": %s}%s\n",
+			r.name.c_str(), r.producers, r.payload_bytes, static_cast<long long>(r.messages), r.seconds,
+			static_cast<double>(r.messages) / r.seconds,
+			static_cast<double>(r.messages) * static_cast<double>(r.payload_bytes) / r.seconds / (1 << 20), to_json(r.latency),
+			percentile_us(r.latencies_ns, 0.50).c_str(), percentile_us(r.latencies_ns, 0.99).c_str(),
+			per_message(r).c_str(), i + 1 < results.size() ? "," : "");
+	}
+	std::printf("  ]\n}\n");
+}
+}	 // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--quick")
+		{
+			options.scale = 1;
+		}
+		else if (arg == "--compact")
+		{
+			options.encoding = Buffer::Encoding::Compact;
+		}
+		else if (arg == "--shared-memory")
+		{
+			options.shared_memory = true;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--quick] [--compact] [--shared-memory]\n", argv[0]);
+			return 2;
+		}
+	}
+	// wire and scheduler info lines would interleave with the report
+	spdlog::set_level(spdlog::level::warn);
+
+	std::vector<Result> results;
+	for (int32_t producers : {1, 2, 4})
+	{
+		results.push_back(bench_signal_small(options, producers));
+	}
+	for (size_t payload_bytes : {size_t{64}, size_t{4096}, size_t{65536}, size_t{1} << 20})
+	{
+		for (int32_t producers : {1, 4})
+		{
+			results.push_back(bench_signal_bytes(options, producers, payload_bytes));
+		}
+	}
+	for (size_t payload_bytes : {size_t{8}, size_t{4096}, size_t{65536}})
+	{
+		results.push_back(bench_signal_pingpong(options, payload_bytes));
+	}
+	results.push_back(bench_map_bulk(options));
+	results.push_back(bench_call(options));
+	results.push_back(bench_interned(options));
+
+	print(results, options);
+	return 0;
+}
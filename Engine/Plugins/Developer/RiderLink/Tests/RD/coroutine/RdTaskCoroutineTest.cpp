@@ -0,0 +1,89 @@
+// Built as C++20 with RD_TASK_COROUTINES defined, see CMakeLists.txt.
+
+#include <gtest/gtest.h>
+
+#include "task/RdTask.h"
+
+#include <coroutine>
+#include <exception>
+
+#ifndef RD_TASK_HAS_COROUTINES
+#error "RdTask is built without co_await support"
+#endif
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Coroutine type which starts eagerly and stores nothing, enough to drive co_await.
+ */
+struct Detached
+{
+	struct promise_type
+	{
+		Detached get_return_object()
+		{
+			return {};
+		}
+
+		std::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void()
+		{
+		}
+
+		void unhandled_exception()
+		{
+			std::terminate();
+		}
+	};
+};
+
+Detached add_one(RdTask<int32_t> task, int32_t& out)
+{
+	RdTaskResult<int32_t> const& result = co_await task;
+	out = result.unwrap() + 1;
+}
+
+Detached is_cancelled(RdTask<int32_t> task, bool& out)
+{
+	out = (co_await task).is_canceled();
+}
+}	 // namespace
+
+TEST(RdTaskCoroutine, resumesWhenTaskCompletes)
+{
+	RdTask<int32_t> task;
+	int32_t out = 0;
+	add_one(task, out);
+	EXPECT_EQ(0, out);
+
+	task.set(41);
+	EXPECT_EQ(42, out);
+}
+
+TEST(RdTaskCoroutine, doesntSuspendOnCompleteTask)
+{
+	int32_t out = 0;
+	add_one(RdTask<int32_t>::from_result(1), out);
+	EXPECT_EQ(2, out);
+}
+
+TEST(RdTaskCoroutine, resumesWithCancellation)
+{
+	RdTask<int32_t> task;
+	bool out = false;
+	is_cancelled(task, out);
+
+	task.cancel();
+	EXPECT_TRUE(out);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+TEST(Lifetime, parentTerminatesNested)
+{
+	LifetimeDefinition parent;
+	LifetimeDefinition nested(parent.lifetime);
+	int32_t terminated = 0;
+	nested.lifetime->add_action([&] { ++terminated; });
+
+	parent.terminate();
+	EXPECT_TRUE(nested.lifetime->is_terminated());
+	EXPECT_EQ(1, terminated);
+}
+
+TEST(Lifetime, nestedTerminatedFirstIsDetached)
+{
+	LifetimeDefinition parent;
+	std::vector<int32_t> log;
+	{
+		LifetimeDefinition nested(parent.lifetime);
+		nested.lifetime->add_action([&] { log.push_back(1); });
+		nested.terminate();
+	}
+	parent.lifetime->add_action([&] { log.push_back(2); });
+
+	parent.terminate();
+	EXPECT_EQ((std::vector<int32_t>{1, 2}), log);
+}
+
+TEST(Lifetime, nestedTerminatedConcurrentlyWithParentActions)
+{
+	// nested lifetimes detach from their parent under its lock while other threads add actions to it
+	LifetimeDefinition parent;
+	constexpr int32_t THREADS = 8;
+	constexpr int32_t NESTED_PER_THREAD = 2000;
+	std::atomic<int32_t> nested_terminated{0};
+	std::atomic<int32_t> parent_actions{0};
+
+	std::vector<std::thread> threads;
+	for (int32_t t = 0; t < THREADS; ++t)
+	{
+		threads.emplace_back([&] {
+			for (int32_t i = 0; i < NESTED_PER_THREAD; ++i)
+			{
+				LifetimeDefinition nested(parent.lifetime);
+				nested.lifetime->add_action([&] { ++nested_terminated; });
+				nested.terminate();
+			}
+			parent.lifetime->add_action([&] { ++parent_actions; });
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	EXPECT_EQ(THREADS * NESTED_PER_THREAD, nested_terminated.load());
+
+	// only the plain actions are left in the parent
+	parent.terminate();
+	EXPECT_EQ(THREADS, parent_actions.load());
+	EXPECT_EQ(THREADS * NESTED_PER_THREAD, nested_terminated.load());
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "reactive/base/SignalX.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <stdexcept>
+#include <vector>
+
+using namespace rd;
+
+TEST(Signal, handlerAdvisedDuringFireGetsValue)
+{
+	Signal<int32_t> signal;
+	LifetimeDefinition def;
+	std::vector<int32_t> log;
+
+	signal.advise(def.lifetime, [&](int32_t const& value) {
+		log.push_back(value);
+		if (value == 1)
+		{
+			signal.advise(def.lifetime, [&](int32_t const& inner) { log.push_back(inner * 10); });
+		}
+	});
+	signal.fire(1);
+	signal.fire(2);
+
+	EXPECT_EQ((std::vector<int32_t>{1, 10, 2, 20}), log);
+}
+
+TEST(Signal, throwingHandlerLeavesSignalUsable)
+{
+	Signal<int32_t> signal;
+	LifetimeDefinition def;
+	LifetimeDefinition short_def;
+	std::vector<int32_t> log;
+
+	signal.advise(def.lifetime, [&](int32_t const& value) {
+		if (value == 1)
+		{
+			throw std::runtime_error("handler failed");
+		}
+		log.push_back(value);
+	});
+	signal.advise(short_def.lifetime, [&](int32_t const& value) { log.push_back(value * 100); });
+
+	EXPECT_THROW(signal.fire(1), std::runtime_error);
+
+	short_def.terminate();
+	signal.fire(2);
+	signal.fire(3);
+
+	EXPECT_EQ((std::vector<int32_t>{2, 3}), log);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "util/logging.h"
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <mutex>
+
+using namespace rd;
+
+namespace
+{
+class counting_sink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+	size_t messages = 0;
+	size_t flushes = 0;
+
+protected:
+	void sink_it_(spdlog::details::log_msg const&) override
+	{
+		++messages;
+	}
+
+	void flush_() override
+	{
+		++flushes;
+	}
+};
+}	 // namespace
+
+TEST(Logging, shutdownDrainsQueueAndReleasesSinks)
+{
+	auto sink = std::make_shared<counting_sink>();
+	auto logger = util::create_logger("shutdownTest");
+	logger->set_level(spdlog::level::info);
+	logger->sinks().push_back(sink);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		logger->info("message {}", i);
+	}
+	util::shutdown_logging();
+
+	// The writer thread is joined, so the sink is no longer touched concurrently
+	EXPECT_EQ(100u, sink->messages);
+	EXPECT_GE(sink->flushes, 1u);
+	EXPECT_EQ(1, sink.use_count());
+	EXPECT_EQ(nullptr, spdlog::get("shutdownTest"));
+
+	// Loggers kept past shutdown discard messages instead of aborting on the missing queue
+	logger->error("after shutdown");
+	spdlog::error("after shutdown");
+	EXPECT_EQ(100u, sink->messages);
+}
+
+TEST(Logging, loggersCreatedAfterShutdownWrite)
+{
+	util::shutdown_logging();
+
+	auto sink = std::make_shared<counting_sink>();
+	auto logger = util::create_logger("restartTest");
+	logger->set_level(spdlog::level::info);
+	logger->sinks().push_back(sink);
+	logger->info("after restart");
+
+	util::shutdown_logging();
+	EXPECT_EQ(1u, sink->messages);
+}
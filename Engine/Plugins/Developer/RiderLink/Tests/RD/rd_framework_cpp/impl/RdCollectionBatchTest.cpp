@@ -0,0 +1,394 @@
+#include <gtest/gtest.h>
+
+#include "impl/RdList.h"
+#include "impl/RdMap.h"
+#include "impl/RdSet.h"
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "wire/SocketWire.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+constexpr uint32_t BATCHES = static_cast<uint32_t>(IWire::Capability::CollectionBatches);
+
+/**
+ * \brief Server and client wires connected over loopback, each side with a scheduler of its own so changes made in
+ * one scheduler action can be batched. The server map is the master one.
+ */
+class Loopback
+{
+public:
+	LifetimeDefinition def;
+	// scheduler names register loggers, so they're unique per fixture
+	SingleThreadScheduler server_scheduler;
+	SingleThreadScheduler client_scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<SocketWire::Client> client_wire;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	RdMap<int32_t, int32_t> server_map;
+	RdMap<int32_t, int32_t> client_map;
+	RdList<int32_t> server_list;
+	RdList<int32_t> client_list;
+	RdSet<int32_t> server_set;
+	RdSet<int32_t> client_set;
+	RdSignal<int32_t> server_signal;
+	RdSignal<int32_t> client_signal;
+
+	Loopback(std::string const& name, uint32_t server_offer, uint32_t client_offer)
+		: server_scheduler(def.lifetime, name + "ServerScheduler"), client_scheduler(def.lifetime, name + "ClientScheduler")
+	{
+		server_wire = std::make_shared<SocketWire::Server>(def.lifetime, &server_scheduler, 0, name + "Server");
+		server_wire->set_offered_capabilities(server_offer);
+		client_wire = std::make_shared<SocketWire::Client>(def.lifetime, &client_scheduler, server_wire->port, name + "Client");
+		client_wire->set_offered_capabilities(client_offer);
+
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &server_scheduler, server_wire, def.lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &client_scheduler, client_wire, def.lifetime);
+		server_map.is_master = true;
+	}
+
+	~Loopback()
+	{
+		def.terminate();
+	}
+
+	/**
+	 * \brief Runs [action] as one action of [scheduler] and waits for its result.
+	 */
+	template <typename F>
+	static auto run(IScheduler& scheduler, F&& action) -> decltype(action())
+	{
+		std::packaged_task<decltype(action())()> task(std::forward<F>(action));
+		auto result = task.get_future();
+		scheduler.queue([&task] { task(); });
+		return result.get();
+	}
+
+	template <typename F>
+	static bool wait_until(F&& condition)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+
+	bool connect()
+	{
+		return wait_until([this] { return client_wire->connected.get() && server_wire->connected.get(); });
+	}
+
+	bool agree()
+	{
+		return wait_until([this] {
+			return server_wire->has_capability(IWire::Capability::CollectionBatches) &&
+				   client_wire->has_capability(IWire::Capability::CollectionBatches);
+		});
+	}
+
+	void bind_clients()
+	{
+		run(client_scheduler, [this] {
+			statics(client_map, 1).bind(def.lifetime, client_protocol.get(), "map");
+			statics(client_list, 2).bind(def.lifetime, client_protocol.get(), "list");
+			statics(client_set, 3).bind(def.lifetime, client_protocol.get(), "set");
+			statics(client_signal, 4).bind(def.lifetime, client_protocol.get(), "signal");
+		});
+	}
+
+	void bind_servers()
+	{
+		run(server_scheduler, [this] {
+			statics(server_map, 1).bind(def.lifetime, server_protocol.get(), "map");
+			statics(server_list, 2).bind(def.lifetime, server_protocol.get(), "list");
+			statics(server_set, 3).bind(def.lifetime, server_protocol.get(), "set");
+			statics(server_signal, 4).bind(def.lifetime, server_protocol.get(), "signal");
+		});
+	}
+
+	static uint64_t messages_to(WireBase const& wire, RdId const& id)
+	{
+		for (MessageBroker::EntityStats const& entry : wire.get_message_broker().get_stats())
+		{
+			if (entry.id == id)
+			{
+				return entry.messages;
+			}
+		}
+		return 0;
+	}
+};
+
+constexpr int32_t ENTRIES = 1000;
+
+void fill(RdMap<int32_t, int32_t> const& map)
+{
+	for (int32_t i = 0; i < ENTRIES; ++i)
+	{
+		map.set(i, i * 2);
+	}
+}
+}	 // namespace
+
+TEST(RdCollectionBatch, bindsMapInOneBatch)
+{
+	Loopback loopback("Snapshot", BATCHES, BATCHES);
+	ASSERT_TRUE(loopback.connect());
+	ASSERT_TRUE(loopback.agree());
+	loopback.bind_clients();
+
+	fill(loopback.server_map);
+	const uint64_t server_sent = loopback.server_wire->get_stats().sent_packages;
+	const uint64_t client_sent = loopback.client_wire->get_stats().sent_packages;
+	loopback.bind_servers();
+
+	ASSERT_TRUE(Loopback::wait_until(
+		[&] { return Loopback::run(loopback.client_scheduler, [&] { return loopback.client_map.size() == ENTRIES; }); }));
+	Loopback::run(loopback.client_scheduler, [&] {
+		for (int32_t i = 0; i < ENTRIES; ++i)
+		{
+			ASSERT_NE(nullptr, loopback.client_map.get(i));
+			EXPECT_EQ(i * 2, *loopback.client_map.get(i));
+		}
+	});
+
+	// every entry is acknowledged, the acknowledgements are batched too
+	const RdId map_id = loopback.server_map.get_id();
+	ASSERT_TRUE(Loopback::wait_until([&] { return Loopback::messages_to(*loopback.server_wire, map_id) == ENTRIES; }));
+	EXPECT_EQ(static_cast<uint64_t>(ENTRIES), Loopback::messages_to(*loopback.client_wire, map_id));
+	EXPECT_LT(loopback.server_wire->get_stats().sent_packages - server_sent, 10u);
+	EXPECT_LT(loopback.client_wire->get_stats().sent_packages - client_sent, 10u);
+}
+
+TEST(RdCollectionBatch, sendsEntriesOneByOneWithoutAgreement)
+{
+	Loopback loopback("OneSided", BATCHES, 0);
+	ASSERT_TRUE(loopback.connect());
+	loopback.bind_clients();
+
+	fill(loopback.server_map);
+	const uint64_t server_sent = loopback.server_wire->get_stats().sent_packages;
+	loopback.bind_servers();
+
+	ASSERT_TRUE(Loopback::wait_until(
+		[&] { return Loopback::run(loopback.client_scheduler, [&] { return loopback.client_map.size() == ENTRIES; }); }));
+	EXPECT_FALSE(loopback.server_wire->has_capability(IWire::Capability::CollectionBatches));
+	EXPECT_FALSE(loopback.client_wire->has_capability(IWire::Capability::CollectionBatches));
+	EXPECT_TRUE(Loopback::wait_until(
+		[&] { return loopback.server_wire->get_stats().sent_packages - server_sent >= static_cast<uint64_t>(ENTRIES); }));
+}
+
+TEST(RdCollectionBatch, keepsLastWriteOfKeysChangedInOneAction)
+{
+	Loopback loopback("LastWriter", BATCHES, BATCHES);
+	ASSERT_TRUE(loopback.connect());
+	ASSERT_TRUE(loopback.agree());
+	loopback.bind_clients();
+	loopback.bind_servers();
+
+	Loopback::run(loopback.server_scheduler, [&] {
+		for (int32_t round = 0; round < 100; ++round)
+		{
+			for (int32_t key = 0; key < 10; ++key)
+			{
+				loopback.server_map.set(key, round * 10 + key);
+			}
+		}
+		loopback.server_map.remove(9);
+	});
+
+	const std::vector<int32_t> expected = {990, 991, 992, 993, 994, 995, 996, 997, 998};
+	const auto client_values = [&] {
+		return Loopback::run(loopback.client_scheduler, [&] {
+			std::vector<int32_t> values;
+			for (int32_t key = 0; key < 10; ++key)
+			{
+				if (int32_t const* value = loopback.client_map.get(key))
+				{
+					values.push_back(*value);
+				}
+			}
+			return values;
+		});
+	};
+	ASSERT_TRUE(Loopback::wait_until([&] { return client_values() == expected; }));
+	EXPECT_EQ(10u, Loopback::messages_to(*loopback.client_wire, loopback.server_map.get_id()));
+
+	// the master accepts changes of a key only once its latest version is acknowledged
+	ASSERT_TRUE(Loopback::wait_until(
+		[&] { return Loopback::messages_to(*loopback.server_wire, loopback.server_map.get_id()) == 10u; }));
+	Loopback::run(loopback.client_scheduler, [&] { loopback.client_map.set(0, -1); });
+	EXPECT_TRUE(Loopback::wait_until([&] {
+		return Loopback::run(loopback.server_scheduler, [&] {
+			int32_t const* value = loopback.server_map.get(0);
+			return value != nullptr && *value == -1;
+		});
+	}));
+}
+
+TEST(RdCollectionBatch, keepsOrderWithOtherMessages)
+{
+	Loopback loopback("Ordered", BATCHES, BATCHES);
+	ASSERT_TRUE(loopback.connect());
+	ASSERT_TRUE(loopback.agree());
+	loopback.bind_clients();
+	loopback.bind_servers();
+
+	std::promise<std::pair<bool, bool>> seen;
+	Loopback::run(loopback.client_scheduler, [&] {
+		loopback.client_signal.advise(loopback.def.lifetime, [&](int32_t const&) {
+			seen.set_value({loopback.client_map.get(1) != nullptr, loopback.client_map.get(2) != nullptr});
+		});
+	});
+	Loopback::run(loopback.server_scheduler, [&] {
+		loopback.server_map.set(1, 1);
+		loopback.server_signal.fire(0);
+		loopback.server_map.set(2, 2);
+	});
+
+	auto future = seen.get_future();
+	ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(10)));
+	const std::pair<bool, bool> state = future.get();
+	EXPECT_TRUE(state.first);
+	EXPECT_FALSE(state.second);
+}
+
+TEST(RdCollectionBatch, batchesListAndSetChanges)
+{
+	Loopback loopback("ListSet", BATCHES, BATCHES);
+	ASSERT_TRUE(loopback.connect());
+	ASSERT_TRUE(loopback.agree());
+	loopback.bind_clients();
+	loopback.bind_servers();
+
+	Loopback::run(loopback.server_scheduler, [&] {
+		for (int32_t i = 0; i < 100; ++i)
+		{
+			loopback.server_list.add(i);
+		}
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			loopback.server_list.removeAt(0);
+		}
+		loopback.server_list.set(5, -5);
+		loopback.server_list.add(0, -1);
+
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			loopback.server_set.add(i);
+		}
+		loopback.server_set.remove(3);
+		loopback.server_set.add(3);
+		loopback.server_set.remove(4);
+	});
+
+	const auto to_vector = [](RdList<int32_t> const& list) {
+		std::vector<int32_t> result;
+		for (auto const& value : list.getList())
+		{
+			result.push_back(wrapper::get<int32_t>(value));
+		}
+		return result;
+	};
+	const std::vector<int32_t> expected_list =
+		Loopback::run(loopback.server_scheduler, [&] { return to_vector(loopback.server_list); });
+	ASSERT_TRUE(Loopback::wait_until(
+		[&] { return Loopback::run(loopback.client_scheduler, [&] { return to_vector(loopback.client_list); }) == expected_list; }));
+
+	ASSERT_TRUE(Loopback::wait_until(
+		[&] { return Loopback::messages_to(*loopback.client_wire, loopback.server_set.get_id()) == 10u; }));
+	Loopback::run(loopback.client_scheduler, [&] {
+		EXPECT_EQ(9u, loopback.client_set.size());
+		EXPECT_TRUE(loopback.client_set.contains(3));
+		EXPECT_FALSE(loopback.client_set.contains(4));
+	});
+	// list changes shift indices, none of them is dropped
+	EXPECT_EQ(112u, Loopback::messages_to(*loopback.client_wire, loopback.server_list.get_id()));
+}
+
+namespace
+{
+/**
+ * \brief Changes [key] on the master and holds the client scheduler until the change is queued on it, so whatever
+ * the client sends about [key] from there on is batched together with the acknowledgement of the change.
+ */
+void hold_until_master_change_queued(Loopback& loopback, int32_t key, std::function<void()> before_ack)
+{
+	const RdId map_id = loopback.server_map.get_id();
+	const uint64_t received = Loopback::messages_to(*loopback.client_wire, map_id);
+	Loopback::run(loopback.client_scheduler, [&] {
+		Loopback::run(loopback.server_scheduler, [&] { loopback.server_map.set(key, 1); });
+		ASSERT_TRUE(Loopback::wait_until([&] {
+			return Loopback::messages_to(*loopback.client_wire, map_id) > received &&
+				   loopback.client_scheduler.get_stats().queue_depth > 0;
+		}));
+		before_ack();
+	});
+}
+}	 // namespace
+
+TEST(RdCollectionBatch, sendsPutBatchedBeforeAcknowledgement)
+{
+	Loopback loopback("PutThenAck", BATCHES, BATCHES);
+	ASSERT_TRUE(loopback.connect());
+	ASSERT_TRUE(loopback.agree());
+	loopback.bind_clients();
+	loopback.bind_servers();
+
+	const RdId map_id = loopback.server_map.get_id();
+	const uint64_t received = Loopback::messages_to(*loopback.server_wire, map_id);
+	hold_until_master_change_queued(loopback, 7, [&] { loopback.client_map.set(7, -1); });
+
+	// the put is rejected since the master's change of the key is pending, but it's sent along with the acknowledgement
+	ASSERT_TRUE(Loopback::wait_until([&] { return Loopback::messages_to(*loopback.server_wire, map_id) == received + 2; }));
+	const auto value_of = [&](IScheduler& scheduler, RdMap<int32_t, int32_t> const& map) {
+		return Loopback::run(scheduler, [&] {
+			int32_t const* value = map.get(7);
+			return value ? *value : 0;
+		});
+	};
+	EXPECT_EQ(1, value_of(loopback.server_scheduler, loopback.server_map));
+	EXPECT_EQ(1, value_of(loopback.client_scheduler, loopback.client_map));
+}
+
+TEST(RdCollectionBatch, sendsAcknowledgementBatchedBeforePut)
+{
+	Loopback loopback("AckThenPut", BATCHES, BATCHES);
+	ASSERT_TRUE(loopback.connect());
+	ASSERT_TRUE(loopback.agree());
+	loopback.bind_clients();
+	loopback.bind_servers();
+
+	// queued behind the master's change, so it's applied and acknowledged first
+	hold_until_master_change_queued(
+		loopback, 7, [&] { loopback.client_scheduler.queue([&] { loopback.client_map.set(7, -1); }); });
+
+	// with the acknowledgement delivered, the master accepts the put
+	EXPECT_TRUE(Loopback::wait_until([&] {
+		return Loopback::run(loopback.server_scheduler, [&] {
+			int32_t const* value = loopback.server_map.get(7);
+			return value != nullptr && *value == -1;
+		});
+	}));
+	EXPECT_EQ(2u, Loopback::messages_to(*loopback.server_wire, loopback.server_map.get_id()));
+}
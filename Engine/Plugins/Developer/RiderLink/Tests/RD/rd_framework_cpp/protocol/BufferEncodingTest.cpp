@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include "protocol/Buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+constexpr Buffer::Encoding ENCODINGS[] = {Buffer::Encoding::Fixed, Buffer::Encoding::Compact};
+
+/**
+ * \brief Random string of ASCII, 2-byte, 3-byte, lone surrogate and astral characters. The fixed encoding writes
+ * wchar_t as UTF-16 code units, so astral characters only round-trip there as surrogate pairs.
+ */
+std::wstring random_string(std::mt19937& rng, Buffer::Encoding encoding)
+{
+	const bool astral_pairs = sizeof(wchar_t) == 2 || encoding == Buffer::Encoding::Fixed;
+	std::wstring result;
+	const uint32_t length = rng() % 32;
+	for (uint32_t i = 0; i < length; ++i)
+	{
+		uint32_t c = 0;
+		switch (rng() % 5)
+		{
+			case 0:
+				c = rng() % 0x80;
+				break;
+			case 1:
+				c = rng() % 0x800;
+				break;
+			case 2:
+				c = rng() % 0x10000;
+				break;
+			case 3:
+				c = 0xD800 + rng() % 0x800;
+				break;
+			default:
+				c = 0x10000 + rng() % 0x100000;
+				break;
+		}
+		if (astral_pairs && c >= 0x10000)
+		{
+			c -= 0x10000;
+			result.push_back(static_cast<wchar_t>(0xD800 + (c >> 10)));
+			result.push_back(static_cast<wchar_t>(0xDC00 + (c & 0x3FF)));
+		}
+		else
+		{
+			result.push_back(static_cast<wchar_t>(c));
+		}
+	}
+	return result;
+}
+}	 // namespace
+
+TEST(BufferEncoding, fuzzRoundTrip)
+{
+	std::mt19937 rng(20261016);
+	for (int32_t iteration = 0; iteration < 20000; ++iteration)
+	{
+		for (Buffer::Encoding encoding : ENCODINGS)
+		{
+			const int64_t v64 = static_cast<int64_t>((static_cast<uint64_t>(rng()) << 32) | rng()) >> (rng() % 64);
+			const int32_t v32 = static_cast<int32_t>(rng()) * (rng() % 2 == 0 ? 1 : -1);
+			const uint16_t v16 = static_cast<uint16_t>(rng());
+			const std::wstring text = random_string(rng, encoding);
+			std::vector<uint16_t> units(rng() % 32);
+			std::generate(units.begin(), units.end(), [&] { return static_cast<uint16_t>(rng()); });
+			const std::vector<int32_t> array(rng() % 8, static_cast<int32_t>(rng()));
+
+			Buffer buffer;
+			buffer.set_encoding(encoding);
+			buffer.write_varint(v64);
+			buffer.write_varint(v32);
+			buffer.write_varint(v16);
+			buffer.write_wstring(text);
+			buffer.write_char16_string(units.data(), units.size());
+			buffer.write_array<std::vector, int32_t>(array);
+			buffer.rewind();
+
+			ASSERT_EQ(v64, buffer.read_varint<int64_t>());
+			ASSERT_EQ(v32, buffer.read_varint<int32_t>());
+			ASSERT_EQ(v16, buffer.read_varint<uint16_t>());
+			ASSERT_EQ(text, buffer.read_wstring());
+			uint16_t* read_units = buffer.read_char16_string();
+			ASSERT_TRUE(std::equal(units.begin(), units.end(), read_units));
+			ASSERT_EQ(0, read_units[units.size()]);
+			delete[] read_units;
+			ASSERT_EQ(array, (buffer.read_array<std::vector, int32_t>()));
+		}
+	}
+}
+
+TEST(BufferEncoding, varintBoundaries)
+{
+	const int64_t values[] = {0, 1, -1, 63, -64, 64, -65, 8191, -8192, 8192, std::numeric_limits<int64_t>::max(),
+		std::numeric_limits<int64_t>::min()};
+	Buffer buffer;
+	for (int64_t value : values)
+	{
+		buffer.write_varint(value);
+	}
+	buffer.rewind();
+	for (int64_t value : values)
+	{
+		EXPECT_EQ(value, buffer.read_varint<int64_t>());
+	}
+}
+
+TEST(BufferEncoding, fixedKeepsWireFormat)
+{
+	Buffer buffer;
+	buffer.write_wstring(std::wstring(L"ab"));
+	ASSERT_EQ(sizeof(int32_t) + 2 * sizeof(uint16_t), buffer.get_position());
+	buffer.rewind();
+	EXPECT_EQ(2, buffer.read_integral<int32_t>());
+	EXPECT_EQ(u'a', buffer.read_integral<uint16_t>());
+	EXPECT_EQ(u'b', buffer.read_integral<uint16_t>());
+}
+
+TEST(BufferEncoding, compactShrinksAsciiStrings)
+{
+	const std::wstring path(L"/Game/Blueprints/BP_Character.BP_Character_C");
+	Buffer fixed;
+	fixed.write_wstring(path);
+	Buffer compact;
+	compact.set_encoding(Buffer::Encoding::Compact);
+	compact.write_wstring(path);
+	EXPECT_EQ(1 + path.size(), compact.get_position());
+	EXPECT_LT(compact.get_position() * 2, fixed.get_position() + 2);
+}
+
+TEST(BufferEncoding, malformedUtf8DecodesToReplacement)
+{
+	Buffer buffer;
+	buffer.set_encoding(Buffer::Encoding::Compact);
+	buffer.write_varint<int32_t>(3);
+	buffer.write_integral<uint8_t>(0xC3);	 // lead byte followed by a non-continuation byte
+	buffer.write_integral<uint8_t>(0x28);
+	buffer.write_integral<uint8_t>(0xFF);	 // never valid in UTF-8
+	buffer.rewind();
+
+	const std::wstring decoded = buffer.read_wstring();
+	ASSERT_EQ(3u, decoded.size());
+	EXPECT_EQ(0xFFFDu, static_cast<uint32_t>(decoded[0]));
+	EXPECT_EQ(static_cast<wchar_t>('('), decoded[1]);
+	EXPECT_EQ(0xFFFDu, static_cast<uint32_t>(decoded[2]));
+}
+
+TEST(BufferEncoding, fuzzMalformedInputNeverOverreads)
+{
+	std::mt19937 rng(7);
+	for (int32_t iteration = 0; iteration < 20000; ++iteration)
+	{
+		const uint32_t length = rng() % 16;
+		Buffer buffer;
+		buffer.set_encoding(Buffer::Encoding::Compact);
+		buffer.write_varint<int32_t>(static_cast<int32_t>(length));
+		for (uint32_t i = 0; i < length; ++i)
+		{
+			buffer.write_integral<uint8_t>(static_cast<uint8_t>(rng()));
+		}
+		const size_t written = buffer.get_position();
+		buffer.rewind();
+		const std::wstring decoded = buffer.read_wstring();
+		EXPECT_EQ(written, buffer.get_position());
+		EXPECT_LE(decoded.size(), length);
+	}
+}
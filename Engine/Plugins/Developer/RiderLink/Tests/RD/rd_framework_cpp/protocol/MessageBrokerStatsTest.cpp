@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SimpleScheduler.h"
+#include "wire/SocketWire.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using payload_t = std::vector<uint8_t>;
+
+/**
+ * \brief Server and client wires connected over loopback with two client to server signals. The server ends
+ * of the signals are bound within [server_signals_def], so they can be unadvised while the connection stays up.
+ * Names are qualified the way generated models' locations are.
+ */
+class Loopback
+{
+public:
+	LifetimeDefinition def;
+	SimpleScheduler scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<SocketWire::Client> client_wire;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	LifetimeDefinition server_signals_def{def.lifetime};
+	RdSignal<payload_t> big_server;
+	RdSignal<payload_t> big_client;
+	RdSignal<payload_t> small_server;
+	RdSignal<payload_t> small_client;
+
+	std::mutex lock;
+	std::condition_variable cv;
+	size_t received = 0;
+
+	explicit Loopback(std::string const& name)
+	{
+		server_wire = std::make_shared<SocketWire::Server>(def.lifetime, &scheduler, 0, name + "Server");
+		client_wire = std::make_shared<SocketWire::Client>(def.lifetime, &scheduler, server_wire->port, name + "Client");
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &scheduler, server_wire, def.lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &scheduler, client_wire, def.lifetime);
+
+		statics(big_server, 1).bind(server_signals_def.lifetime, server_protocol.get(), "Model::Logs.big");
+		statics(big_client, 1).bind(def.lifetime, client_protocol.get(), "Model::Logs.big");
+		statics(small_server, 2).bind(server_signals_def.lifetime, server_protocol.get(), "Model::Logs.small");
+		statics(small_client, 2).bind(def.lifetime, client_protocol.get(), "Model::Logs.small");
+		big_server.advise(server_signals_def.lifetime, [this](payload_t const&) { record(); });
+		small_server.advise(server_signals_def.lifetime, [this](payload_t const&) { record(); });
+	}
+
+	~Loopback()
+	{
+		def.terminate();
+	}
+
+	void record()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		++received;
+		cv.notify_all();
+	}
+
+	bool wait(size_t count)
+	{
+		std::unique_lock<std::mutex> ul(lock);
+		return cv.wait_for(ul, std::chrono::seconds(10), [&] { return received >= count; });
+	}
+
+	template <typename F>
+	static bool wait_until(F&& condition)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+
+	MessageBroker::EntityStats stats_of(RdId const& id) const
+	{
+		std::vector<MessageBroker::EntityStats> stats = server_wire->get_message_broker().get_stats();
+		auto it = std::find_if(stats.begin(), stats.end(), [&](MessageBroker::EntityStats const& entry) { return entry.id == id; });
+		return it != stats.end() ? *it : MessageBroker::EntityStats{};
+	}
+};
+
+constexpr size_t BIG_COUNT = 20;
+constexpr size_t SMALL_COUNT = 50;
+const payload_t BIG(4096, 0xB1);
+const payload_t SMALL(16, 0x51);
+
+void fire_all(Loopback& loopback)
+{
+	for (size_t i = 0; i < BIG_COUNT; ++i)
+	{
+		loopback.big_client.fire(BIG);
+	}
+	for (size_t i = 0; i < SMALL_COUNT; ++i)
+	{
+		loopback.small_client.fire(SMALL);
+	}
+}
+}	 // namespace
+
+TEST(MessageBrokerStats, countsMessagesAndBytesPerEntity)
+{
+	Loopback loopback("Counted");
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	fire_all(loopback);
+	ASSERT_TRUE(loopback.wait(BIG_COUNT + SMALL_COUNT));
+
+	const MessageBroker::EntityStats big = loopback.stats_of(loopback.big_server.get_id());
+	const MessageBroker::EntityStats small = loopback.stats_of(loopback.small_server.get_id());
+	EXPECT_EQ(BIG_COUNT, big.messages);
+	EXPECT_EQ(SMALL_COUNT, small.messages);
+	EXPECT_GE(big.bytes, BIG_COUNT * BIG.size());
+	EXPECT_GE(small.bytes, SMALL_COUNT * SMALL.size());
+	// every message of one signal has the same size
+	EXPECT_EQ(0u, big.bytes % BIG_COUNT);
+	EXPECT_EQ(0u, small.bytes % SMALL_COUNT);
+	EXPECT_EQ(to_string(loopback.big_server.get_location()), big.location);
+
+	EXPECT_GE(loopback.server_wire->get_stats().received_messages, BIG_COUNT + SMALL_COUNT);
+}
+
+TEST(MessageBrokerStats, keepsTotalsOfUnadvisedEntities)
+{
+	Loopback loopback("Retired");
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	fire_all(loopback);
+	ASSERT_TRUE(loopback.wait(BIG_COUNT + SMALL_COUNT));
+	const RdId big_id = loopback.big_server.get_id();
+	const MessageBroker::EntityStats before = loopback.stats_of(big_id);
+
+	loopback.server_signals_def.terminate();
+	const MessageBroker::EntityStats retired = loopback.stats_of(big_id);
+	EXPECT_EQ(before.messages, retired.messages);
+	EXPECT_EQ(before.bytes, retired.bytes);
+	EXPECT_EQ(before.location, retired.location);
+
+	// nothing is advised for the id anymore, these go to the unadvised entry
+	loopback.big_client.fire(BIG);
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.stats_of(RdId::Null()).messages == 1; }));
+	EXPECT_EQ("<unadvised>", loopback.stats_of(RdId::Null()).location);
+	EXPECT_EQ(before.messages, loopback.stats_of(big_id).messages);
+}
+
+TEST(MessageBrokerStats, sumsRetiredEntitiesPerLocation)
+{
+	Loopback loopback("Recreated");
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	// entities recreated under new ids at the same location, like the items of a collection
+	constexpr int32_t GENERATIONS = 40;
+	for (int32_t i = 0; i < GENERATIONS; ++i)
+	{
+		LifetimeDefinition generation_def(loopback.def.lifetime);
+		RdSignal<payload_t> server;
+		RdSignal<payload_t> client;
+		statics(server, 100 + i).bind(generation_def.lifetime, loopback.server_protocol.get(), "Model::Logs.item");
+		statics(client, 100 + i).bind(generation_def.lifetime, loopback.client_protocol.get(), "Model::Logs.item");
+		server.advise(generation_def.lifetime, [&loopback](payload_t const&) { loopback.record(); });
+
+		client.fire(SMALL);
+		ASSERT_TRUE(loopback.wait(static_cast<size_t>(i) + 1));
+		generation_def.terminate();
+	}
+
+	std::vector<MessageBroker::EntityStats> stats = loopback.server_wire->get_message_broker().get_stats();
+	const auto count = std::count_if(
+		stats.begin(), stats.end(), [](MessageBroker::EntityStats const& entry) { return entry.location == "Model::Logs.item"; });
+	ASSERT_EQ(1, count);
+	auto it = std::find_if(
+		stats.begin(), stats.end(), [](MessageBroker::EntityStats const& entry) { return entry.location == "Model::Logs.item"; });
+	EXPECT_EQ(static_cast<uint64_t>(GENERATIONS), it->messages);
+	EXPECT_EQ(0u, it->bytes % GENERATIONS);
+}
+
+TEST(MessageBrokerStats, dumpsFoldedStacksHeaviestFirst)
+{
+	Loopback loopback("Dumped");
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	fire_all(loopback);
+	ASSERT_TRUE(loopback.wait(BIG_COUNT + SMALL_COUNT));
+	const MessageBroker::EntityStats big = loopback.stats_of(loopback.big_server.get_id());
+	const MessageBroker::EntityStats small = loopback.stats_of(loopback.small_server.get_id());
+
+	std::vector<std::string> lines;
+	std::istringstream dump(loopback.server_wire->get_message_broker().dump_stats());
+	for (std::string line; std::getline(dump, line);)
+	{
+		lines.push_back(line);
+	}
+	ASSERT_EQ(2u, lines.size());
+
+	// location split into frames at "::" and ".", then the bytes received
+	EXPECT_EQ("Model;Logs;big " + std::to_string(big.bytes), lines[0]);
+	EXPECT_EQ("Model;Logs;small " + std::to_string(small.bytes), lines[1]);
+}
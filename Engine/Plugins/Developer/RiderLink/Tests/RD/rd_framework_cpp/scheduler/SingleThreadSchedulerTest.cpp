@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "scheduler/SingleThreadScheduler.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+
+using namespace rd;
+
+TEST(SingleThreadScheduler, runsQueuedTasksInOrder)
+{
+	LifetimeDefinition def;
+	SingleThreadScheduler scheduler(def.lifetime, "runsQueuedTasksInOrder");
+
+	std::vector<int32_t> order;
+	for (int32_t i = 0; i < 1000; ++i)
+	{
+		scheduler.queue([&order, i] { order.push_back(i); });
+	}
+	scheduler.flush();
+
+	ASSERT_EQ(1000u, order.size());
+	for (int32_t i = 0; i < 1000; ++i)
+	{
+		EXPECT_EQ(i, order[i]);
+	}
+	EXPECT_EQ(1000u, scheduler.get_stats().tasks_executed);
+}
+
+TEST(SingleThreadScheduler, stopFromOwnTaskDefersJoin)
+{
+	auto def = std::make_unique<LifetimeDefinition>();
+	auto scheduler = std::make_unique<SingleThreadScheduler>(def->lifetime, "stopFromOwnTaskDefersJoin");
+
+	std::atomic<int32_t> executed{0};
+	std::promise<void> second_queued;
+	std::shared_future<void> gate = second_queued.get_future().share();
+	// Terminating the lifetime stops the scheduler from its own thread, the tasks queued before still run.
+	scheduler->queue([&def, &executed, gate] {
+		gate.wait();
+		def->terminate();
+		++executed;
+	});
+	scheduler->queue([&executed] { ++executed; });
+	second_queued.set_value();
+	scheduler->flush();
+	EXPECT_EQ(2, executed.load());
+
+	scheduler->queue([&executed] { ++executed; });
+	EXPECT_EQ(2, executed.load());
+
+	// The destructor runs on this thread and joins the stopped scheduler thread.
+	scheduler.reset();
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "serialization/ArraySerializer.h"
+#include "serialization/Polymorphic.h"
+#include "serialization/SerializationCtx.h"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+constexpr Buffer::Encoding ENCODINGS[] = {Buffer::Encoding::Fixed, Buffer::Encoding::Compact};
+
+using Int32Array = ArraySerializer<Polymorphic<int32_t>, std::vector>;
+using DoubleArray = ArraySerializer<Polymorphic<double>, std::vector>;
+using BoolArray = ArraySerializer<Polymorphic<bool>, std::vector>;
+
+static_assert(util::is_raw_serializer_v<Polymorphic<int32_t>, int32_t>, "integrals are copied in bulk");
+static_assert(util::is_raw_serializer_v<Polymorphic<double>, double>, "floating point is copied in bulk");
+static_assert(!util::is_raw_serializer_v<Polymorphic<bool>, bool>, "bool has a serializer of its own");
+static_assert(!util::is_raw_serializer_v<Polymorphic<std::wstring>, std::wstring>, "strings aren't raw bytes");
+
+std::vector<int32_t> iota_array(size_t size)
+{
+	std::vector<int32_t> result(size);
+	std::iota(result.begin(), result.end(), -static_cast<int32_t>(size / 2));
+	return result;
+}
+
+/**
+ * \brief The first [size] bytes written to [buffer], as a buffer to read them from.
+ */
+Buffer readable_prefix(Buffer const& buffer, size_t size, Buffer::Encoding encoding)
+{
+	Buffer result(Buffer::ByteArray(buffer.data(), buffer.data() + size));
+	result.set_encoding(encoding);
+	return result;
+}
+}	 // namespace
+
+TEST(ArraySerializer, roundTripsEmptyAndLargeArrays)
+{
+	SerializationCtx ctx(nullptr);
+	// a million elements need a 3 byte compact length
+	for (size_t size : {size_t(0), size_t(1), size_t(127), size_t(1) << 20})
+	{
+		for (Buffer::Encoding encoding : ENCODINGS)
+		{
+			const std::vector<int32_t> ints = iota_array(size);
+			const std::vector<double> doubles(ints.begin(), ints.end());
+
+			Buffer buffer;
+			buffer.set_encoding(encoding);
+			Int32Array::write(ctx, buffer, ints);
+			DoubleArray::write(ctx, buffer, doubles);
+			const size_t written = buffer.get_position();
+			buffer.rewind();
+
+			EXPECT_EQ(ints, Int32Array::read(ctx, buffer));
+			EXPECT_EQ(doubles, DoubleArray::read(ctx, buffer));
+			EXPECT_EQ(written, buffer.get_position());
+		}
+	}
+}
+
+TEST(ArraySerializer, bulkCopyKeepsWireFormat)
+{
+	SerializationCtx ctx(nullptr);
+	const std::vector<int32_t> ints = iota_array(1000);
+	for (Buffer::Encoding encoding : ENCODINGS)
+	{
+		Buffer bulk;
+		bulk.set_encoding(encoding);
+		Int32Array::write(ctx, bulk, ints);
+
+		Buffer elementwise;
+		elementwise.set_encoding(encoding);
+		elementwise.write_array<std::vector, int32_t>(ints, [&](int32_t const& value) { elementwise.write_integral(value); });
+
+		ASSERT_EQ(elementwise.get_position(), bulk.get_position());
+		EXPECT_TRUE(std::equal(bulk.data(), bulk.data() + bulk.get_position(), elementwise.data()));
+
+		elementwise.rewind();
+		EXPECT_EQ(ints, Int32Array::read(ctx, elementwise));
+	}
+}
+
+TEST(ArraySerializer, roundTripsElementwiseArrays)
+{
+	SerializationCtx ctx(nullptr);
+	const std::vector<bool> bools = {true, false, false, true};
+	for (Buffer::Encoding encoding : ENCODINGS)
+	{
+		Buffer buffer;
+		buffer.set_encoding(encoding);
+		BoolArray::write(ctx, buffer, {});
+		BoolArray::write(ctx, buffer, bools);
+		buffer.rewind();
+
+		EXPECT_TRUE(BoolArray::read(ctx, buffer).empty());
+		EXPECT_EQ(bools, BoolArray::read(ctx, buffer));
+	}
+}
+
+TEST(ArraySerializer, truncatedBufferThrows)
+{
+	SerializationCtx ctx(nullptr);
+	const std::vector<int32_t> ints = iota_array(100);
+	for (Buffer::Encoding encoding : ENCODINGS)
+	{
+		Buffer buffer;
+		buffer.set_encoding(encoding);
+		Int32Array::write(ctx, buffer, ints);
+
+		for (size_t missing : {size_t(1), sizeof(int32_t), sizeof(int32_t) * ints.size()})
+		{
+			Buffer truncated = readable_prefix(buffer, buffer.get_position() - missing, encoding);
+			EXPECT_THROW(Int32Array::read(ctx, truncated), std::out_of_range);
+		}
+	}
+}
+
+TEST(ArraySerializer, maxLengthThrowsBeforeAllocating)
+{
+	SerializationCtx ctx(nullptr);
+	for (Buffer::Encoding encoding : ENCODINGS)
+	{
+		// a length header of the largest array, followed by a single element
+		Buffer buffer;
+		buffer.set_encoding(encoding);
+		if (encoding == Buffer::Encoding::Fixed)
+		{
+			buffer.write_integral(std::numeric_limits<int32_t>::max());
+		}
+		else
+		{
+			buffer.write_varint(std::numeric_limits<int32_t>::max());
+		}
+		buffer.write_integral<int32_t>(42);
+
+		Buffer header = readable_prefix(buffer, buffer.get_position(), encoding);
+		EXPECT_THROW(Int32Array::read(ctx, header), std::out_of_range);
+	}
+}
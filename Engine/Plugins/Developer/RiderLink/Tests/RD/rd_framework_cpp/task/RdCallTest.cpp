@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SimpleScheduler.h"
+#include "task/RdCall.h"
+#include "task/RdEndpoint.h"
+#include "wire/SocketWire.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Server and client wires connected over loopback, with an endpoint on the server and a call on the client.
+ * The call is bound within [call_def], so it can be unbound while the connection stays up.
+ */
+class Loopback
+{
+public:
+	LifetimeDefinition def;
+	SimpleScheduler scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<SocketWire::Client> client_wire;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	LifetimeDefinition call_def{def.lifetime};
+	RdEndpoint<int32_t, int32_t> endpoint;
+	RdCall<int32_t, int32_t> call;
+
+	explicit Loopback(std::string const& name)
+	{
+		server_wire = std::make_shared<SocketWire::Server>(def.lifetime, &scheduler, 0, name + "Server");
+		client_wire = std::make_shared<SocketWire::Client>(def.lifetime, &scheduler, server_wire->port, name + "Client");
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &scheduler, server_wire, def.lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &scheduler, client_wire, def.lifetime);
+	}
+
+	~Loopback()
+	{
+		def.terminate();
+	}
+
+	void bind()
+	{
+		statics(endpoint, 1).bind(def.lifetime, server_protocol.get(), "Model::call");
+		statics(call, 1).bind(call_def.lifetime, client_protocol.get(), "Model::call");
+	}
+
+	template <typename F>
+	static bool wait_until(F&& condition)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	bool connect()
+	{
+		return wait_until([this] { return client_wire->connected.get(); });
+	}
+
+	MessageBroker::EntityStats client_stats_of(RdId const& id) const
+	{
+		std::vector<MessageBroker::EntityStats> stats = client_wire->get_message_broker().get_stats();
+		auto it = std::find_if(stats.begin(), stats.end(), [&](MessageBroker::EntityStats const& entry) { return entry.id == id; });
+		return it != stats.end() ? *it : MessageBroker::EntityStats{};
+	}
+};
+
+/**
+ * \brief Requests a handler hasn't answered yet, completed by the test.
+ */
+class HeldRequests
+{
+	std::mutex lock;
+	std::vector<std::pair<int32_t, RdTask<int32_t>>> requests;
+
+public:
+	RdTask<int32_t> hold(int32_t request)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		requests.emplace_back(request, RdTask<int32_t>());
+		return requests.back().second;
+	}
+
+	size_t size()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return requests.size();
+	}
+
+	std::pair<int32_t, RdTask<int32_t>> at(size_t index)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return requests.at(index);
+	}
+};
+}	 // namespace
+
+TEST(RdCall, respondsToRequests)
+{
+	Loopback loopback("Sync");
+	loopback.endpoint.set([](int32_t const& request) { return request + 1; });
+	loopback.bind();
+	ASSERT_TRUE(loopback.connect());
+
+	constexpr int32_t CALLS = 100;
+	for (int32_t i = 0; i < CALLS; ++i)
+	{
+		WiredRdTask<int32_t> task = loopback.call.sync(i, std::chrono::seconds(10));
+		ASSERT_TRUE(task.is_succeeded());
+		EXPECT_EQ(i + 1, task.value_or_throw().unwrap());
+	}
+
+	// responses are accounted to the call, none of them arrived after its task was gone
+	EXPECT_EQ(static_cast<uint64_t>(CALLS), loopback.client_stats_of(loopback.call.get_id()).messages);
+	EXPECT_EQ(0u, loopback.client_stats_of(RdId::Null()).messages);
+}
+
+TEST(RdCall, completesWhenHandlerAnswersLater)
+{
+	Loopback loopback("Async");
+	HeldRequests held;
+	loopback.endpoint.set([&](Lifetime, int32_t const& request) { return held.hold(request); });
+	loopback.bind();
+	ASSERT_TRUE(loopback.connect());
+
+	std::vector<WiredRdTask<int32_t>> tasks;
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		tasks.push_back(loopback.call.start(i, &loopback.scheduler));
+	}
+	ASSERT_TRUE(Loopback::wait_until([&] { return held.size() == 3; }));
+	for (WiredRdTask<int32_t> const& task : tasks)
+	{
+		EXPECT_FALSE(task.has_value());
+	}
+
+	// answered in reverse order
+	for (size_t i = 3; i-- > 0;)
+	{
+		auto request = held.at(i);
+		request.second.set(request.first * 10);
+	}
+	ASSERT_TRUE(Loopback::wait_until([&] {
+		return std::all_of(tasks.begin(), tasks.end(), [](WiredRdTask<int32_t> const& task) { return task.has_value(); });
+	}));
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(i * 10, tasks[i].value_or_throw().unwrap());
+	}
+}
+
+TEST(RdCall, chainsOnResponse)
+{
+	Loopback loopback("Chained");
+	loopback.endpoint.set([](int32_t const& request) { return request + 1; });
+	loopback.bind();
+	ASSERT_TRUE(loopback.connect());
+
+	WiredRdTask<int32_t> task = loopback.call.start(1, &loopback.scheduler);
+	RdTask<std::wstring> chained = task.then([](int32_t const& value) { return std::to_wstring(value * 2); });
+	ASSERT_TRUE(Loopback::wait_until([&] { return chained.has_value(); }));
+	EXPECT_EQ(L"4", chained.value_or_throw().unwrap());
+}
+
+TEST(RdCall, faultsWhenHandlerThrows)
+{
+	Loopback loopback("Faulted");
+	loopback.endpoint.set([](int32_t const&) -> int32_t { throw std::runtime_error("handler failed"); });
+	loopback.bind();
+	ASSERT_TRUE(loopback.connect());
+
+	WiredRdTask<int32_t> task = loopback.call.start(1, &loopback.scheduler);
+	ASSERT_TRUE(Loopback::wait_until([&] { return task.has_value(); }));
+	EXPECT_TRUE(task.is_faulted());
+}
+
+TEST(RdCall, cancelledWithLifetimeDropsLateResponse)
+{
+	Loopback loopback("Cancelled");
+	HeldRequests held;
+	loopback.endpoint.set([&](Lifetime, int32_t const& request) { return held.hold(request); });
+	loopback.bind();
+	ASSERT_TRUE(loopback.connect());
+
+	LifetimeDefinition request_def;
+	WiredRdTask<int32_t> task = loopback.call.start(request_def.lifetime, 1, &loopback.scheduler);
+	ASSERT_TRUE(Loopback::wait_until([&] { return held.size() == 1; }));
+
+	request_def.terminate();
+	EXPECT_TRUE(task.is_canceled());
+
+	// the response isn't subscribed to anymore
+	held.at(0).second.set(10);
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_stats_of(RdId::Null()).messages == 1; }));
+	EXPECT_TRUE(task.is_canceled());
+}
+
+TEST(RdCall, unbindingCancelsPendingTasks)
+{
+	Loopback loopback("Unbound");
+	HeldRequests held;
+	loopback.endpoint.set([&](Lifetime, int32_t const& request) { return held.hold(request); });
+	loopback.bind();
+	ASSERT_TRUE(loopback.connect());
+
+	WiredRdTask<int32_t> task = loopback.call.start(1, &loopback.scheduler);
+	ASSERT_TRUE(Loopback::wait_until([&] { return held.size() == 1; }));
+
+	loopback.call_def.terminate();
+	EXPECT_TRUE(task.is_canceled());
+}
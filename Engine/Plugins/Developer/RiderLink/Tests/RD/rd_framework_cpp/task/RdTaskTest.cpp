@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "lifetime/LifetimeDefinition.h"
+#include "task/RdTask.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+TEST(RdTask, handlersRunOnceCompleted)
+{
+	RdTask<int32_t> task;
+	LifetimeDefinition def;
+	std::vector<int32_t> log;
+
+	task.advise(def.lifetime, [&](RdTaskResult<int32_t> const& result) { log.push_back(result.unwrap()); });
+	EXPECT_TRUE(log.empty());
+	task.set(1);
+	EXPECT_EQ((std::vector<int32_t>{1}), log);
+
+	// complete already, runs right away
+	task.advise(def.lifetime, [&](RdTaskResult<int32_t> const& result) { log.push_back(result.unwrap() * 10); });
+	EXPECT_EQ((std::vector<int32_t>{1, 10}), log);
+}
+
+TEST(RdTask, completesOnce)
+{
+	RdTask<int32_t> task;
+	int32_t calls = 0;
+	task.advise(Lifetime::Eternal(), [&](RdTaskResult<int32_t> const&) { ++calls; });
+
+	task.set(1);
+	task.set(2);
+	task.cancel();
+
+	EXPECT_EQ(1, calls);
+	EXPECT_TRUE(task.is_succeeded());
+	EXPECT_EQ(1, task.value_or_throw().unwrap());
+}
+
+TEST(RdTask, skipsHandlersOfTerminatedLifetimes)
+{
+	RdTask<int32_t> task;
+	LifetimeDefinition def;
+	int32_t calls = 0;
+	task.advise(def.lifetime, [&](RdTaskResult<int32_t> const&) { ++calls; });
+
+	def.terminate();
+	task.set(1);
+	EXPECT_EQ(0, calls);
+}
+
+TEST(RdTask, cancelledWithLifetime)
+{
+	LifetimeDefinition def;
+	RdTask<int32_t> task;
+	task.cancel_on(def.lifetime);
+	EXPECT_FALSE(task.has_value());
+
+	def.terminate();
+	EXPECT_TRUE(task.is_canceled());
+}
+
+TEST(RdTask, completionRemovesCancellation)
+{
+	LifetimeDefinition def;
+	RdTask<int32_t> task;
+	task.cancel_on(def.lifetime);
+
+	task.set(1);
+	def.terminate();
+	EXPECT_TRUE(task.is_succeeded());
+
+	// a terminated lifetime cancels right away
+	RdTask<int32_t> late;
+	late.cancel_on(def.lifetime);
+	EXPECT_TRUE(late.is_canceled());
+}
+
+TEST(RdTask, chainsContinuations)
+{
+	RdTask<int32_t> task;
+	RdTask<std::wstring> chained = task.then([](int32_t const& value) { return value * 2; })
+										.then([](int32_t const& value) { return std::to_wstring(value); });
+	EXPECT_FALSE(chained.has_value());
+
+	task.set(21);
+	ASSERT_TRUE(chained.is_succeeded());
+	EXPECT_EQ(L"42", chained.value_or_throw().unwrap());
+}
+
+TEST(RdTask, propagatesCancellationAndFaults)
+{
+	RdTask<int32_t> cancelled;
+	RdTask<int32_t> after_cancelled = cancelled.then([](int32_t const& value) { return value; });
+	cancelled.cancel();
+	EXPECT_TRUE(after_cancelled.is_canceled());
+
+	RdTask<int32_t> faulted;
+	RdTask<int32_t> after_faulted = faulted.then([](int32_t const& value) { return value; });
+	faulted.fault(std::runtime_error("remote failure"));
+	ASSERT_TRUE(after_faulted.is_faulted());
+	EXPECT_THROW(after_faulted.value_or_throw().unwrap(), std::runtime_error);
+
+	RdTask<int32_t> throwing;
+	RdTask<int32_t> after_throwing =
+		throwing.then([](int32_t const&) -> int32_t { throw std::runtime_error("continuation failure"); });
+	throwing.set(1);
+	EXPECT_TRUE(after_throwing.is_faulted());
+}
+
+TEST(RdTask, completesFromAnotherThread)
+{
+	RdTask<int32_t> task;
+	RdTask<int32_t> chained = task.then([](int32_t const& value) { return value + 1; });
+
+	std::thread completing([task] { task.set(1); });
+	completing.join();
+
+	ASSERT_TRUE(chained.is_succeeded());
+	EXPECT_EQ(2, chained.value_or_throw().unwrap());
+}
+
+TEST(RdTask, reusesReleasedStates)
+{
+	using state_t = detail::RdTaskImpl<int32_t>;
+
+	state_t const* released = nullptr;
+	{
+		util::intrusive_ptr<state_t> state = state_t::create();
+		state->set_if_empty(RdTaskResult<int32_t>::Success(1));
+		released = state.get();
+	}
+	util::intrusive_ptr<state_t> reused = state_t::create();
+	EXPECT_EQ(released, reused.get());
+	EXPECT_FALSE(reused->has_value());
+}
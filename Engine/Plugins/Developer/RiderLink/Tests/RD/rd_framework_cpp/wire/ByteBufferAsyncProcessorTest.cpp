@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include "wire/ByteBufferAsyncProcessor.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Records every package the processor is handed, optionally failing the first calls.
+ */
+struct Recorder
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	std::vector<int32_t> payloads;
+	std::vector<sequence_number_t> seqns;
+	std::vector<size_t> batch_sizes;
+	int32_t failures_left = 0;
+
+	ByteBufferAsyncProcessor::processor_t processor()
+	{
+		return [this](ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) {
+			std::lock_guard<std::mutex> guard(lock);
+			if (failures_left > 0)
+			{
+				--failures_left;
+				return false;
+			}
+			batch_sizes.push_back(batch.size());
+			for (size_t i = 0; i < batch.size(); ++i)
+			{
+				int32_t payload = 0;
+				std::memcpy(&payload, batch[i]->data(), sizeof(payload));
+				payloads.push_back(payload);
+				seqns.push_back(first_seqn + static_cast<sequence_number_t>(i));
+			}
+			cv.notify_all();
+			return true;
+		};
+	}
+
+	bool wait_for(size_t count)
+	{
+		std::unique_lock<std::mutex> ul(lock);
+		return cv.wait_for(ul, std::chrono::seconds(30), [&] { return payloads.size() >= count; });
+	}
+};
+
+Buffer::ByteArray make_package(int32_t payload)
+{
+	Buffer::ByteArray package(sizeof(payload));
+	std::memcpy(package.data(), &payload, sizeof(payload));
+	return package;
+}
+
+int32_t encode(int32_t producer, int32_t index)
+{
+	return producer << 24 | index;
+}
+}	 // namespace
+
+TEST(ByteBufferAsyncProcessor, deliversInOrderPastRingCapacity)
+{
+	constexpr int32_t count = 50000;
+	Recorder recorder;
+	ByteBufferAsyncProcessor processor("test", recorder.processor());
+	processor.start();
+
+	for (int32_t i = 0; i < count; ++i)
+	{
+		processor.put(make_package(i));
+	}
+	ASSERT_TRUE(recorder.wait_for(count));
+	processor.terminate(std::chrono::milliseconds(1000));
+
+	ASSERT_EQ(count, static_cast<int32_t>(recorder.payloads.size()));
+	for (int32_t i = 0; i < count; ++i)
+	{
+		EXPECT_EQ(i, recorder.payloads[i]);
+		EXPECT_EQ(i + 1, recorder.seqns[i]);
+	}
+	for (size_t batch_size : recorder.batch_sizes)
+	{
+		EXPECT_LE(batch_size, 1024u);
+	}
+}
+
+TEST(ByteBufferAsyncProcessor, failedBatchStaysQueued)
+{
+	Recorder recorder;
+	recorder.failures_left = 3;
+	ByteBufferAsyncProcessor processor("test", recorder.processor());
+	processor.start();
+
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		processor.put(make_package(i));
+	}
+	ASSERT_TRUE(recorder.wait_for(10));
+	processor.terminate(std::chrono::milliseconds(1000));
+
+	ASSERT_EQ(10u, recorder.payloads.size());
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		EXPECT_EQ(i, recorder.payloads[i]);
+		EXPECT_EQ(i + 1, recorder.seqns[i]);
+	}
+}
+
+TEST(ByteBufferAsyncProcessor, resumeResendsUnacknowledged)
+{
+	Recorder recorder;
+	ByteBufferAsyncProcessor processor("test", recorder.processor());
+	processor.start();
+
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		processor.put(make_package(i));
+	}
+	ASSERT_TRUE(recorder.wait_for(10));
+
+	processor.acknowledge(4);
+	processor.pause("test");
+	processor.resume();
+	ASSERT_TRUE(recorder.wait_for(16));
+	processor.terminate(std::chrono::milliseconds(1000));
+
+	ASSERT_EQ(16u, recorder.payloads.size());
+	for (int32_t i = 0; i < 6; ++i)
+	{
+		EXPECT_EQ(4 + i, recorder.payloads[10 + i]);
+		EXPECT_EQ(5 + i, recorder.seqns[10 + i]);
+	}
+}
+
+TEST(ByteBufferAsyncProcessor, statsTrackUnacknowledged)
+{
+	Recorder recorder;
+	ByteBufferAsyncProcessor processor("test", recorder.processor());
+	processor.start();
+
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		processor.put(make_package(i));
+	}
+	ASSERT_TRUE(recorder.wait_for(10));
+	// a package sent after them means the batches holding the first ten are already tracked
+	processor.put(make_package(10));
+	ASSERT_TRUE(recorder.wait_for(11));
+	EXPECT_EQ(11u, processor.get_stats().queue_depth);
+
+	processor.acknowledge(10);
+	const ByteBufferAsyncProcessor::Stats stats = processor.get_stats();
+	EXPECT_EQ(1u, stats.queue_depth);
+	EXPECT_GE(stats.acknowledged_batches, 1u);
+	processor.terminate(std::chrono::milliseconds(1000));
+}
+
+TEST(ByteBufferAsyncProcessor, stressManyProducers)
+{
+	constexpr int32_t producers = 8;
+	constexpr int32_t per_producer = 20000;
+	Recorder recorder;
+	ByteBufferAsyncProcessor processor("test", recorder.processor());
+	processor.start();
+
+	std::vector<std::thread> threads;
+	for (int32_t p = 0; p < producers; ++p)
+	{
+		threads.emplace_back([&processor, p] {
+			for (int32_t i = 0; i < per_producer; ++i)
+			{
+				processor.put(make_package(encode(p, i)));
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	ASSERT_TRUE(recorder.wait_for(producers * per_producer));
+	processor.terminate(std::chrono::milliseconds(1000));
+
+	ASSERT_EQ(static_cast<size_t>(producers * per_producer), recorder.payloads.size());
+	std::vector<int32_t> next(producers, 0);
+	for (size_t i = 0; i < recorder.payloads.size(); ++i)
+	{
+		EXPECT_EQ(static_cast<sequence_number_t>(i + 1), recorder.seqns[i]);
+		const int32_t producer = recorder.payloads[i] >> 24;
+		const int32_t index = recorder.payloads[i] & 0xFFFFFF;
+		ASSERT_LT(producer, producers);
+		EXPECT_EQ(next[producer]++, index);
+	}
+}
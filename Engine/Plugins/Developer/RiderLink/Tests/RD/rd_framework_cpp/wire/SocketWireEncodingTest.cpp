@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SimpleScheduler.h"
+#include "wire/SocketWire.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Server and client wires connected over loopback. [up] carries client to server, [down] server to client,
+ * each is only advised on the receiving end since signals also fire their local handlers.
+ */
+class Loopback
+{
+public:
+	LifetimeDefinition def;
+	SimpleScheduler scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<SocketWire::Client> client_wire;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	RdSignal<std::wstring> up_server;
+	RdSignal<std::wstring> up_client;
+	RdSignal<std::wstring> down_server;
+	RdSignal<std::wstring> down_client;
+
+	std::mutex lock;
+	std::condition_variable cv;
+	std::vector<std::wstring> server_received;
+	std::vector<std::wstring> client_received;
+
+	explicit Loopback(std::string const& name, Buffer::Encoding server_offer)
+	{
+		server_wire = std::make_shared<SocketWire::Server>(def.lifetime, &scheduler, 0, name + "Server");
+		server_wire->set_offered_encoding(server_offer);
+		client_wire = std::make_shared<SocketWire::Client>(def.lifetime, &scheduler, server_wire->port, name + "Client");
+
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &scheduler, server_wire, def.lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &scheduler, client_wire, def.lifetime);
+
+		statics(up_server, 1).bind(def.lifetime, server_protocol.get(), "up");
+		statics(up_client, 1).bind(def.lifetime, client_protocol.get(), "up");
+		statics(down_server, 2).bind(def.lifetime, server_protocol.get(), "down");
+		statics(down_client, 2).bind(def.lifetime, client_protocol.get(), "down");
+		up_server.advise(def.lifetime, [this](std::wstring const& value) { record(server_received, value); });
+		down_client.advise(def.lifetime, [this](std::wstring const& value) { record(client_received, value); });
+	}
+
+	~Loopback()
+	{
+		def.terminate();
+	}
+
+	void record(std::vector<std::wstring>& to, std::wstring const& value)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		to.push_back(value);
+		cv.notify_all();
+	}
+
+	bool wait(std::vector<std::wstring> const& received, size_t count)
+	{
+		std::unique_lock<std::mutex> ul(lock);
+		return cv.wait_for(ul, std::chrono::seconds(10), [&] { return received.size() >= count; });
+	}
+
+	template <typename F>
+	static bool wait_until(F&& condition)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+};
+
+const std::wstring PAYLOAD(1000, L'x');
+}	 // namespace
+
+TEST(SocketWireEncoding, staysFixedWhenOnlyOneSideOffers)
+{
+	Loopback loopback("FixedOnly", Buffer::Encoding::Compact);
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	const uint64_t before = loopback.client_wire->get_stats().sent_bytes;
+	loopback.up_client.fire(PAYLOAD);
+	ASSERT_TRUE(loopback.wait(loopback.server_received, 1));
+	EXPECT_EQ(PAYLOAD, loopback.server_received.back());
+	EXPECT_EQ(Buffer::Encoding::Fixed, loopback.client_wire->get_encoding());
+	EXPECT_EQ(Buffer::Encoding::Fixed, loopback.server_wire->get_encoding());
+	// sent bytes are counted once the write returns, which can be after the server has the message
+	EXPECT_TRUE(Loopback::wait_until(
+		[&] { return loopback.client_wire->get_stats().sent_bytes - before >= PAYLOAD.size() * 2; }));
+}
+
+TEST(SocketWireEncoding, switchesToCompactWhenBothOffer)
+{
+	Loopback loopback("Negotiated", Buffer::Encoding::Compact);
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	// queued before the switch, must still decode as fixed on the other end
+	loopback.up_client.fire(L"before");
+	loopback.client_wire->set_offered_encoding(Buffer::Encoding::Compact);
+	ASSERT_TRUE(Loopback::wait_until([&] {
+		return loopback.client_wire->get_encoding() == Buffer::Encoding::Compact &&
+			   loopback.server_wire->get_encoding() == Buffer::Encoding::Compact;
+	}));
+
+	const uint64_t client_before = loopback.client_wire->get_stats().sent_bytes;
+	loopback.up_client.fire(PAYLOAD);
+	ASSERT_TRUE(loopback.wait(loopback.server_received, 2));
+	EXPECT_EQ(L"before", loopback.server_received[0]);
+	EXPECT_EQ(PAYLOAD, loopback.server_received[1]);
+	ASSERT_TRUE(Loopback::wait_until(
+		[&] { return loopback.client_wire->get_stats().sent_bytes - client_before >= PAYLOAD.size(); }));
+	EXPECT_LT(loopback.client_wire->get_stats().sent_bytes - client_before, PAYLOAD.size() * 2);
+
+	const std::wstring unicode = L"é中/Game/Map";
+	loopback.down_server.fire(unicode);
+	ASSERT_TRUE(loopback.wait(loopback.client_received, 1));
+	EXPECT_EQ(unicode, loopback.client_received.back());
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SimpleScheduler.h"
+#include "wire/SharedMemoryRing.h"
+#include "wire/SocketWire.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+constexpr uint32_t SHARED_MEMORY = static_cast<uint32_t>(IWire::Capability::SharedMemory);
+
+/**
+ * \brief Server and client wires connected over loopback, [up] carries client to server and [down] server to client.
+ * The client makes its offer once connected, so the switch happens while messages may be in flight.
+ */
+class Loopback
+{
+public:
+	LifetimeDefinition def;
+	SimpleScheduler scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<SocketWire::Client> client_wire;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	RdSignal<std::wstring> up_server;
+	RdSignal<std::wstring> up_client;
+	RdSignal<std::wstring> down_server;
+	RdSignal<std::wstring> down_client;
+
+	std::mutex lock;
+	std::condition_variable cv;
+	std::vector<std::wstring> server_received;
+	std::vector<std::wstring> client_received;
+	std::atomic<int32_t> client_connections{0};
+
+	Loopback(std::string const& name, uint32_t server_offer)
+	{
+		server_wire = std::make_shared<SocketWire::Server>(def.lifetime, &scheduler, 0, name + "Server");
+		server_wire->set_offered_capabilities(server_offer);
+		client_wire = std::make_shared<SocketWire::Client>(def.lifetime, &scheduler, server_wire->port, name + "Client");
+
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &scheduler, server_wire, def.lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &scheduler, client_wire, def.lifetime);
+
+		statics(up_server, 1).bind(def.lifetime, server_protocol.get(), "up");
+		statics(up_client, 1).bind(def.lifetime, client_protocol.get(), "up");
+		statics(down_server, 2).bind(def.lifetime, server_protocol.get(), "down");
+		statics(down_client, 2).bind(def.lifetime, client_protocol.get(), "down");
+		up_server.advise(def.lifetime, [this](std::wstring const& value) { record(server_received, value); });
+		down_client.advise(def.lifetime, [this](std::wstring const& value) { record(client_received, value); });
+		client_wire->connected.advise(def.lifetime, [this](bool const& value) {
+			if (value)
+			{
+				++client_connections;
+			}
+		});
+	}
+
+	~Loopback()
+	{
+		def.terminate();
+	}
+
+	void record(std::vector<std::wstring>& to, std::wstring const& value)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		to.push_back(value);
+		cv.notify_all();
+	}
+
+	bool wait(std::vector<std::wstring> const& received, size_t count)
+	{
+		std::unique_lock<std::mutex> ul(lock);
+		return cv.wait_for(ul, std::chrono::seconds(10), [&] { return received.size() >= count; });
+	}
+
+	template <typename F>
+	static bool wait_until(F&& condition)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+
+	bool switched()
+	{
+		return wait_until([&] { return client_wire->is_shared_memory_used() && server_wire->is_shared_memory_used(); });
+	}
+
+	/**
+	 * \brief Fires [count] messages each way, every tenth one larger than a ring, and checks they all arrive in order.
+	 */
+	void exchange(int32_t count)
+	{
+		size_t server_before = 0;
+		size_t client_before = 0;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			server_before = server_received.size();
+			client_before = client_received.size();
+		}
+		std::vector<std::wstring> sent;
+		for (int32_t i = 0; i < count; ++i)
+		{
+			sent.push_back(i % 10 == 9 ? std::wstring(SharedMemoryRing::CAPACITY, static_cast<wchar_t>(L'a' + i % 26))
+									   : std::to_wstring(i));
+			up_client.fire(sent.back());
+			down_server.fire(sent.back());
+		}
+		ASSERT_TRUE(wait(server_received, server_before + sent.size()));
+		ASSERT_TRUE(wait(client_received, client_before + sent.size()));
+		std::lock_guard<std::mutex> guard(lock);
+		for (size_t i = 0; i < sent.size(); ++i)
+		{
+			ASSERT_EQ(sent[i], server_received[server_before + i]);
+			ASSERT_EQ(sent[i], client_received[client_before + i]);
+		}
+	}
+};
+}	 // namespace
+
+TEST(SharedMemoryRing, streamsBytesAcrossTheEnd)
+{
+	if (!SharedMemoryRing::is_supported())
+	{
+		GTEST_SKIP();
+	}
+	std::unique_ptr<SharedMemoryRing> created = SharedMemoryRing::create();
+	ASSERT_NE(nullptr, created);
+	std::unique_ptr<SharedMemoryRing> opened = SharedMemoryRing::open(created->get_segment_id());
+	ASSERT_NE(nullptr, opened);
+	created->unlink();
+	EXPECT_EQ(nullptr, SharedMemoryRing::open(created->get_segment_id()));
+
+	const std::chrono::milliseconds timeout(10);
+	std::vector<uint8_t> chunk(SharedMemoryRing::CAPACITY / 3 + 1);
+	std::vector<uint8_t> read(chunk.size());
+	for (uint32_t round = 0; round < 10; ++round)
+	{
+		for (size_t i = 0; i < chunk.size(); ++i)
+		{
+			chunk[i] = static_cast<uint8_t>(i * 7 + round);
+		}
+		ASSERT_EQ(static_cast<int32_t>(chunk.size()), created->send(chunk.data(), chunk.size(), timeout));
+		size_t got = 0;
+		while (got < read.size())
+		{
+			const int32_t n = opened->receive(read.data() + got, read.size() - got, timeout);
+			ASSERT_GT(n, 0);
+			got += static_cast<size_t>(n);
+		}
+		ASSERT_EQ(chunk, read);
+	}
+
+	// each direction has a ring of its own, and a full one takes nothing more
+	std::vector<uint8_t> full(SharedMemoryRing::CAPACITY);
+	EXPECT_EQ(static_cast<int32_t>(full.size()), opened->send(full.data(), full.size(), timeout));
+	EXPECT_EQ(0, opened->send(full.data(), 1, timeout));
+	EXPECT_EQ(0, opened->receive(read.data(), read.size(), timeout));
+
+	// bytes written before closing are still read
+	opened->close();
+	EXPECT_TRUE(created->is_closed());
+	EXPECT_EQ(-1, created->send(chunk.data(), chunk.size(), timeout));
+	EXPECT_EQ(static_cast<int32_t>(read.size()), created->receive(read.data(), read.size(), timeout));
+}
+
+TEST(SocketWireSharedMemory, staysOnSocketWhenOnlyOneSideOffers)
+{
+	Loopback loopback("ShmOneSided", SHARED_MEMORY);
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	loopback.exchange(20);
+	EXPECT_FALSE(loopback.client_wire->is_shared_memory_used());
+	EXPECT_FALSE(loopback.server_wire->is_shared_memory_used());
+}
+
+TEST(SocketWireSharedMemory, switchesWhenBothOffer)
+{
+	if (!SharedMemoryRing::is_supported())
+	{
+		GTEST_SKIP();
+	}
+	Loopback loopback("ShmSwitch", SHARED_MEMORY);
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_wire->connected.get(); }));
+
+	// in flight while the wires switch, must arrive once and in order
+	for (int32_t i = 0; i < 100; ++i)
+	{
+		loopback.up_client.fire(L"before");
+		loopback.down_server.fire(L"before");
+	}
+	loopback.client_wire->set_offered_capabilities(SHARED_MEMORY);
+	ASSERT_TRUE(loopback.switched());
+	loopback.exchange(50);
+	std::lock_guard<std::mutex> guard(loopback.lock);
+	EXPECT_EQ(150u, loopback.server_received.size());
+	EXPECT_EQ(150u, loopback.client_received.size());
+	for (size_t i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(L"before", loopback.server_received[i]);
+		ASSERT_EQ(L"before", loopback.client_received[i]);
+	}
+}
+
+TEST(SocketWireSharedMemory, switchesAgainAfterReconnect)
+{
+	if (!SharedMemoryRing::is_supported())
+	{
+		GTEST_SKIP();
+	}
+	Loopback loopback("ShmReconnect", SHARED_MEMORY);
+	loopback.client_wire->set_offered_capabilities(SHARED_MEMORY);
+	ASSERT_TRUE(loopback.switched());
+	loopback.exchange(10);
+
+	// closing the ring ends the connection for both ends, the client connects again
+	loopback.client_wire->try_shutdown_connection();
+	ASSERT_TRUE(Loopback::wait_until([&] { return loopback.client_connections.load() == 2; }));
+	ASSERT_TRUE(loopback.switched());
+	loopback.exchange(10);
+}
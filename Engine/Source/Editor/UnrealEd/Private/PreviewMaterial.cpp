@@ -216,7 +216,7 @@ public:
 			{
 				bShaderTypeMatches = true;
 			}
-			else if (FCString::Stristr(ShaderType->GetName(), TEXT("FToonOutlineVS")) || FCString::Stristr(ShaderType->GetName(), TEXT("FToonOutlinePS")))
+			else if (FCString::Stristr(ShaderType->GetName(), TEXT("FToonHullOutlineVS")) || FCString::Stristr(ShaderType->GetName(), TEXT("FToonHullOutlinePS")))
 			{
 				bShaderTypeMatches = true;
 			}
@@ -1218,10 +1218,6 @@ public:
 	TObjectPtr<class UTexture2D> PreIntegratedSkinBRDFTexture;
 	//begin sjw modify
 	UPROPERTY()
-	TObjectPtr<class UTexture2D> PreIntegratedToonSkinBRDFTexture;
-	UPROPERTY()
-	TObjectPtr<class UTexture2D> PreIntegratedToonMetalicTexture;
-	UPROPERTY()
 	TObjectPtr<class UTexture2D> PreIntegratedToonRoughnessTexture;
 
 	/** Path of the texture used for pre-integrated skin shading */
@@ -1229,10 +1225,6 @@ public:
 	FSoftObjectPath PreIntegratedSkinBRDFTextureName;
 	//begin sjw modify
 	UPROPERTY(globalconfig)
-	FSoftObjectPath PreIntegratedToonSkinBRDFTextureName;
-	UPROPERTY(globalconfig)
-	FSoftObjectPath PreIntegratedToonMetalicTextureName;
-	UPROPERTY(globalconfig)
 	FSoftObjectPath PreIntegratedToonRoughnessTextureName;
 
 	/** Tiled blue-noise texture */
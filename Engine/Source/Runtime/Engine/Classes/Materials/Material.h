@@ -332,6 +332,19 @@ class UMaterial : public UMaterialInterface
 	//materials for mutipass
 	UPROPERTY(EditAnywhere, Category = MultiPassMaterials)
 	TArray<TObjectPtr<UMaterial>> MultiPassMaterials;
+
+	/** Whether meshes using this toon material also render in the second base pass. Off by default so the pass costs nothing for other materials. */
+	UPROPERTY(EditAnywhere, Category = MultiPassMaterials)
+	uint8 bUseMultiBasePass : 1;
+
+	/** Whether meshes using this toon material draw the hull-expanded outline. Off by default so the outline pass costs nothing for other materials. */
+	UPROPERTY(EditAnywhere, Category = ToonOutline)
+	uint8 bUseToonOutline : 1;
+
+	/** Width in pixels of the toon outline, the thickness stays constant on screen.
+	 * Used when the material has no OutlineWidth output, connect a parameter to one to vary the width per instance or at runtime. */
+	UPROPERTY(EditAnywhere, Category = ToonOutline, meta = (ClampMin = "0.0", UIMax = "8.0"))
+	float ToonOutlineWidth;
 	/* end sjw modify*/
 
 	/** Physical material mask to use for this graphics material. Used for sounds, effects etc.*/
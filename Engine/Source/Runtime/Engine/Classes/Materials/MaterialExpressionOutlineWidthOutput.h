@@ -0,0 +1,31 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "MaterialExpressionIO.h"
+#include "Materials/MaterialExpressionCustomOutput.h"
+#include "MaterialExpressionOutlineWidthOutput.generated.h"
+
+/** Width in pixels of the toon hull outline, evaluated in its vertex shader so parameter changes apply without recaching draw commands. */
+UCLASS(collapsecategories, hidecategories=Object, MinimalAPI)
+class UMaterialExpressionOutlineWidthOutput : public UMaterialExpressionCustomOutput
+{
+	GENERATED_UCLASS_BODY()
+
+	UPROPERTY(meta = (RequiredInput = "true"))
+	FExpressionInput Input;
+
+#if WITH_EDITOR
+	virtual int32 Compile(class FMaterialCompiler* Compiler, int32 OutputIndex) override;
+	virtual void GetCaption(TArray<FString>& OutCaptions) const override;
+	virtual uint32 GetInputType(int32 InputIndex) override { return MCT_Float1; }
+	virtual FExpressionInput* GetInput(int32 InputIndex) override;
+#endif
+
+	virtual int32 GetNumOutputs() const override { return 1; }
+	virtual FString GetFunctionName() const override { return TEXT("GetOutlineWidth"); }
+	virtual FString GetDisplayName() const override { return TEXT("OutlineWidth"); }
+	virtual EShaderFrequency GetShaderFrequency() override { return SF_Vertex; }
+};
\ No newline at end of file
@@ -39,7 +39,8 @@ struct ENGINE_API FMaterialRelevance
 			uint8 bUsesDistanceCullFade : 1;
 			uint8 bDisableDepthTest : 1;
 			uint8 bUsesAnisotropy : 1;
-			uint8 bUsesToonOutline : 1;
+			uint8 bUsesMultiBasePass : 1;
+			uint8 bUsesToonHullOutline : 1;
 		};
 		uint64 Raw;
 	};
@@ -961,6 +961,11 @@ UMaterial::UMaterial(const FObjectInitializer& ObjectInitializer)
 	bUseTranslucencyVertexFog = true;
 	bApplyCloudFogging = false;
 	bIsSky = false;
+	//begin sjw modify
+	bUseMultiBasePass = false;
+	bUseToonOutline = false;
+	ToonOutlineWidth = 1.0f;
+	//end sjw modify
 	bUsedWithWater = false;
 	BlendableLocation = BL_AfterTonemapping;
 	BlendablePriority = 0;
@@ -3556,6 +3561,23 @@ bool UMaterial::CanEditChange(const FProperty* InProperty) const
 			return MaterialDomain != MD_DeferredDecal && GetShadingModels().IsUnlit() && (BlendMode == BLEND_Opaque || BlendMode == BLEND_Masked);
 		}
 
+		//begin sjw modify
+		if (PropertyName == GET_MEMBER_NAME_STRING_CHECKED(UMaterial, bUseMultiBasePass))
+		{
+			return MaterialDomain == MD_Surface && IsToonShadingModel(GetShadingModels()) && BlendMode == BLEND_Opaque;
+		}
+
+		if (PropertyName == GET_MEMBER_NAME_STRING_CHECKED(UMaterial, bUseToonOutline))
+		{
+			return MaterialDomain == MD_Surface && IsToonShadingModel(GetShadingModels()) && !IsTranslucentBlendMode(BlendMode);
+		}
+
+		if (PropertyName == GET_MEMBER_NAME_STRING_CHECKED(UMaterial, ToonOutlineWidth))
+		{
+			return MaterialDomain == MD_Surface && IsToonShadingModel(GetShadingModels()) && !IsTranslucentBlendMode(BlendMode) && bUseToonOutline;
+		}
+		//end sjw modify
+
 		if (PropertyName == GET_MEMBER_NAME_STRING_CHECKED(UMaterial, TranslucencyLightingMode)
 			|| PropertyName == GET_MEMBER_NAME_STRING_CHECKED(UMaterial, TranslucencyDirectionalLightingIntensity)
 			|| PropertyName == GET_MEMBER_NAME_STRING_CHECKED(UMaterial, TranslucentShadowDensityScale)
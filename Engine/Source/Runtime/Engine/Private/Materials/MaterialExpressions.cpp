@@ -289,6 +289,7 @@
 #include "Interfaces/ITargetPlatformManagerModule.h"
 //begin sjw modify
 #include "Materials/MaterialExpressionOutlineColorOutput.h"
+#include "Materials/MaterialExpressionOutlineWidthOutput.h"
 //end sjw modify
 #define LOCTEXT_NAMESPACE "MaterialExpression"
 
@@ -18687,6 +18688,61 @@ FExpressionInput* UMaterialExpressionOutlineColorOutput::GetInput(int32 InputInd
 #endif // WITH_EDITOR
 
 
+///////////////////////////////////////////////////////////////////////////////
+// OutlineWidthOutput
+///////////////////////////////////////////////////////////////////////////////
+
+UMaterialExpressionOutlineWidthOutput::UMaterialExpressionOutlineWidthOutput(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+#if WITH_EDITORONLY_DATA
+	// Structure to hold one-time initialization
+	struct FConstructorStatics
+	{
+		FText NAME_Utility;
+		FConstructorStatics(const FString& DisplayName, const FString& FunctionName)
+			: NAME_Utility(LOCTEXT("Utility", "Utility"))
+		{
+		}
+	};
+	static FConstructorStatics ConstructorStatics(GetDisplayName(), GetFunctionName());
+
+	MenuCategories.Add(ConstructorStatics.NAME_Utility);
+
+	bCollapsed = true;
+
+	// No outputs
+	Outputs.Reset();
+#endif
+}
+
+#if WITH_EDITOR
+int32  UMaterialExpressionOutlineWidthOutput::Compile(class FMaterialCompiler* Compiler, int32 OutputIndex)
+{
+	if (Input.GetTracedInput().Expression)
+	{
+		return Compiler->CustomOutput(this, OutputIndex, Input.Compile(Compiler));
+	}
+	else
+	{
+		return CompilerError(Compiler, TEXT("Input missing"));
+	}
+	return INDEX_NONE;
+}
+
+
+void UMaterialExpressionOutlineWidthOutput::GetCaption(TArray<FString>& OutCaptions) const
+{
+	OutCaptions.Add(FString(TEXT("OutlineWidth")));
+}
+
+FExpressionInput* UMaterialExpressionOutlineWidthOutput::GetInput(int32 InputIndex)
+{
+	return &Input;
+}
+#endif // WITH_EDITOR
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Vertex to pixel interpolated data handler
 ///////////////////////////////////////////////////////////////////////////////
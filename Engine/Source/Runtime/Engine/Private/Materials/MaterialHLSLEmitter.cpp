@@ -449,6 +449,9 @@ static void GetMaterialEnvironment(EShaderPlatform InPlatform,
 	OutEnvironment.SetDefine(TEXT("MATERIAL_IS_SKY"), InMaterial.IsSky());
 	OutEnvironment.SetDefine(TEXT("MATERIAL_COMPUTE_FOG_PER_PIXEL"), InMaterial.ComputeFogPerPixel());
 	OutEnvironment.SetDefine(TEXT("MATERIAL_FULLY_ROUGH"), false);// bIsFullyRough || InMaterial.IsFullyRough());
+	//begin sjw modify
+	OutEnvironment.SetDefine(TEXT("MATERIAL_TOON_OUTLINE"), InMaterial.IsUsedWithToonOutline());
+	//end sjw modify
 	OutEnvironment.SetDefine(TEXT("MATERIAL_USES_ANISOTROPY"), false);// bUsesAnisotropy);
 
 	// Count the number of VTStacks (each stack will allocate a feedback slot)
@@ -352,7 +352,8 @@ FMaterialRelevance UMaterialInterface::GetRelevance_Internal(const UMaterial* Ma
 			MaterialRelevance.bUsesSkyMaterial = Material->bIsSky;
 			MaterialRelevance.bUsesSingleLayerWaterMaterial = bUsesSingleLayerWaterMaterial;
 			MaterialRelevance.bUsesAnisotropy = bUsesAnisotropy;
-			MaterialRelevance.bUsesToonOutline = MaterialResource->GetShadingModels().HasAnyShadingModel({ MSM_ToonStandard, MSM_ToonSkin, MSM_ToonHair }) ;
+			MaterialRelevance.bUsesMultiBasePass = MaterialResource->IsUsedWithMultiBasePass() && IsToonShadingModel(MaterialResource->GetShadingModels());
+			MaterialRelevance.bUsesToonHullOutline = !bIsTranslucent && MaterialResource->IsUsedWithToonOutline() && IsToonShadingModel(MaterialResource->GetShadingModels());
 		}
 		return MaterialRelevance;
 	}
@@ -1616,6 +1616,11 @@ float FMaterialResource::GetRefractionDepthBiasValue() const { return Material->
 bool FMaterialResource::ShouldApplyFogging() const { return Material->bUseTranslucencyVertexFog; }
 bool FMaterialResource::ShouldApplyCloudFogging() const { return Material->bApplyCloudFogging; }
 bool FMaterialResource::IsSky() const { return Material->bIsSky; }
+//begin sjw modify
+bool FMaterialResource::IsUsedWithMultiBasePass() const { return Material->bUseMultiBasePass; }
+bool FMaterialResource::IsUsedWithToonOutline() const { return Material->bUseToonOutline; }
+float FMaterialResource::GetToonOutlineWidth() const { return Material->ToonOutlineWidth; }
+//end sjw modify
 bool FMaterialResource::ComputeFogPerPixel() const {return Material->bComputeFogPerPixel;}
 FString FMaterialResource::GetFriendlyName() const { return GetNameSafe(Material); } //avoid using the material instance name here, we want materials that share a shadermap to also share a friendly name.
 FString FMaterialResource::GetAssetName() const { return MaterialInstance ? GetNameSafe(MaterialInstance) : GetNameSafe(Material); }
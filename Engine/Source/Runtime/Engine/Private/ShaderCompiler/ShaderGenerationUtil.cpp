@@ -1103,7 +1103,6 @@ static FString CreateGBufferDecodeFunctionDirect(const FGBufferInfo& BufferInfo)
 	}
 	FullStr += TEXT(" \n\tfloat CustomNativeDepth");
 	FullStr += TEXT(",\n\tfloat4 AnisotropicData");
-	FullStr += TEXT(",\n\tfloat4 InToonDataA");
 	FullStr += TEXT(",\n\tuint CustomStencil");
 	FullStr += TEXT(",\n\tfloat SceneDepth");
 	FullStr += TEXT(",\n\tbool bGetNormalizedNormal");
@@ -1304,9 +1303,6 @@ static FString CreateGBufferDecodeFunctionDirect(const FGBufferInfo& BufferInfo)
 	FullStr += TEXT("\tRet.CustomDepth = ConvertFromDeviceZ(CustomNativeDepth);\n");
 	FullStr += TEXT("\tRet.CustomStencil = CustomStencil;\n");
 	FullStr += TEXT("\tRet.Depth = SceneDepth;\n");
-	//begin sjw modify
-	FullStr += TEXT("\tRet.ToonDataA = InToonDataA;\n");
-	//end sjw modify
 	FullStr += TEXT("\t\n");
 
 	FullStr += TEXT("\n");
@@ -1379,9 +1375,6 @@ static FString CreateGBufferDecodeFunctionVariation(const FGBufferInfo& BufferIn
 
 		FullStr += FString::Printf(TEXT("\tfloat SceneDepth = CalcSceneDepth(%s);\n"), CoordName.GetCharArray().GetData());
 		FullStr += TEXT("\tfloat4 AnisotropicData = Texture2DSampleLevel(SceneTexturesStruct.GBufferFTexture, SceneTexturesStruct_GBufferFTextureSampler, UV, 0).xyzw;\n");
-		//begin sjw modify
-		//define in scenetexturecommon.ush
-		FullStr += TEXT("\tfloat4 ToonDataA = Texture2DSampleLevel(SceneTexturesStruct.ToonBufferATexture, SceneTexturesStruct_ToonBufferATextureSampler, UV, 0).xyzw;\n");
 	}
 	else if (DecodeType == CoordUInt)
 	{
@@ -1389,8 +1382,6 @@ static FString CreateGBufferDecodeFunctionVariation(const FGBufferInfo& BufferIn
 		FullStr += FString::Printf(TEXT("\tuint CustomStencil = SceneTexturesStruct.CustomStencilTexture.Load(int3(%s, 0)) STENCIL_COMPONENT_SWIZZLE;\n"), CoordName.GetCharArray().GetData());
 		FullStr += FString::Printf(TEXT("\tfloat SceneDepth = CalcSceneDepth(%s);\n"), CoordName.GetCharArray().GetData());
 		FullStr += TEXT("\tfloat4 AnisotropicData = SceneTexturesStruct.GBufferFTexture.Load(int3(PixelPos, 0)).xyzw;\n");
-		//begin sjw modify
-		FullStr += TEXT("\tfloat4 ToonDataA = SceneTexturesStruct.ToonBufferATexture.Load(int3(PixelPos, 0)).xyzw;\n");
 	}
 	else if (DecodeType == SceneTextures)
 	{
@@ -1399,10 +1390,6 @@ static FString CreateGBufferDecodeFunctionVariation(const FGBufferInfo& BufferIn
 		FullStr += FString::Printf(TEXT("\tfloat DeviceZ = SampleDeviceZFromSceneTexturesTempCopy(%s);\n"), CoordName.GetCharArray().GetData());
 		FullStr += TEXT("\tfloat SceneDepth = ConvertFromDeviceZ(DeviceZ);\n");
 		FullStr += TEXT("\tfloat4 AnisotropicData = GBufferFTexture.SampleLevel(GBufferFTextureSampler, UV, 0).xyzw;\n");
-		//begin sjw modify
-		//define in DeferredShadingCommon.ush
-		FullStr += TEXT("\tfloat4 ToonDataA = ToonBufferATexture.SampleLevel(ToonBufferATextureSampler, UV, 0).xyzw;\n");
-		
 	}
 	else if (DecodeType == SceneTexturesLoad)
 	{
@@ -1411,8 +1398,6 @@ static FString CreateGBufferDecodeFunctionVariation(const FGBufferInfo& BufferIn
 		FullStr += FString::Printf(TEXT("\tfloat DeviceZ = SceneDepthTexture.Load(int3(%s, 0)).r;\n"), CoordName.GetCharArray().GetData());
 		FullStr += TEXT("\tfloat SceneDepth = ConvertFromDeviceZ(DeviceZ);\n");
 		FullStr += TEXT("\tfloat4 AnisotropicData = GBufferFTexture.Load(int3(PixelCoord, 0)).xyzw;\n");
-		//begin sjw modify
-		FullStr += TEXT("\tfloat4 ToonDataA = ToonBufferATexture.Load(int3(PixelCoord, 0)).xyzw;\n");
 	}
 	else
 	{
@@ -1533,7 +1518,6 @@ static FString CreateGBufferDecodeFunctionVariation(const FGBufferInfo& BufferIn
 	}
 	FullStr += TEXT(" \n\t\tCustomNativeDepth");
 	FullStr += TEXT(",\n\t\tAnisotropicData");
-	FullStr += TEXT(",\n\t\tToonDataA");
 	FullStr += TEXT(",\n\t\tCustomStencil");
 	FullStr += TEXT(",\n\t\tSceneDepth");
 	FullStr += TEXT(",\n\t\tbGetNormalizedNormal");
@@ -1693,6 +1677,15 @@ static void SetSlotsForShadingModelType(bool Slots[], EMaterialShadingModel Shad
 	case MSM_ThinTranslucent:
 		// thin translucent doesn't write to the GBuffer
 		break;
+	// begin sjw modify
+	// toon models pack all their extra data into the full CustomData RGBA8
+	case MSM_ToonStandard:
+	case MSM_ToonHair:
+	case MSM_ToonSkin:
+		SetSharedGBufferSlots(Slots);
+		Slots[GBS_CustomData] = true;
+		break;
+	// end sjw modify
 	}
 }
 
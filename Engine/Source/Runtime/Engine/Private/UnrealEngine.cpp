@@ -3009,11 +3009,27 @@ void UEngine::InitializeObjectReferences()
 	LoadEngineTexture(DefaultBokehTexture, *DefaultBokehTextureName.ToString());
 	LoadEngineTexture(PreIntegratedSkinBRDFTexture, *PreIntegratedSkinBRDFTextureName.ToString());
 	// beign sjw modify
-	//LoadEngineTexture(PreIntegratedToonSkinBRDFTexture, *PreIntegratedToonSkinBRDFTextureName.ToString());
-	PreIntegratedToonSkinBRDFTexture = Cast<UTexture2D>(StaticLoadObject(UTexture2D::StaticClass(), NULL, *(PreIntegratedToonSkinBRDFTextureName.ToString())));
-	//LoadEngineTexture(PreIntegratedToonMetalicTexture, *PreIntegratedToonMetalicTextureName.ToString());
-	PreIntegratedToonMetalicTexture = Cast<UTexture2D>(StaticLoadObject(UTexture2D::StaticClass(), NULL, *(PreIntegratedToonMetalicTextureName.ToString())));
-	LoadEngineTexture(PreIntegratedToonRoughnessTexture, *PreIntegratedToonRoughnessTextureName.ToString());
+	// toon skin and toon specular BRDFs are baked procedurally by the renderer, see ToonBRDFLUT.cpp
+	// the toon roughness BRDF is streamed in, the renderer binds a white texture until it is loaded
+	if (!PreIntegratedToonRoughnessTexture && PreIntegratedToonRoughnessTextureName.IsValid())
+	{
+		LoadPackageAsync(PreIntegratedToonRoughnessTextureName.GetLongPackageName(), FLoadPackageAsyncDelegate::CreateLambda(
+			[WeakEngine = TWeakObjectPtr<UEngine>(this)](const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+		{
+			UEngine* Engine = WeakEngine.Get();
+			if (Engine == nullptr || Result != EAsyncLoadingResult::Succeeded)
+			{
+				UE_CLOG(Result != EAsyncLoadingResult::Succeeded, LogEngine, Warning, TEXT("Failed to load %s"), *PackageName.ToString());
+				return;
+			}
+
+			Engine->PreIntegratedToonRoughnessTexture = Cast<UTexture2D>(Engine->PreIntegratedToonRoughnessTextureName.ResolveObject());
+			if (FPlatformProperties::RequiresCookedData() && Engine->PreIntegratedToonRoughnessTexture)
+			{
+				Engine->PreIntegratedToonRoughnessTexture->AddToRoot();
+			}
+		}));
+	}
 	// end sjw modify
 	LoadEngineTexture(MiniFontTexture, *MiniFontTextureName.ToString());
 	LoadEngineTexture(WeightMapPlaceholderTexture, *WeightMapPlaceholderTextureName.ToString());
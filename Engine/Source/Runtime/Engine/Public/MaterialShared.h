@@ -114,6 +114,13 @@ inline bool IsSubsurfaceShadingModel(FMaterialShadingModelField ShadingModel)
 	;
 }
 
+//begin sjw modify
+inline bool IsToonShadingModel(FMaterialShadingModelField ShadingModel)
+{
+	return ShadingModel.HasAnyShadingModel({ MSM_ToonStandard, MSM_ToonSkin, MSM_ToonHair });
+}
+//end sjw modify
+
 inline bool UseSubsurfaceProfile(FMaterialShadingModelField ShadingModel)
 {
 	return ShadingModel.HasShadingModel(MSM_SubsurfaceProfile) || ShadingModel.HasShadingModel(MSM_Eye);
@@ -1783,6 +1790,11 @@ public:
 	virtual bool ShouldApplyCloudFogging() const { return false; }
 	virtual bool ComputeFogPerPixel() const { return false; }
 	virtual bool IsSky() const { return false; }
+	//begin sjw modify
+	virtual bool IsUsedWithMultiBasePass() const { return false; }
+	virtual bool IsUsedWithToonOutline() const { return false; }
+	virtual float GetToonOutlineWidth() const { return 0.0f; }
+	//end sjw modify
 	virtual FString GetFriendlyName() const = 0;
 	/** Similar to GetFriendlyName, but but avoids historical behavior of the former, returning the exact asset name for material instances instead of just the material. */
 	virtual FString GetAssetName() const { return GetFriendlyName(); }
@@ -2726,6 +2738,11 @@ public:
 	ENGINE_API virtual bool ShouldApplyFogging() const override;
 	ENGINE_API virtual bool ShouldApplyCloudFogging() const override;
 	ENGINE_API virtual bool IsSky() const override;
+	//begin sjw modify
+	ENGINE_API virtual bool IsUsedWithMultiBasePass() const override;
+	ENGINE_API virtual bool IsUsedWithToonOutline() const override;
+	ENGINE_API virtual float GetToonOutlineWidth() const override;
+	//end sjw modify
 	ENGINE_API virtual bool ComputeFogPerPixel() const override;
 	ENGINE_API virtual bool HasPerInstanceCustomData() const override;
 	ENGINE_API virtual bool HasPerInstanceRandom() const override;
@@ -3313,6 +3330,10 @@ struct FMaterialShaderParameters
 			uint64 bIsStencilTestEnabled : 1;
 			uint64 bIsTranslucencySurface : 1;
 			uint64 bShouldDisableDepthTest : 1;
+			//begin sjw modify
+			uint64 bIsUsedWithMultiBasePass : 1;
+			uint64 bIsUsedWithToonOutline : 1;
+			//end sjw modify
 		};
 	};
 
@@ -3378,6 +3399,10 @@ struct FMaterialShaderParameters
 		bIsStencilTestEnabled = InMaterial->IsStencilTestEnabled();
 		bIsTranslucencySurface = InMaterial->GetTranslucencyLightingMode() == ETranslucencyLightingMode::TLM_Surface || InMaterial->GetTranslucencyLightingMode() == ETranslucencyLightingMode::TLM_SurfacePerPixelLighting;
 		bShouldDisableDepthTest = InMaterial->ShouldDisableDepthTest();
+		//begin sjw modify
+		bIsUsedWithMultiBasePass = InMaterial->IsUsedWithMultiBasePass();
+		bIsUsedWithToonOutline = InMaterial->IsUsedWithToonOutline();
+		//end sjw modify
 	}
 };
 
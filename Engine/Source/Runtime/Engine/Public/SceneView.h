@@ -863,6 +863,7 @@ SHADER_PARAMETER_TEXTURE(Texture2D, PreIntegratedToonBRDF)
 SHADER_PARAMETER_TEXTURE(Texture2D, PreIntegratedToonSkinBRDF)
 SHADER_PARAMETER_TEXTURE(Texture2D, PreIntegratedToonRoughnessBRDF)
 	SHADER_PARAMETER_SAMPLER(SamplerState, PreIntegratedToonBRDFSampler)
+	SHADER_PARAMETER(float, ToonOutlineMinScreenRadiusSquared)
 //end sjw modify
 	SHADER_PARAMETER_SRV(StructuredBuffer<float4>, PrimitiveSceneData)
 	SHADER_PARAMETER_SRV(StructuredBuffer<float4>, InstanceSceneData)
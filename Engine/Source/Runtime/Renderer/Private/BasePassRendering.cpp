@@ -133,10 +133,6 @@ DECLARE_CYCLE_STAT(TEXT("BasePass"), STAT_CLM_BasePass, STATGROUP_CommandListMar
 DECLARE_CYCLE_STAT(TEXT("AfterBasePass"), STAT_CLM_AfterBasePass, STATGROUP_CommandListMarkers);
 DECLARE_CYCLE_STAT(TEXT("AnisotropyPass"), STAT_CLM_AnisotropyPass, STATGROUP_CommandListMarkers);
 DECLARE_CYCLE_STAT(TEXT("AfterAnisotropyPass"), STAT_CLM_AfterAnisotropyPass, STATGROUP_CommandListMarkers);
-// begin sjw modify
-DECLARE_CYCLE_STAT(TEXT("OutlinePass"), STAT_CLM_OutlinePass, STATGROUP_CommandListMarkers);
-DECLARE_CYCLE_STAT(TEXT("AfterOutlinePass"), STAT_CLM_AfterOutlinePass, STATGROUP_CommandListMarkers);
-//end sjw modify
 
 DECLARE_CYCLE_STAT(TEXT("BasePass"), STAT_CLP_BasePass, STATGROUP_ParallelCommandListMarkers);
 
@@ -906,13 +902,6 @@ void FDeferredShadingSceneRenderer::RenderBasePass(
 		GraphBuilder.SetCommandListStat(GET_STATID(STAT_CLM_AfterAnisotropyPass));
 	}
 	//TODO: sjw. flatten normal
-	//begin sjw modify
-	{
-		GraphBuilder.SetCommandListStat(GET_STATID(STAT_CLM_OutlinePass));
-		RenderToonDataPass(GraphBuilder, SceneTextures, bEnableParallelBasePasses);
-		GraphBuilder.SetCommandListStat(GET_STATID(STAT_CLM_AfterOutlinePass));
-	}
-	
 
 #if !(UE_BUILD_SHIPPING)
 	if (!bForwardShadingEnabled)
@@ -1238,6 +1227,31 @@ void FDeferredShadingSceneRenderer::RenderBasePassInternal(
 						FRDGParallelCommandListSet ParallelCommandListSet(RHICmdList, GET_STATID(STAT_CLP_BasePass), *this, View, FParallelCommandListBindings(PassParameters));
 						View.ParallelMeshDrawCommandPasses[EMeshPass::BasePass].DispatchDraw(&ParallelCommandListSet, RHICmdList, &PassParameters->InstanceCullingDrawParams);
 					});
+
+					//begin sjw modify
+					// Only materials with bUseMultiBasePass produce commands for this pass, so it is skipped entirely otherwise.
+					FParallelMeshDrawCommandPass& MultiBasePass = View.ParallelMeshDrawCommandPasses[EMeshPass::MultiBasePass];
+					if (MultiBasePass.HasAnyDraw())
+					{
+						FOpaqueBasePassParameters* MultiBasePassParameters = GraphBuilder.AllocParameters<FOpaqueBasePassParameters>();
+						MultiBasePassParameters->BasePass = PassParameters->BasePass;
+						MultiBasePassParameters->RenderTargets = BasePassRenderTargets;
+						MultiBasePassParameters->View = View.GetShaderParameters();
+						MultiBasePassParameters->ReflectionCapture = View.ReflectionCaptureUniformBuffer;
+
+						MultiBasePass.BuildRenderingCommands(GraphBuilder, Scene->GPUScene, MultiBasePassParameters->InstanceCullingDrawParams);
+
+						GraphBuilder.AddPass(
+							RDG_EVENT_NAME("SecondPassParallel"),
+							MultiBasePassParameters,
+							ERDGPassFlags::Raster | ERDGPassFlags::SkipRenderPass,
+							[this, &View, &MultiBasePass, MultiBasePassParameters](FRHICommandListImmediate& RHICmdList)
+						{
+							FRDGParallelCommandListSet ParallelCommandListSet(RHICmdList, GET_STATID(STAT_CLP_BasePass), *this, View, FParallelCommandListBindings(MultiBasePassParameters));
+							MultiBasePass.DispatchDraw(&ParallelCommandListSet, RHICmdList, &MultiBasePassParameters->InstanceCullingDrawParams);
+						});
+					}
+					//end sjw modify
 				}				
 
 				if (bNaniteEnabled)
@@ -1305,16 +1319,32 @@ void FDeferredShadingSceneRenderer::RenderBasePassInternal(
 							View.ParallelMeshDrawCommandPasses[EMeshPass::BasePass].DispatchDraw(nullptr, RHICmdList, &PassParameters->InstanceCullingDrawParams);
 						}
 					);
-					// GraphBuilder.AddPass(
-					// 	RDG_EVENT_NAME("SecondPass"),
-					// 	PassParameters,
-					// 	ERDGPassFlags::Raster,
-					// 	[this, &View, PassParameters](FRHICommandList& RHICmdList)
-					// 	{
-					// 		SetStereoViewport(RHICmdList, View, 1.0f);
-					// 		View.ParallelMeshDrawCommandPasses[EMeshPass::MultiBasePass].DispatchDraw(nullptr, RHICmdList, &PassParameters->InstanceCullingDrawParams);
-					// 	}
-					// );
+
+					//begin sjw modify
+					// Only materials with bUseMultiBasePass produce commands for this pass, so it is skipped entirely otherwise.
+					FParallelMeshDrawCommandPass& MultiBasePass = View.ParallelMeshDrawCommandPasses[EMeshPass::MultiBasePass];
+					if (MultiBasePass.HasAnyDraw())
+					{
+						FOpaqueBasePassParameters* MultiBasePassParameters = GraphBuilder.AllocParameters<FOpaqueBasePassParameters>();
+						MultiBasePassParameters->BasePass = PassParameters->BasePass;
+						MultiBasePassParameters->RenderTargets = BasePassRenderTargets;
+						MultiBasePassParameters->View = View.GetShaderParameters();
+						MultiBasePassParameters->ReflectionCapture = View.ReflectionCaptureUniformBuffer;
+
+						MultiBasePass.BuildRenderingCommands(GraphBuilder, Scene->GPUScene, MultiBasePassParameters->InstanceCullingDrawParams);
+
+						GraphBuilder.AddPass(
+							RDG_EVENT_NAME("SecondPass"),
+							MultiBasePassParameters,
+							ERDGPassFlags::Raster,
+							[this, &View, &MultiBasePass, MultiBasePassParameters](FRHICommandList& RHICmdList)
+							{
+								SetStereoViewport(RHICmdList, View, 1.0f);
+								MultiBasePass.DispatchDraw(nullptr, RHICmdList, &MultiBasePassParameters->InstanceCullingDrawParams);
+							}
+						);
+					}
+					//end sjw modify
 				}
 
 				if (bNaniteEnabled)
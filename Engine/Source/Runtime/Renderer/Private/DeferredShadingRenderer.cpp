@@ -2965,6 +2965,13 @@ void FDeferredShadingSceneRenderer::Render(FRDGBuilder& GraphBuilder)
 		RenderDeferredReflectionsAndSkyLightingHair(GraphBuilder);
 	}
 
+	//begin sjw modify
+	if (!bHasRayTracedOverlay && !IsForwardShadingEnabled(ShaderPlatform))
+	{
+		RenderToonOutlinePass(GraphBuilder, SceneTextures);
+	}
+	//end sjw modify
+
 	if (bShouldRenderVolumetricCloud && IsVolumetricRenderTargetEnabled() && !bHasHalfResCheckerboardMinMaxDepth && !bHasRayTracedOverlay)
 	{
 		HalfResolutionDepthCheckerboardMinMaxTexture = CreateHalfResolutionDepthCheckerboardMinMax(GraphBuilder, Views, SceneTextures.Depth.Resolve);
@@ -260,10 +260,10 @@ public:
 		bool bDoParallelPass);
 
 	//begin sjw modify
-	void RenderToonDataPass(
+	/** Draws hull-expanded outlines for toon meshes into scene color, with an optional edge detect for distant ones. */
+	void RenderToonOutlinePass(
 		FRDGBuilder& GraphBuilder,
-		FSceneTextures& SceneTextures,
-		bool bDoParallelPass);
+		const FSceneTextures& SceneTextures);
 	//end sjw modify
 
 	void RenderSingleLayerWater(
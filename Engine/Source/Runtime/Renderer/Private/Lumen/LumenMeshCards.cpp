@@ -137,6 +137,7 @@ static TAutoConsoleVariable<float> CVarLumenSurfaceCacheHeightfieldCaptureMargin
 );
 
 extern int32 GLumenSceneUploadEveryFrame;
+extern int32 GLumenSceneParallelUpdate;
 
 namespace LumenMeshCards
 {
@@ -154,7 +155,7 @@ FVector3f LumenMeshCards::GetAxisAlignedDirection(uint32 AxisAlignedDirectionInd
 
 float LumenMeshCards::GetCardMinSurfaceArea(bool bEmissiveLightSource)
 {
-	const float MeshCardsMinSize = CVarLumenMeshCardsMinSize.GetValueOnRenderThread();
+	const float MeshCardsMinSize = CVarLumenMeshCardsMinSize.GetValueOnAnyThread();
 	return MeshCardsMinSize * MeshCardsMinSize * (bEmissiveLightSource ? 0.2f : 1.0f);
 }
 
@@ -575,7 +576,7 @@ void BuildMeshCardsDataForHeightfield(const FLumenPrimitiveGroup& PrimitiveGroup
 	MeshCardsLocalToWorld = Proxy->GetLocalToWorld();
 
 	// Make sure that the card isn't placed directly on the geometry
-	const FVector BoundsMargin = FVector(CVarLumenSurfaceCacheHeightfieldCaptureMargin.GetValueOnRenderThread()) / MeshCardsLocalToWorld.GetScaleVector();
+	const FVector BoundsMargin = FVector(CVarLumenSurfaceCacheHeightfieldCaptureMargin.GetValueOnAnyThread()) / MeshCardsLocalToWorld.GetScaleVector();
 
 	MeshCardsBuildData.MaxLODLevel = 0;
 	MeshCardsBuildData.Bounds = Proxy->GetLocalBounds().GetBox().ExpandBy(BoundsMargin);
@@ -715,66 +716,6 @@ void BuildMeshCardsDataForMergedInstances(const FLumenPrimitiveGroup& PrimitiveG
 	}
 }
 
-void FLumenSceneData::AddMeshCards(int32 PrimitiveGroupIndex)
-{
-	FLumenPrimitiveGroup& PrimitiveGroup = PrimitiveGroups[PrimitiveGroupIndex];
-
-	if (PrimitiveGroup.MeshCardsIndex < 0)
-	{
-		if (PrimitiveGroup.bHeightfield)
-		{
-			// Landscape component handling
-			FMatrix LocalToWorld;
-			FMeshCardsBuildData MeshCardsBuildData;
-			BuildMeshCardsDataForHeightfield(PrimitiveGroup, MeshCardsBuildData, LocalToWorld);
-
-			AddMeshCardsFromBuildData(PrimitiveGroupIndex, LocalToWorld, MeshCardsBuildData, PrimitiveGroup);
-		}
-		else if (PrimitiveGroup.HasMergedInstances())
-		{
-			// Multiple meshes merged together
-			FMatrix LocalToWorld;
-			FMeshCardsBuildData MeshCardsBuildData;
-			BuildMeshCardsDataForMergedInstances(PrimitiveGroup, MeshCardsBuildData, LocalToWorld);
-
-			AddMeshCardsFromBuildData(PrimitiveGroupIndex, LocalToWorld, MeshCardsBuildData, PrimitiveGroup);
-		}
-		else
-		{
-			// Single mesh
-			ensure(PrimitiveGroup.Primitives.Num() == 1);
-			const FPrimitiveSceneInfo* PrimitiveSceneInfo = PrimitiveGroup.Primitives[0];
-
-			FMatrix LocalToWorld = PrimitiveSceneInfo->Proxy->GetLocalToWorld();
-			const TConstArrayView<FPrimitiveInstance> InstanceSceneData = PrimitiveSceneInfo->Proxy->GetInstanceSceneData();
-
-			if (InstanceSceneData.Num() > 0)
-			{
-				const int32 PrimitiveInstanceIndex = FMath::Clamp(PrimitiveGroup.PrimitiveInstanceIndex, 0, InstanceSceneData.Num() - 1);
-				LocalToWorld = InstanceSceneData[PrimitiveInstanceIndex].LocalToPrimitive.ToMatrix() * LocalToWorld;
-			}
-
-			const FCardRepresentationData* CardRepresentationData = PrimitiveSceneInfo->Proxy->GetMeshCardRepresentation();
-			if (CardRepresentationData)
-			{
-				const FMeshCardsBuildData& MeshCardsBuildData = CardRepresentationData->MeshCardsBuildData;
-				AddMeshCardsFromBuildData(PrimitiveGroupIndex, LocalToWorld, MeshCardsBuildData, PrimitiveGroup);
-			}
-		}
-
-		// Update surface cache mapping
-		for (const FPrimitiveSceneInfo* ScenePrimitive : PrimitiveGroup.Primitives)
-		{
-			PrimitivesToUpdateMeshCards.Add(ScenePrimitive->GetIndex());
-		}
-
-		if (PrimitiveGroup.MeshCardsIndex < 0)
-		{
-			PrimitiveGroup.bValidMeshCards = false;
-		}
-	}
-}
-
 bool IsMatrixOrthogonal(const FMatrix& Matrix)
 {
 	const FVector MatrixScale = Matrix.GetScaleVector();
@@ -811,10 +752,33 @@ bool MeshCardCullTest(const FLumenCardBuildData& CardBuildData, const FVector3f
 	return bCardPassedCulling && bCardPassedLODTest;
 }
 
-void FLumenSceneData::AddMeshCardsFromBuildData(int32 PrimitiveGroupIndex, const FMatrix& LocalToWorld, const FMeshCardsBuildData& MeshCardsBuildData, FLumenPrimitiveGroup& PrimitiveGroup)
+// Everything needed to register the mesh cards of a primitive group, computed without touching the Lumen scene
+struct FLumenMeshCardsAddData
 {
-	PrimitiveGroup.MeshCardsIndex = -1;
-	PrimitiveGroup.HeightfieldIndex = -1;
+	int32 PrimitiveGroupIndex = -1;
+	FMatrix LocalToWorld;
+
+	// Heightfields and merged instances build their card data on the fly, single meshes reference the cooked data
+	FMeshCardsBuildData GeneratedMeshCardsBuildData;
+	const FMeshCardsBuildData* CookedMeshCardsBuildData = nullptr;
+
+	// Build data cards which passed culling, in build data order
+	TArray<int32, TInlineAllocator<8>> CardIndicesInBuildData;
+
+	// Filled in by the serial commit
+	int32 MeshCardsIndex = -1;
+	int32 FirstCardIndex = -1;
+
+	const FMeshCardsBuildData& GetMeshCardsBuildData() const
+	{
+		return CookedMeshCardsBuildData ? *CookedMeshCardsBuildData : GeneratedMeshCardsBuildData;
+	}
+};
+
+void CullMeshCards(const FLumenPrimitiveGroup& PrimitiveGroup, FLumenMeshCardsAddData& AddData)
+{
+	const FMeshCardsBuildData& MeshCardsBuildData = AddData.GetMeshCardsBuildData();
+	const FMatrix& LocalToWorld = AddData.LocalToWorld;
 
 	const FVector3f LocalToWorldScale = (FVector3f)LocalToWorld.GetScaleVector();
 	const FVector3f ScaledBoundSize = (FVector3f)MeshCardsBuildData.Bounds.GetSize() * LocalToWorldScale;
@@ -826,76 +790,170 @@ void FLumenSceneData::AddMeshCardsFromBuildData(int32 PrimitiveGroupIndex, const
 	if (LargestFaceArea > MinFaceSurfaceArea
 		&& IsMatrixOrthogonal(LocalToWorld)) // #lumen_todo: implement card capture for non orthogonal local to world transforms
 	{
-		const int32 NumBuildDataCards = MeshCardsBuildData.CardBuildData.Num();
-
-		uint32 NumCards = 0;
-
-		for (int32 CardIndexInBuildData = 0; CardIndexInBuildData < NumBuildDataCards; ++CardIndexInBuildData)
+		for (int32 CardIndexInBuildData = 0; CardIndexInBuildData < MeshCardsBuildData.CardBuildData.Num(); ++CardIndexInBuildData)
 		{
 			const FLumenCardBuildData& CardBuildData = MeshCardsBuildData.CardBuildData[CardIndexInBuildData];
 
 			if (MeshCardCullTest(CardBuildData, LocalToWorldScale, LODLevel, MinFaceSurfaceArea, CardIndexInBuildData))
 			{
-				++NumCards;
+				AddData.CardIndicesInBuildData.Add(CardIndexInBuildData);
 			}
 		}
+	}
+}
+
+void BuildMeshCardsAddData(const FLumenPrimitiveGroup& PrimitiveGroup, FLumenMeshCardsAddData& AddData)
+{
+	if (PrimitiveGroup.bHeightfield)
+	{
+		// Landscape component handling
+		BuildMeshCardsDataForHeightfield(PrimitiveGroup, AddData.GeneratedMeshCardsBuildData, AddData.LocalToWorld);
+	}
+	else if (PrimitiveGroup.HasMergedInstances())
+	{
+		// Multiple meshes merged together
+		BuildMeshCardsDataForMergedInstances(PrimitiveGroup, AddData.GeneratedMeshCardsBuildData, AddData.LocalToWorld);
+	}
+	else
+	{
+		// Single mesh
+		ensure(PrimitiveGroup.Primitives.Num() == 1);
+		const FPrimitiveSceneInfo* PrimitiveSceneInfo = PrimitiveGroup.Primitives[0];
+
+		AddData.LocalToWorld = PrimitiveSceneInfo->Proxy->GetLocalToWorld();
+		const TConstArrayView<FPrimitiveInstance> InstanceSceneData = PrimitiveSceneInfo->Proxy->GetInstanceSceneData();
+
+		if (InstanceSceneData.Num() > 0)
+		{
+			const int32 PrimitiveInstanceIndex = FMath::Clamp(PrimitiveGroup.PrimitiveInstanceIndex, 0, InstanceSceneData.Num() - 1);
+			AddData.LocalToWorld = InstanceSceneData[PrimitiveInstanceIndex].LocalToPrimitive.ToMatrix() * AddData.LocalToWorld;
+		}
+
+		const FCardRepresentationData* CardRepresentationData = PrimitiveSceneInfo->Proxy->GetMeshCardRepresentation();
+		if (!CardRepresentationData)
+		{
+			return;
+		}
+
+		AddData.CookedMeshCardsBuildData = &CardRepresentationData->MeshCardsBuildData;
+	}
+
+	CullMeshCards(PrimitiveGroup, AddData);
+}
+
+void FLumenSceneData::AddMeshCards(TArrayView<const int32> PrimitiveGroupIndices)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AddMeshCards);
+
+	TArray<FLumenMeshCardsAddData, SceneRenderingAllocator> AddDataArray;
+	AddDataArray.Reserve(PrimitiveGroupIndices.Num());
+
+	for (int32 PrimitiveGroupIndex : PrimitiveGroupIndices)
+	{
+		if (PrimitiveGroups[PrimitiveGroupIndex].MeshCardsIndex < 0)
+		{
+			AddDataArray.AddDefaulted_GetRef().PrimitiveGroupIndex = PrimitiveGroupIndex;
+		}
+	}
 
+	const bool bExecuteInParallel = FApp::ShouldUseThreadingForPerformance() && GLumenSceneParallelUpdate != 0;
+
+	// Card data and culling only read the primitive group and its proxies, so every group can be processed independently
+	ParallelFor(AddDataArray.Num(),
+		[this, &AddDataArray](int32 Index)
+		{
+			FLumenMeshCardsAddData& AddData = AddDataArray[Index];
+			BuildMeshCardsAddData(PrimitiveGroups[AddData.PrimitiveGroupIndex], AddData);
+		},
+		!bExecuteInParallel);
+
+	// Span allocation changes the layout of the scene arrays, so it has to be serial
+	for (FLumenMeshCardsAddData& AddData : AddDataArray)
+	{
+		FLumenPrimitiveGroup& PrimitiveGroup = PrimitiveGroups[AddData.PrimitiveGroupIndex];
+
+		if (PrimitiveGroup.MeshCardsIndex >= 0)
+		{
+			continue;
+		}
+
+		PrimitiveGroup.HeightfieldIndex = -1;
+
+		const int32 NumCards = AddData.CardIndicesInBuildData.Num();
 		if (NumCards > 0)
 		{
-			const int32 FirstCardIndex = Cards.AddSpan(NumCards);
-
-			const int32 MeshCardsIndex = MeshCards.AddSpan(1);
-			PrimitiveGroup.MeshCardsIndex = MeshCardsIndex;
-			FLumenMeshCards& MeshCardsInstance = MeshCards[MeshCardsIndex];
-			MeshCardsInstance.Initialize(
-				LocalToWorld,
-				MeshCardsBuildData.Bounds,
-				PrimitiveGroupIndex,
-				FirstCardIndex,
+			AddData.FirstCardIndex = Cards.AddSpan(NumCards);
+			AddData.MeshCardsIndex = MeshCards.AddSpan(1);
+			PrimitiveGroup.MeshCardsIndex = AddData.MeshCardsIndex;
+
+			MeshCards[AddData.MeshCardsIndex].Initialize(
+				AddData.LocalToWorld,
+				AddData.GetMeshCardsBuildData().Bounds,
+				AddData.PrimitiveGroupIndex,
+				AddData.FirstCardIndex,
 				NumCards,
 				PrimitiveGroup.bFarField,
 				PrimitiveGroup.bHeightfield,
 				PrimitiveGroup.bEmissiveLightSource);
 
-			MeshCardsIndicesToUpdateInBuffer.Add(MeshCardsIndex);
+			MeshCardsIndicesToUpdateInBuffer.Add(AddData.MeshCardsIndex);
 
 			if (PrimitiveGroup.bHeightfield)
 			{
 				const int32 HeightfieldIndex = Heightfields.AddSpan(1);
 				PrimitiveGroup.HeightfieldIndex = HeightfieldIndex;
-				Heightfields[HeightfieldIndex].Initialize(MeshCardsIndex);
+				Heightfields[HeightfieldIndex].Initialize(AddData.MeshCardsIndex);
 
 				HeightfieldIndicesToUpdateInBuffer.Add(HeightfieldIndex);
 			}
 
-			// Add cards
-			int32 LocalCardIndex = 0;
-			for (int32 CardIndexInBuildData = 0; CardIndexInBuildData < NumBuildDataCards; ++CardIndexInBuildData)
-			{	
-				const FLumenCardBuildData& CardBuildData = MeshCardsBuildData.CardBuildData[CardIndexInBuildData];
+			for (int32 CardIndex = AddData.FirstCardIndex; CardIndex < AddData.FirstCardIndex + NumCards; ++CardIndex)
+			{
+				CardIndicesToUpdateInBuffer.Add(CardIndex);
+			}
+		}
+		else
+		{
+			PrimitiveGroup.bValidMeshCards = false;
+		}
 
-				if (MeshCardCullTest(CardBuildData, LocalToWorldScale, LODLevel, MinFaceSurfaceArea, CardIndexInBuildData))
+		// Update surface cache mapping
+		for (const FPrimitiveSceneInfo* ScenePrimitive : PrimitiveGroup.Primitives)
+		{
+			PrimitivesToUpdateMeshCards.Add(ScenePrimitive->GetIndex());
+		}
+	}
+
+	// Each added mesh cards owns a disjoint card span, so cards can be initialized in parallel
+	ParallelFor(AddDataArray.Num(),
+		[this, &AddDataArray](int32 Index)
+		{
+			const FLumenMeshCardsAddData& AddData = AddDataArray[Index];
+
+			if (AddData.MeshCardsIndex >= 0)
+			{
+				const FMeshCardsBuildData& MeshCardsBuildData = AddData.GetMeshCardsBuildData();
+				const FLumenPrimitiveGroup& PrimitiveGroup = PrimitiveGroups[AddData.PrimitiveGroupIndex];
+				FLumenMeshCards& MeshCardsInstance = MeshCards[AddData.MeshCardsIndex];
+
+				for (int32 LocalCardIndex = 0; LocalCardIndex < AddData.CardIndicesInBuildData.Num(); ++LocalCardIndex)
 				{
-					const int32 CardInsertIndex = FirstCardIndex + LocalCardIndex;
+					const int32 CardIndexInBuildData = AddData.CardIndicesInBuildData[LocalCardIndex];
 
-					Cards[CardInsertIndex].Initialize(
+					Cards[AddData.FirstCardIndex + LocalCardIndex].Initialize(
 						PrimitiveGroup.CardResolutionScale,
-						LocalToWorld,
+						AddData.LocalToWorld,
 						MeshCardsInstance,
-						CardBuildData,
+						MeshCardsBuildData.CardBuildData[CardIndexInBuildData],
 						LocalCardIndex,
-						MeshCardsIndex,
+						AddData.MeshCardsIndex,
 						CardIndexInBuildData);
-
-					CardIndicesToUpdateInBuffer.Add(CardInsertIndex);
-
-					++LocalCardIndex;
 				}
-			}
 
-			MeshCardsInstance.UpdateLookup(Cards);
-		}
-	}
+				MeshCardsInstance.UpdateLookup(Cards);
+			}
+		},
+		!bExecuteInParallel);
 }
 
 void FLumenSceneData::RemoveMeshCards(FLumenPrimitiveGroup& PrimitiveGroup)
@@ -936,21 +994,47 @@ void FLumenSceneData::RemoveMeshCards(FLumenPrimitiveGroup& PrimitiveGroup)
 	}
 }
 
-void FLumenSceneData::UpdateMeshCards(const FMatrix& LocalToWorld, int32 MeshCardsIndex, const FMeshCardsBuildData& MeshCardsBuildData)
+void FLumenSceneData::UpdateMeshCards(TArrayView<const FLumenMeshCardsUpdate> MeshCardsUpdates)
 {
-	if (MeshCardsIndex >= 0 && IsMatrixOrthogonal(LocalToWorld))
+	TRACE_CPUPROFILER_EVENT_SCOPE(UpdateMeshCards);
+
+	TArray<FLumenMeshCardsUpdate, SceneRenderingAllocator> ValidUpdates;
+	ValidUpdates.Reserve(MeshCardsUpdates.Num());
+
+	for (const FLumenMeshCardsUpdate& MeshCardsUpdate : MeshCardsUpdates)
 	{
-		FLumenMeshCards& MeshCardsInstance = MeshCards[MeshCardsIndex];
-		MeshCardsInstance.SetTransform(LocalToWorld);
-		MeshCardsIndicesToUpdateInBuffer.Add(MeshCardsIndex);
+		if (MeshCardsUpdate.MeshCardsIndex >= 0 && IsMatrixOrthogonal(MeshCardsUpdate.LocalToWorld))
+		{
+			ValidUpdates.Add(MeshCardsUpdate);
+		}
+	}
+
+	const bool bExecuteInParallel = FApp::ShouldUseThreadingForPerformance() && GLumenSceneParallelUpdate != 0;
 
-		for (uint32 LocalCardIndex = 0; LocalCardIndex < MeshCardsInstance.NumCards; ++LocalCardIndex)
+	// Each mesh cards only touches its own card span
+	ParallelFor(ValidUpdates.Num(),
+		[this, &ValidUpdates](int32 Index)
 		{
-			const uint32 CardIndex = MeshCardsInstance.FirstCardIndex + LocalCardIndex;
-			FLumenCard& Card = Cards[CardIndex];
+			const FLumenMeshCardsUpdate& MeshCardsUpdate = ValidUpdates[Index];
 
-			Card.SetTransform(FMatrix44f(LocalToWorld), MeshCardsInstance);		// LWC_TODO: Precision loss
+			FLumenMeshCards& MeshCardsInstance = MeshCards[MeshCardsUpdate.MeshCardsIndex];
+			MeshCardsInstance.SetTransform(MeshCardsUpdate.LocalToWorld);
 
+			for (uint32 LocalCardIndex = 0; LocalCardIndex < MeshCardsInstance.NumCards; ++LocalCardIndex)
+			{
+				FLumenCard& Card = Cards[MeshCardsInstance.FirstCardIndex + LocalCardIndex];
+				Card.SetTransform(FMatrix44f(MeshCardsUpdate.LocalToWorld), MeshCardsInstance);		// LWC_TODO: Precision loss
+			}
+		},
+		!bExecuteInParallel);
+
+	for (const FLumenMeshCardsUpdate& MeshCardsUpdate : ValidUpdates)
+	{
+		const FLumenMeshCards& MeshCardsInstance = MeshCards[MeshCardsUpdate.MeshCardsIndex];
+		MeshCardsIndicesToUpdateInBuffer.Add(MeshCardsUpdate.MeshCardsIndex);
+
+		for (uint32 CardIndex = MeshCardsInstance.FirstCardIndex; CardIndex < MeshCardsInstance.FirstCardIndex + MeshCardsInstance.NumCards; ++CardIndex)
+		{
 			CardIndicesToUpdateInBuffer.Add(CardIndex);
 		}
 	}
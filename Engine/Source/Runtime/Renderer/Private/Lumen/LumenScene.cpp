@@ -101,7 +101,7 @@ bool FLumenPrimitiveGroup::HasMergedInstances() const
 	return HasInstancesToMerge;
 }
 
-FLumenSurfaceCacheAllocator::FPageBin::FPageBin(FIntPoint InElementSize)
+void FLumenSurfaceCacheAllocator::FPageBin::Init(FIntPoint InElementSize)
 {
 	ensure(InElementSize.GetMax() <= Lumen::PhysicalPageSize);
 	ElementSize = InElementSize;
@@ -110,6 +110,8 @@ FLumenSurfaceCacheAllocator::FPageBin::FPageBin(FIntPoint InElementSize)
 
 void FLumenSurfaceCacheAllocator::Init(FIntPoint PageAtlasSizeInPages)
 {
+	AtlasSizeInPages = PageAtlasSizeInPages;
+
 	PhysicalPageFreeList.SetNum(PageAtlasSizeInPages.X * PageAtlasSizeInPages.Y);
 	for (int32 CoordY = 0; CoordY < PageAtlasSizeInPages.Y; ++CoordY)
 	{
@@ -120,6 +122,54 @@ void FLumenSurfaceCacheAllocator::Init(FIntPoint PageAtlasSizeInPages)
 			PhysicalPageFreeList[PageFreeListIndex].Y = CoordY;
 		}
 	}
+
+	NumBinsPerAxis = FMath::FloorLog2(Lumen::PhysicalPageSize) + 1;
+	PageBins.Reset();
+	PageBins.SetNum(NumBinsPerAxis * NumBinsPerAxis);
+
+	PageBinAllocations.Reset();
+	PageBinAllocations.SetNum(PageAtlasSizeInPages.X * PageAtlasSizeInPages.Y);
+}
+
+int32 FLumenSurfaceCacheAllocator::GetBinIndex(FIntPoint ElementSize) const
+{
+	checkSlow(FMath::IsPowerOfTwo(ElementSize.X) && FMath::IsPowerOfTwo(ElementSize.Y));
+	return FMath::FloorLog2(ElementSize.X) + FMath::FloorLog2(ElementSize.Y) * NumBinsPerAxis;
+}
+
+void FLumenSurfaceCacheAllocator::LinkPartialPage(FPageBin& Bin, int32 PageIndex)
+{
+	FPageBinAllocation& BinAllocation = PageBinAllocations[PageIndex];
+	BinAllocation.PrevPartialPage = INDEX_NONE;
+	BinAllocation.NextPartialPage = Bin.FirstPartialPage;
+
+	if (Bin.FirstPartialPage != INDEX_NONE)
+	{
+		PageBinAllocations[Bin.FirstPartialPage].PrevPartialPage = PageIndex;
+	}
+	Bin.FirstPartialPage = PageIndex;
+}
+
+void FLumenSurfaceCacheAllocator::UnlinkPartialPage(FPageBin& Bin, int32 PageIndex)
+{
+	FPageBinAllocation& BinAllocation = PageBinAllocations[PageIndex];
+
+	if (BinAllocation.PrevPartialPage != INDEX_NONE)
+	{
+		PageBinAllocations[BinAllocation.PrevPartialPage].NextPartialPage = BinAllocation.NextPartialPage;
+	}
+	else
+	{
+		Bin.FirstPartialPage = BinAllocation.NextPartialPage;
+	}
+
+	if (BinAllocation.NextPartialPage != INDEX_NONE)
+	{
+		PageBinAllocations[BinAllocation.NextPartialPage].PrevPartialPage = BinAllocation.PrevPartialPage;
+	}
+
+	BinAllocation.PrevPartialPage = INDEX_NONE;
+	BinAllocation.NextPartialPage = INDEX_NONE;
 }
 
 FIntPoint FLumenSurfaceCacheAllocator::AllocatePhysicalAtlasPage()
@@ -147,68 +197,58 @@ void FLumenSurfaceCacheAllocator::Allocate(const FLumenPageTableEntry& Page, FAl
 {
 	if (Page.IsSubAllocation())
 	{
-		FPageBin* MatchingBin = nullptr;
-
-		for (FPageBin& Bin : PageBins)
-		{
-			if (Bin.ElementSize == Page.SubAllocationSize)
-			{
-				MatchingBin = &Bin;
-				break;
-			}
-		}
+		const int32 BinIndex = GetBinIndex(Page.SubAllocationSize);
+		FPageBin& Bin = PageBins[BinIndex];
 
-		if (!MatchingBin)
+		if (!Bin.IsInitialized())
 		{
-			PageBins.Add(FPageBin(Page.SubAllocationSize));
-			MatchingBin = &PageBins.Last();
+			Bin.Init(Page.SubAllocationSize);
 		}
 
-		FPageBinAllocation* MatchingBinAllocation = nullptr;
-
-		for (FPageBinAllocation& BinAllocation : MatchingBin->BinAllocations)
-		{
-			if (BinAllocation.FreeList.Num() > 0)
-			{
-				MatchingBinAllocation = &BinAllocation;
-				break;
-			}
-		}
+		int32 PageIndex = Bin.FirstPartialPage;
 
-		if (!MatchingBinAllocation)
+		if (PageIndex == INDEX_NONE)
 		{
 			const FIntPoint PageCoord = AllocatePhysicalAtlasPage();
 
 			if (PageCoord.X >= 0 && PageCoord.Y >= 0)
 			{
-				MatchingBin->BinAllocations.AddDefaulted(1);
+				PageIndex = GetPageIndex(PageCoord);
 
-				FPageBinAllocation& NewBinAllocation = MatchingBin->BinAllocations.Last();
-				NewBinAllocation.PageCoord = PageCoord;
+				FPageBinAllocation& NewBinAllocation = PageBinAllocations[PageIndex];
+				NewBinAllocation.BinIndex = BinIndex;
 
-				NewBinAllocation.FreeList.SetNum(MatchingBin->PageSizeInElements.X * MatchingBin->PageSizeInElements.Y);
-				for (int32 ElementsY = 0; ElementsY < MatchingBin->PageSizeInElements.Y; ++ElementsY)
+				const int32 NumElements = Bin.GetNumElements();
+				NewBinAllocation.FreeList.SetNumUninitialized(NumElements, false);
+				for (int32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
 				{
-					for (int32 ElementsX = 0; ElementsX < MatchingBin->PageSizeInElements.X; ++ElementsX)
-					{
-						NewBinAllocation.FreeList[ElementsX + ElementsY * MatchingBin->PageSizeInElements.X] = FIntPoint(ElementsX, ElementsY);
-					}
+					NewBinAllocation.FreeList[ElementIndex] = (uint16)ElementIndex;
 				}
 
-				MatchingBinAllocation = &NewBinAllocation;
+				++Bin.NumPages;
+				Bin.NumFreeElements += NumElements;
+				LinkPartialPage(Bin, PageIndex);
 			}
 		}
 
-		if (MatchingBinAllocation)
+		if (PageIndex != INDEX_NONE)
 		{
-			const FIntPoint ElementCoord = MatchingBinAllocation->FreeList.Last();
-			MatchingBinAllocation->FreeList.Pop();
+			FPageBinAllocation& BinAllocation = PageBinAllocations[PageIndex];
+			const int32 ElementIndex = BinAllocation.FreeList.Pop(false);
+			--Bin.NumFreeElements;
+
+			if (BinAllocation.FreeList.Num() == 0)
+			{
+				UnlinkPartialPage(Bin, PageIndex);
+			}
 
-			const FIntPoint ElementOffset = MatchingBinAllocation->PageCoord * Lumen::PhysicalPageSize + ElementCoord * MatchingBin->ElementSize;
+			const FIntPoint PageCoord = GetPageCoord(PageIndex);
+			const FIntPoint ElementCoord = FIntPoint(ElementIndex % Bin.PageSizeInElements.X, ElementIndex / Bin.PageSizeInElements.X);
+			const FIntPoint ElementOffset = PageCoord * Lumen::PhysicalPageSize + ElementCoord * Bin.ElementSize;
 
-			Allocation.PhysicalPageCoord = MatchingBinAllocation->PageCoord;
+			Allocation.PhysicalPageCoord = PageCoord;
 			Allocation.PhysicalAtlasRect.Min = ElementOffset;
-			Allocation.PhysicalAtlasRect.Max = ElementOffset + MatchingBin->ElementSize;
+			Allocation.PhysicalAtlasRect.Max = ElementOffset + Bin.ElementSize;
 		}
 	}
 	else
@@ -223,44 +263,36 @@ void FLumenSurfaceCacheAllocator::Free(const FLumenPageTableEntry& Page)
 {
 	if (Page.IsSubAllocation())
 	{
-		FPageBin* MatchingBin = nullptr;
-		for (FPageBin& Bin : PageBins)
-		{
-			if (Bin.ElementSize == Page.SubAllocationSize)
-			{
-				MatchingBin = &Bin;
-				break;
-			}
-		}
+		const int32 PageIndex = GetPageIndex(Page.PhysicalPageCoord);
+		FPageBinAllocation& BinAllocation = PageBinAllocations[PageIndex];
 
-		check(MatchingBin);
-		bool bRemoved = false;
+		check(BinAllocation.BinIndex == GetBinIndex(Page.SubAllocationSize));
+		FPageBin& Bin = PageBins[BinAllocation.BinIndex];
 
-		for (int32 AllocationIndex = 0; AllocationIndex < MatchingBin->BinAllocations.Num(); AllocationIndex++)
+		const FIntPoint ElementCoord = (Page.PhysicalAtlasRect.Min - Page.PhysicalPageCoord * Lumen::PhysicalPageSize) / Bin.ElementSize;
+		check(ElementCoord.X >= 0
+			&& ElementCoord.Y >= 0
+			&& ElementCoord.X < Bin.PageSizeInElements.X
+			&& ElementCoord.Y < Bin.PageSizeInElements.Y);
+
+		if (BinAllocation.FreeList.Num() == 0)
 		{
-			FPageBinAllocation& BinAllocation = MatchingBin->BinAllocations[AllocationIndex];
+			LinkPartialPage(Bin, PageIndex);
+		}
 
-			const FIntPoint ElementCoord = (Page.PhysicalAtlasRect.Min - BinAllocation.PageCoord * Lumen::PhysicalPageSize) / MatchingBin->ElementSize;
+		BinAllocation.FreeList.Add((uint16)(ElementCoord.X + ElementCoord.Y * Bin.PageSizeInElements.X));
+		++Bin.NumFreeElements;
 
-			if (ElementCoord.X >= 0
-				&& ElementCoord.Y >= 0
-				&& ElementCoord.X < MatchingBin->PageSizeInElements.X
-				&& ElementCoord.Y < MatchingBin->PageSizeInElements.Y)
-			{
-				BinAllocation.FreeList.Add(ElementCoord);
-
-				if (BinAllocation.FreeList.Num() == MatchingBin->GetNumElements())
-				{
-					FreePhysicalAtlasPage(BinAllocation.PageCoord);
-					MatchingBin->BinAllocations.RemoveAt(AllocationIndex);
-				}
+		if (BinAllocation.FreeList.Num() == Bin.GetNumElements())
+		{
+			UnlinkPartialPage(Bin, PageIndex);
+			BinAllocation.FreeList.Reset();
+			BinAllocation.BinIndex = INDEX_NONE;
 
-				bRemoved = true;
-				break;
-			}
+			--Bin.NumPages;
+			Bin.NumFreeElements -= Bin.GetNumElements();
+			FreePhysicalAtlasPage(Page.PhysicalPageCoord);
 		}
-
-		check(bRemoved);
 	}
 	else
 	{
@@ -287,23 +319,7 @@ bool FLumenSurfaceCacheAllocator::IsSpaceAvailable(const FLumenCard& Card, int32
 	// No free pages, but maybe there's some space in one of the existing bins
 	if (MipMapDesc.bSubAllocation)
 	{
-		const FPageBin* MatchingBin = nullptr;
-
-		for (const FPageBin& Bin : PageBins)
-		{
-			if (Bin.ElementSize == MipMapDesc.Resolution)
-			{
-				for (const FPageBinAllocation& BinAllocation : Bin.BinAllocations)
-				{
-					if (BinAllocation.FreeList.Num() > 0)
-					{
-						return true;
-					}
-				}
-
-				break;
-			}
-		}
+		return PageBins[GetBinIndex(MipMapDesc.Resolution)].FirstPartialPage != INDEX_NONE;
 	}
 
 	return false;
@@ -315,18 +331,17 @@ void FLumenSurfaceCacheAllocator::GetStats(FStats& Stats) const
 
 	for (const FPageBin& Bin : PageBins)
 	{
-		uint32 NumFreeElements = 0;
-
-		for (const FPageBinAllocation& BinAllocation : Bin.BinAllocations)
+		if (!Bin.IsInitialized())
 		{
-			NumFreeElements += BinAllocation.FreeList.Num();
+			continue;
 		}
 
+		const uint32 NumFreeElements = Bin.NumFreeElements;
 		const uint32 NumElementsPerPage = Bin.PageSizeInElements.X * Bin.PageSizeInElements.Y;
-		const uint32 NumElements = Bin.BinAllocations.Num() * NumElementsPerPage - NumFreeElements;
+		const uint32 NumElements = Bin.NumPages * NumElementsPerPage - NumFreeElements;
 
-		Stats.BinNumPages += Bin.BinAllocations.Num();
-		Stats.BinNumWastedPages += Bin.BinAllocations.Num() - FMath::DivideAndRoundUp(NumElements, NumElementsPerPage);
+		Stats.BinNumPages += Bin.NumPages;
+		Stats.BinNumWastedPages += Bin.NumPages - FMath::DivideAndRoundUp(NumElements, NumElementsPerPage);
 		Stats.BinPageFreeTexels += NumFreeElements * Bin.ElementSize.X * Bin.ElementSize.Y;
 
 		if (NumElements > 0)
@@ -334,7 +349,7 @@ void FLumenSurfaceCacheAllocator::GetStats(FStats& Stats) const
 			FBinStats BinStats;
 			BinStats.ElementSize = Bin.ElementSize;
 			BinStats.NumAllocations = NumElements;
-			BinStats.NumPages = Bin.BinAllocations.Num();
+			BinStats.NumPages = Bin.NumPages;
 			Stats.Bins.Add(BinStats);
 		}
 	}
@@ -365,6 +380,123 @@ void FLumenSurfaceCacheAllocator::GetStats(FStats& Stats) const
 	Stats.Bins.Sort(FSortBySize());
 }
 
+void FLumenSurfaceCacheLRU::Clear()
+{
+	Nodes.Reset();
+	Head = INDEX_NONE;
+	Tail = INDEX_NONE;
+	NumPages = 0;
+}
+
+void FLumenSurfaceCacheLRU::Link(uint32 FrameIndex, uint32 PageTableIndex)
+{
+	FNode& Node = Nodes[PageTableIndex];
+
+	// Keep the list sorted even if a caller passes a stale frame index, which only delays eviction of that page
+	if (Tail != INDEX_NONE && int32(FrameIndex - Nodes[Tail].LastFrameUsed) < 0)
+	{
+		FrameIndex = Nodes[Tail].LastFrameUsed;
+	}
+
+	Node.LastFrameUsed = FrameIndex;
+	Node.Prev = Tail;
+	Node.Next = INDEX_NONE;
+	Node.bLinked = true;
+
+	if (Tail != INDEX_NONE)
+	{
+		Nodes[Tail].Next = PageTableIndex;
+	}
+	else
+	{
+		Head = PageTableIndex;
+	}
+	Tail = PageTableIndex;
+
+	++NumPages;
+}
+
+void FLumenSurfaceCacheLRU::Unlink(uint32 PageTableIndex)
+{
+	FNode& Node = Nodes[PageTableIndex];
+
+	if (Node.Prev != INDEX_NONE)
+	{
+		Nodes[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		Head = Node.Next;
+	}
+
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = Node.Prev;
+	}
+	else
+	{
+		Tail = Node.Prev;
+	}
+
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+	Node.bLinked = false;
+
+	--NumPages;
+}
+
+void FLumenSurfaceCacheLRU::Add(uint32 FrameIndex, uint32 PageTableIndex)
+{
+	if (PageTableIndex >= (uint32)Nodes.Num())
+	{
+		Nodes.SetNum(FMath::Max<int32>(PageTableIndex + 1, Nodes.Num() * 2));
+	}
+
+	check(!Nodes[PageTableIndex].bLinked);
+	Link(FrameIndex, PageTableIndex);
+}
+
+void FLumenSurfaceCacheLRU::Update(uint32 FrameIndex, uint32 PageTableIndex)
+{
+	check(IsPresent(PageTableIndex));
+
+	if (Tail != (int32)PageTableIndex)
+	{
+		Unlink(PageTableIndex);
+		Link(FrameIndex, PageTableIndex);
+	}
+	else if (int32(FrameIndex - Nodes[PageTableIndex].LastFrameUsed) > 0)
+	{
+		Nodes[PageTableIndex].LastFrameUsed = FrameIndex;
+	}
+}
+
+void FLumenSurfaceCacheLRU::Remove(uint32 PageTableIndex)
+{
+	if (IsPresent(PageTableIndex))
+	{
+		Unlink(PageTableIndex);
+	}
+}
+
+void FLumenSurfaceCacheLRU::PopOldest(uint32 FrameIndex, uint32 MaxFramesSinceLastUsed, int32 MaxNumPages, TArray<uint32, SceneRenderingAllocator>& OutPageTableIndices)
+{
+	// The list is sorted by last used frame, so the walk stops at the first page which is still in use
+	while (Head != INDEX_NONE && MaxNumPages > 0)
+	{
+		const uint32 PageTableIndex = Head;
+
+		if (uint32(Nodes[PageTableIndex].LastFrameUsed + MaxFramesSinceLastUsed) > FrameIndex)
+		{
+			break;
+		}
+
+		Unlink(PageTableIndex);
+		OutPageTableIndices.Add(PageTableIndex);
+		--MaxNumPages;
+	}
+}
+
 void FLumenSceneData::UploadPageTable(FRDGBuilder& GraphBuilder)
 {
 	SCOPED_DRAW_EVENT(GraphBuilder.RHICmdList, LumenUploadPageTable);
@@ -934,13 +1066,14 @@ void UpdateLumenScenePrimitives(FScene* Scene)
 		TRACE_CPUPROFILER_EVENT_SCOPE(UpdateLumenPrimitives);
 		QUICK_SCOPE_CYCLE_COUNTER(UpdateLumenPrimitives);
 
+		TArray<FLumenMeshCardsUpdate, SceneRenderingAllocator> MeshCardsUpdates;
+
 		for (TSet<FPrimitiveSceneInfo*>::TIterator It(LumenSceneData.PendingUpdateOperations); It; ++It)
 		{
 			FPrimitiveSceneInfo* PrimitiveSceneInfo = *It;
 
 			if (PrimitiveSceneInfo->LumenPrimitiveGroupIndices.Num() > 0)
 			{
-				const FCardRepresentationData* CardRepresentationData = PrimitiveSceneInfo->Proxy->GetMeshCardRepresentation();
 				const FMatrix& PrimitiveToWorld = PrimitiveSceneInfo->Proxy->GetLocalToWorld();
 
 				const TConstArrayView<FPrimitiveInstance> InstanceSceneData = PrimitiveSceneInfo->Proxy->GetInstanceSceneData();
@@ -961,11 +1094,16 @@ void UpdateLumenScenePrimitives(FScene* Scene)
 						}
 
 						PrimitiveGroup.WorldSpaceBoundingBox = WorldSpaceBoundingBox;
-						LumenSceneData.UpdateMeshCards(PrimitiveToWorld, PrimitiveGroup.MeshCardsIndex, CardRepresentationData->MeshCardsBuildData);
+
+						FLumenMeshCardsUpdate& MeshCardsUpdate = MeshCardsUpdates.AddDefaulted_GetRef();
+						MeshCardsUpdate.LocalToWorld = PrimitiveToWorld;
+						MeshCardsUpdate.MeshCardsIndex = PrimitiveGroup.MeshCardsIndex;
 					}
 				}
 			}
 		}
+
+		LumenSceneData.UpdateMeshCards(MeshCardsUpdates);
 	}
 
 	LumenSceneData.ResetAndConsolidate();
@@ -1425,9 +1563,7 @@ void FLumenSceneData::ForceEvictEntireCache()
 {
 	TSparseUniqueList<int32, SceneRenderingAllocator> DirtyCards;
 
-	while (EvictOldestAllocation(/*MaxFramesSinceLastUsed*/ 0, DirtyCards))
-	{
-	}
+	EvictOldestAllocations(/*MaxFramesSinceLastUsed*/ 0, MAX_int32, DirtyCards);
 
 	for (int32 CardIndex : DirtyCards.Array)
 	{
@@ -1439,27 +1575,29 @@ void FLumenSceneData::ForceEvictEntireCache()
 
 bool FLumenSceneData::EvictOldestAllocation(uint32 MaxFramesSinceLastUsed, TSparseUniqueList<int32, SceneRenderingAllocator>& DirtyCards)
 {
-	if (UnlockedAllocationHeap.Num() > 0)
-	{
-		const uint32 PageTableIndex = UnlockedAllocationHeap.Top();
-		const uint32 LastFrameUsed = UnlockedAllocationHeap.GetKey(PageTableIndex);
-
-		if (uint32(LastFrameUsed + MaxFramesSinceLastUsed) <= SurfaceCacheFeedback.GetFrameIndex())
-		{
-			UnlockedAllocationHeap.Pop();
+	return EvictOldestAllocations(MaxFramesSinceLastUsed, /*MaxNumPages*/ 1, DirtyCards) > 0;
+}
 
-			FLumenPageTableEntry& Page = PageTable[PageTableIndex];
-			if (Page.IsMapped())
-			{
-				UnmapSurfaceCachePage(false, Page, PageTableIndex);
-				DirtyCards.Add(Page.CardIndex);
-			}
+/**
+ * Evict up to MaxNumPages pages which weren't used in the last MaxFramesSinceLastUsed frames, oldest first.
+ * Returns the number of evicted pages.
+ */
+int32 FLumenSceneData::EvictOldestAllocations(uint32 MaxFramesSinceLastUsed, int32 MaxNumPages, TSparseUniqueList<int32, SceneRenderingAllocator>& DirtyCards)
+{
+	TArray<uint32, SceneRenderingAllocator> PageTableIndices;
+	UnlockedAllocationHeap.PopOldest(SurfaceCacheFeedback.GetFrameIndex(), MaxFramesSinceLastUsed, MaxNumPages, PageTableIndices);
 
-			return true;
+	for (uint32 PageTableIndex : PageTableIndices)
+	{
+		FLumenPageTableEntry& Page = PageTable[PageTableIndex];
+		if (Page.IsMapped())
+		{
+			UnmapSurfaceCachePage(false, Page, PageTableIndex);
+			DirtyCards.Add(Page.CardIndex);
 		}
 	}
 
-	return false;
+	return PageTableIndices.Num();
 }
 
 void FLumenSceneData::DumpStats(const FDistanceFieldSceneData& DistanceFieldSceneData, bool bDumpMeshDistanceFields, bool bDumpPrimitiveGroups)
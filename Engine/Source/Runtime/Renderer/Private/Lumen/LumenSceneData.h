@@ -337,16 +337,28 @@ public:
 
 private:
 
+	// Physical page split into elements of a single bin
 	struct FPageBinAllocation
 	{
-	public:
-		FIntPoint PageCoord;
-		TArray<FIntPoint> FreeList;
+		// Free elements, as indices into the PageSizeInElements grid of the bin
+		TArray<uint16> FreeList;
+
+		// INDEX_NONE when the page isn't split into elements
+		int32 BinIndex = INDEX_NONE;
+
+		// Intrusive list of the bin's pages with free elements
+		int32 PrevPartialPage = INDEX_NONE;
+		int32 NextPartialPage = INDEX_NONE;
 	};
 
 	struct FPageBin
 	{
-		FPageBin(FIntPoint InElementSize);
+		void Init(FIntPoint InElementSize);
+
+		bool IsInitialized() const
+		{
+			return ElementSize.X > 0;
+		}
 
 		int32 GetNumElements() const
 		{
@@ -356,14 +368,92 @@ private:
 		FIntPoint ElementSize = FIntPoint(0, 0);
 		FIntPoint PageSizeInElements = FIntPoint(0, 0);
 
-		TArray<FPageBinAllocation, TInlineAllocator<16>> BinAllocations;
+		int32 NumPages = 0;
+		int32 NumFreeElements = 0;
+		int32 FirstPartialPage = INDEX_NONE;
 	};
 
+	// Element sizes are powers of two, so bins are indexed directly by their log2
+	int32 GetBinIndex(FIntPoint ElementSize) const;
+
+	int32 GetPageIndex(FIntPoint PageCoord) const
+	{
+		return PageCoord.X + PageCoord.Y * AtlasSizeInPages.X;
+	}
+
+	FIntPoint GetPageCoord(int32 PageIndex) const
+	{
+		return FIntPoint(PageIndex % AtlasSizeInPages.X, PageIndex / AtlasSizeInPages.X);
+	}
+
+	void LinkPartialPage(FPageBin& Bin, int32 PageIndex);
+	void UnlinkPartialPage(FPageBin& Bin, int32 PageIndex);
+
 	FIntPoint AllocatePhysicalAtlasPage();
 	void FreePhysicalAtlasPage(FIntPoint PageCoord);
 
+	FIntPoint AtlasSizeInPages = FIntPoint(0, 0);
+	int32 NumBinsPerAxis = 0;
+
 	TArray<FIntPoint> PhysicalPageFreeList;
 	TArray<FPageBin> PageBins;
+
+	// Indexed by GetPageIndex
+	TArray<FPageBinAllocation> PageBinAllocations;
+};
+
+// Unlocked surface cache pages ordered by the feedback frame they were last used in.
+// Pages are always (re)inserted with the current frame index, so the list is sorted and pages used in the same frame form a contiguous bucket.
+class FLumenSurfaceCacheLRU
+{
+public:
+	void Clear();
+
+	int32 Num() const
+	{
+		return NumPages;
+	}
+
+	// Named like FBinaryHeap::IsPresent, the surface cache feedback touches pages with IsPresent and Update
+	bool IsPresent(uint32 PageTableIndex) const
+	{
+		return PageTableIndex < (uint32)Nodes.Num() && Nodes[PageTableIndex].bLinked;
+	}
+
+	uint32 GetKey(uint32 PageTableIndex) const
+	{
+		checkSlow(IsPresent(PageTableIndex));
+		return Nodes[PageTableIndex].LastFrameUsed;
+	}
+
+	void Add(uint32 FrameIndex, uint32 PageTableIndex);
+
+	// Marks a tracked page as used in FrameIndex, moving it to the back of the list
+	void Update(uint32 FrameIndex, uint32 PageTableIndex);
+
+	// Does nothing if the page isn't tracked
+	void Remove(uint32 PageTableIndex);
+
+	// Removes up to MaxNumPages oldest pages which weren't used in the last MaxFramesSinceLastUsed frames
+	void PopOldest(uint32 FrameIndex, uint32 MaxFramesSinceLastUsed, int32 MaxNumPages, TArray<uint32, SceneRenderingAllocator>& OutPageTableIndices);
+
+private:
+
+	struct FNode
+	{
+		uint32 LastFrameUsed = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		bool bLinked = false;
+	};
+
+	void Link(uint32 FrameIndex, uint32 PageTableIndex);
+	void Unlink(uint32 PageTableIndex);
+
+	TArray<FNode> Nodes;
+	int32 Head = INDEX_NONE;
+	int32 Tail = INDEX_NONE;
+	int32 NumPages = 0;
 };
 
 enum class ESurfaceCacheCompression : uint8
@@ -401,6 +491,13 @@ public:
 	}
 };
 
+// New transform of an already registered FLumenMeshCards
+struct FLumenMeshCardsUpdate
+{
+	FMatrix LocalToWorld;
+	int32 MeshCardsIndex = -1;
+};
+
 class FLumenSceneData
 {
 public:
@@ -492,8 +589,8 @@ public:
 	void RemovePrimitive(FPrimitiveSceneInfo* InPrimitive, int32 PrimitiveIndex);
 	void ResetAndConsolidate();
 
-	void AddMeshCards(int32 PrimitiveGroupIndex);
-	void UpdateMeshCards(const FMatrix& LocalToWorld, int32 MeshCardsIndex, const FMeshCardsBuildData& MeshCardsBuildData);
+	void AddMeshCards(TArrayView<const int32> PrimitiveGroupIndices);
+	void UpdateMeshCards(TArrayView<const FLumenMeshCardsUpdate> MeshCardsUpdates);
 	void RemoveMeshCards(FLumenPrimitiveGroup& PrimitiveGroup);
 
 	void RemoveCardFromAtlas(int32 CardIndex);
@@ -521,6 +618,7 @@ public:
 
 	void ForceEvictEntireCache();
 	bool EvictOldestAllocation(uint32 MaxFramesSinceLastUsed, TSparseUniqueList<int32, SceneRenderingAllocator>& DirtyCards);
+	int32 EvictOldestAllocations(uint32 MaxFramesSinceLastUsed, int32 MaxNumPages, TSparseUniqueList<int32, SceneRenderingAllocator>& DirtyCards);
 
 	uint32 GetSurfaceCacheUpdateFrameIndex() const;
 	void IncrementSurfaceCacheUpdateFrameIndex();
@@ -555,8 +653,6 @@ public:
 
 private:
 
-	void AddMeshCardsFromBuildData(int32 PrimitiveGroupIndex, const FMatrix& LocalToWorld, const FMeshCardsBuildData& MeshCardsBuildData, FLumenPrimitiveGroup& PrimitiveGroup);
-
 	void UnmapSurfaceCachePage(bool bLocked, FLumenPageTableEntry& Page, int32 PageIndex);
 
 	// Frame index used to time-splice various surface cache update operations
@@ -577,7 +673,7 @@ private:
 
 	// List of high res allocated physical pages which can be deallocated on demand, ordered by last used frame
 	// FeedbackFrameIndex, PageTableIndex
-	FBinaryHeap<uint32, uint32> UnlockedAllocationHeap;
+	FLumenSurfaceCacheLRU UnlockedAllocationHeap;
 
 	// List of pages ordered by last captured frame used to periodically recapture pages, or for multi-GPU scenarios,
 	// to track that a page is uninitialized on a particular GPU, and needs to be captured for the first time (indicated
@@ -1621,9 +1621,7 @@ void FLumenSceneData::ProcessLumenSurfaceCacheRequests(
 	if (!Lumen::IsSurfaceCacheFrozen())
 	{
 		uint32 MaxFramesSinceLastUsed = FMath::Max(GSurfaceCacheNumFramesToKeepUnusedPages, 0);
-		while (EvictOldestAllocation(MaxFramesSinceLastUsed, DirtyCards))
-		{
-		}
+		EvictOldestAllocations(MaxFramesSinceLastUsed, MAX_int32, DirtyCards);
 	}
 
 	for (int32 CardIndex : DirtyCards.Array)
@@ -1718,12 +1716,20 @@ void UpdateSurfaceCachePrimitives(
 
 	const int32 MeshCardsToAddPerFrame = GetMaxMeshCardsToAddPerFrame();
 	
-	//调用 AddMeshCards 函数增加 MeshCards，这里最终是调用 AddMeshCardsFromBuildData 函数根据 Offline 生成的 FMeshCardsBuildData 中创建，并且这里也会增加 Card。
+	//调用 AddMeshCards 函数批量增加本帧离 Camera 最近的 MeshCards 以及它们的 Card，分为三个阶段：
+	//1. 并行：根据 Offline 生成的 FMeshCardsBuildData 为每个 PrimitiveGroup 构建添加数据，并剔除 Card；
+	//2. 串行：为 MeshCards、Card 和 Heightfield 分配 Span，这会改变场景数组的布局，所以不能并行；
+	//3. 并行：每个 MeshCards 拥有互不重叠的 Card Span，在各自的 Span 内初始化 Card。
+	TArray<int32, SceneRenderingAllocator> PrimitiveGroupsToAdd;
+	PrimitiveGroupsToAdd.Reserve(FMath::Min(MeshCardsAdds.Num(), MeshCardsToAddPerFrame));
+
 	for (int32 MeshCardsIndex = 0; MeshCardsIndex < FMath::Min(MeshCardsAdds.Num(), MeshCardsToAddPerFrame); ++MeshCardsIndex)
 	{
 		const FMeshCardsAdd& MeshCardsAdd = MeshCardsAdds[MeshCardsIndex];
-		LumenSceneData.AddMeshCards(MeshCardsAdd.PrimitiveGroupIndex);
+		PrimitiveGroupsToAdd.Add(MeshCardsAdd.PrimitiveGroupIndex);
 	}
+
+	LumenSceneData.AddMeshCards(PrimitiveGroupsToAdd);
 }
 
 ////生成 Surface Cache 分配请求
@@ -0,0 +1,574 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	LumenSurfaceCacheAllocatorTests.cpp: Tests of the surface cache physical page and bin allocator.
+=============================================================================*/
+
+#include "RendererPrivate.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformTime.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LumenSurfaceCacheAllocatorTests
+{
+	const FIntPoint FullPageSize = FIntPoint(-1, -1);
+
+	// Random element size with power of two axes from MinCardResolution up to the physical page, or a full page
+	FIntPoint RandomElementSize(FRandomStream& Random, int32 FullPagePercentage)
+	{
+		if (Random.RandRange(0, 99) < FullPagePercentage)
+		{
+			return FullPageSize;
+		}
+
+		const int32 MaxLog2 = FMath::FloorLog2(Lumen::PhysicalPageSize / Lumen::MinCardResolution);
+		FIntPoint ElementSize;
+		do
+		{
+			ElementSize.X = Lumen::MinCardResolution << Random.RandRange(0, MaxLog2);
+			ElementSize.Y = Lumen::MinCardResolution << Random.RandRange(0, MaxLog2);
+		}
+		while (ElementSize.X == Lumen::PhysicalPageSize && ElementSize.Y == Lumen::PhysicalPageSize);
+
+		return ElementSize;
+	}
+
+	int32 GetNumElementsPerPage(FIntPoint ElementSize)
+	{
+		return (Lumen::PhysicalPageSize / ElementSize.X) * (Lumen::PhysicalPageSize / ElementSize.Y);
+	}
+
+	// Reference model of the atlas, tracking which element size every physical page is split into
+	class FReferenceAtlas
+	{
+	public:
+		FReferenceAtlas(FIntPoint InAtlasSizeInPages)
+			: AtlasSizeInPages(InAtlasSizeInPages)
+		{
+			Pages.SetNum(AtlasSizeInPages.X * AtlasSizeInPages.Y);
+
+			const FIntPoint AtlasSizeInCells = AtlasSizeInPages * (Lumen::PhysicalPageSize / Lumen::MinCardResolution);
+			CellsUsed.Init(false, AtlasSizeInCells.X * AtlasSizeInCells.Y);
+		}
+
+		// Returns the page which the allocator is expected to use, INDEX_NONE if it must fail, or MAX_int32 for any free page
+		int32 GetExpectedPageIndex(FIntPoint ElementSize) const
+		{
+			if (ElementSize != FullPageSize)
+			{
+				// Partial pages of a bin are filled most recently linked first
+				const TArray<int32>* Partial = PartialPages.Find(ElementSize);
+				if (Partial && Partial->Num() > 0)
+				{
+					return Partial->Last();
+				}
+			}
+
+			return NumUsedPages < Pages.Num() ? MAX_int32 : INDEX_NONE;
+		}
+
+		bool Add(FAutomationTestBase& Test, const FLumenPageTableEntry& Entry)
+		{
+			const bool bFullPage = !Entry.IsSubAllocation();
+			const FIntPoint ElementSize = bFullPage ? FIntPoint(Lumen::PhysicalPageSize) : Entry.SubAllocationSize;
+			const int32 PageIndex = GetPageIndex(Entry.PhysicalPageCoord);
+			const FIntPoint PageMin = Entry.PhysicalPageCoord * Lumen::PhysicalPageSize;
+			const FIntPoint ElementOffset = Entry.PhysicalAtlasRect.Min - PageMin;
+
+			if (!Test.TestTrue(TEXT("Page inside the atlas"), PageIndex != INDEX_NONE)
+				|| !Test.TestEqual(TEXT("Rect size"), Entry.PhysicalAtlasRect.Size(), ElementSize)
+				|| !Test.TestTrue(TEXT("Rect inside the page"), ElementOffset.X >= 0 && ElementOffset.Y >= 0 && ElementOffset.X + ElementSize.X <= Lumen::PhysicalPageSize && ElementOffset.Y + ElementSize.Y <= Lumen::PhysicalPageSize)
+				|| !Test.TestTrue(TEXT("Rect aligned to the element size"), ElementOffset.X % ElementSize.X == 0 && ElementOffset.Y % ElementSize.Y == 0))
+			{
+				return false;
+			}
+
+			FPage& Page = Pages[PageIndex];
+			if (Page.NumAllocations == 0)
+			{
+				Page.ElementSize = bFullPage ? FullPageSize : ElementSize;
+				++NumUsedPages;
+
+				if (!bFullPage && GetNumElementsPerPage(ElementSize) > 1)
+				{
+					PartialPages.FindOrAdd(ElementSize).Add(PageIndex);
+				}
+			}
+			else if (!Test.TestTrue(TEXT("Page shared by a single bin"), !bFullPage && Page.ElementSize == ElementSize))
+			{
+				return false;
+			}
+
+			++Page.NumAllocations;
+
+			if (!bFullPage && Page.NumAllocations == GetNumElementsPerPage(ElementSize) && Page.NumAllocations > 1)
+			{
+				PartialPages.FindChecked(ElementSize).Remove(PageIndex);
+			}
+
+			return MarkCells(Test, Entry.PhysicalAtlasRect, true);
+		}
+
+		bool Remove(FAutomationTestBase& Test, const FLumenPageTableEntry& Entry)
+		{
+			const bool bFullPage = !Entry.IsSubAllocation();
+			const int32 PageIndex = GetPageIndex(Entry.PhysicalPageCoord);
+			FPage& Page = Pages[PageIndex];
+
+			if (!bFullPage)
+			{
+				const int32 NumElementsPerPage = GetNumElementsPerPage(Page.ElementSize);
+				TArray<int32>& Partial = PartialPages.FindChecked(Page.ElementSize);
+
+				if (Page.NumAllocations == NumElementsPerPage && NumElementsPerPage > 1)
+				{
+					Partial.Add(PageIndex);
+				}
+				else if (Page.NumAllocations == 1)
+				{
+					Partial.Remove(PageIndex);
+				}
+			}
+
+			--Page.NumAllocations;
+			if (Page.NumAllocations == 0)
+			{
+				Page.ElementSize = FullPageSize;
+				--NumUsedPages;
+			}
+
+			return MarkCells(Test, Entry.PhysicalAtlasRect, false);
+		}
+
+		bool CheckStats(FAutomationTestBase& Test, const FLumenSurfaceCacheAllocator& Allocator) const
+		{
+			FLumenSurfaceCacheAllocator::FStats Stats;
+			Allocator.GetStats(Stats);
+
+			TMap<FIntPoint, FLumenSurfaceCacheAllocator::FBinStats> ExpectedBins;
+			uint32 ExpectedBinNumPages = 0;
+			uint32 ExpectedBinPageFreeTexels = 0;
+
+			for (const FPage& Page : Pages)
+			{
+				if (Page.NumAllocations > 0 && Page.ElementSize != FullPageSize)
+				{
+					FLumenSurfaceCacheAllocator::FBinStats* Bin = ExpectedBins.Find(Page.ElementSize);
+					if (!Bin)
+					{
+						Bin = &ExpectedBins.Add(Page.ElementSize);
+						Bin->ElementSize = Page.ElementSize;
+						Bin->NumAllocations = 0;
+						Bin->NumPages = 0;
+					}
+					Bin->NumAllocations += Page.NumAllocations;
+					++Bin->NumPages;
+
+					++ExpectedBinNumPages;
+					ExpectedBinPageFreeTexels += (GetNumElementsPerPage(Page.ElementSize) - Page.NumAllocations) * Page.ElementSize.X * Page.ElementSize.Y;
+				}
+			}
+
+			if (!Test.TestEqual(TEXT("NumFreePages"), Stats.NumFreePages, (uint32)(Pages.Num() - NumUsedPages))
+				|| !Test.TestEqual(TEXT("BinNumPages"), Stats.BinNumPages, ExpectedBinNumPages)
+				|| !Test.TestEqual(TEXT("BinPageFreeTexels"), Stats.BinPageFreeTexels, ExpectedBinPageFreeTexels)
+				|| !Test.TestEqual(TEXT("Num bins"), Stats.Bins.Num(), ExpectedBins.Num()))
+			{
+				return false;
+			}
+
+			for (const FLumenSurfaceCacheAllocator::FBinStats& Bin : Stats.Bins)
+			{
+				const FLumenSurfaceCacheAllocator::FBinStats* ExpectedBin = ExpectedBins.Find(Bin.ElementSize);
+				const FString BinName = FString::Printf(TEXT("Bin %dx%d"), Bin.ElementSize.X, Bin.ElementSize.Y);
+
+				if (!Test.TestNotNull(*BinName, ExpectedBin)
+					|| !Test.TestEqual(*(BinName + TEXT(" NumAllocations")), Bin.NumAllocations, ExpectedBin->NumAllocations)
+					|| !Test.TestEqual(*(BinName + TEXT(" NumPages")), Bin.NumPages, ExpectedBin->NumPages))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		int32 GetPageIndex(FIntPoint PageCoord) const
+		{
+			const bool bInside = PageCoord.X >= 0 && PageCoord.Y >= 0 && PageCoord.X < AtlasSizeInPages.X && PageCoord.Y < AtlasSizeInPages.Y;
+			return bInside ? PageCoord.X + PageCoord.Y * AtlasSizeInPages.X : INDEX_NONE;
+		}
+
+	private:
+		struct FPage
+		{
+			FIntPoint ElementSize = FullPageSize;
+			int32 NumAllocations = 0;
+		};
+
+		bool MarkCells(FAutomationTestBase& Test, const FIntRect& Rect, bool bUsed)
+		{
+			const int32 AtlasSizeInCellsX = AtlasSizeInPages.X * (Lumen::PhysicalPageSize / Lumen::MinCardResolution);
+			const FIntRect CellRect = FIntRect(Rect.Min / Lumen::MinCardResolution, Rect.Max / Lumen::MinCardResolution);
+
+			for (int32 CellY = CellRect.Min.Y; CellY < CellRect.Max.Y; ++CellY)
+			{
+				for (int32 CellX = CellRect.Min.X; CellX < CellRect.Max.X; ++CellX)
+				{
+					FBitReference Cell = CellsUsed[CellX + CellY * AtlasSizeInCellsX];
+					if (!Test.TestTrue(bUsed ? TEXT("Rect doesn't overlap live allocations") : TEXT("Freed rect was allocated"), Cell != bUsed))
+					{
+						return false;
+					}
+					Cell = bUsed;
+				}
+			}
+			return true;
+		}
+
+		FIntPoint AtlasSizeInPages;
+		TArray<FPage> Pages;
+		int32 NumUsedPages = 0;
+		TMap<FIntPoint, TArray<int32>> PartialPages;
+		TBitArray<> CellsUsed;
+	};
+
+	FLumenPageTableEntry MakeEntry(FIntPoint ElementSize, const FLumenSurfaceCacheAllocator::FAllocation& Allocation)
+	{
+		FLumenPageTableEntry Entry;
+		Entry.SubAllocationSize = ElementSize;
+		Entry.PhysicalPageCoord = Allocation.PhysicalPageCoord;
+		Entry.PhysicalAtlasRect = Allocation.PhysicalAtlasRect;
+		return Entry;
+	}
+
+	// Bin allocator as it was before the per-bin partial page lists, which searched the pages of a bin oldest first
+	class FOldestPageFirstAllocator
+	{
+	public:
+		void Init(FIntPoint AtlasSizeInPages)
+		{
+			for (int32 PageIndex = AtlasSizeInPages.X * AtlasSizeInPages.Y - 1; PageIndex >= 0; --PageIndex)
+			{
+				FreePages.Add(FIntPoint(PageIndex % AtlasSizeInPages.X, PageIndex / AtlasSizeInPages.X));
+			}
+		}
+
+		void Allocate(const FLumenPageTableEntry& Page, FLumenSurfaceCacheAllocator::FAllocation& Allocation)
+		{
+			FBin* MatchingBin = Bins.FindByPredicate([&Page](const FBin& Bin) { return Bin.ElementSize == Page.SubAllocationSize; });
+			if (!MatchingBin)
+			{
+				MatchingBin = &Bins.AddDefaulted_GetRef();
+				MatchingBin->ElementSize = Page.SubAllocationSize;
+				MatchingBin->PageSizeInElements = FIntPoint(Lumen::PhysicalPageSize) / Page.SubAllocationSize;
+			}
+
+			FBinPage* MatchingPage = MatchingBin->Pages.FindByPredicate([](const FBinPage& BinPage) { return BinPage.FreeList.Num() > 0; });
+			if (!MatchingPage && FreePages.Num() > 0)
+			{
+				MatchingPage = &MatchingBin->Pages.AddDefaulted_GetRef();
+				MatchingPage->PageCoord = FreePages.Pop(false);
+				for (int32 ElementIndex = 0; ElementIndex < MatchingBin->PageSizeInElements.X * MatchingBin->PageSizeInElements.Y; ++ElementIndex)
+				{
+					MatchingPage->FreeList.Add(FIntPoint(ElementIndex % MatchingBin->PageSizeInElements.X, ElementIndex / MatchingBin->PageSizeInElements.X));
+				}
+			}
+
+			if (MatchingPage)
+			{
+				const FIntPoint ElementOffset = MatchingPage->PageCoord * Lumen::PhysicalPageSize + MatchingPage->FreeList.Pop(false) * MatchingBin->ElementSize;
+				Allocation.PhysicalPageCoord = MatchingPage->PageCoord;
+				Allocation.PhysicalAtlasRect = FIntRect(ElementOffset, ElementOffset + MatchingBin->ElementSize);
+			}
+		}
+
+		void Free(const FLumenPageTableEntry& Page)
+		{
+			FBin* MatchingBin = Bins.FindByPredicate([&Page](const FBin& Bin) { return Bin.ElementSize == Page.SubAllocationSize; });
+			for (int32 PageIndex = 0; PageIndex < MatchingBin->Pages.Num(); ++PageIndex)
+			{
+				FBinPage& BinPage = MatchingBin->Pages[PageIndex];
+				if (BinPage.PageCoord == Page.PhysicalPageCoord)
+				{
+					BinPage.FreeList.Add((Page.PhysicalAtlasRect.Min - BinPage.PageCoord * Lumen::PhysicalPageSize) / MatchingBin->ElementSize);
+					if (BinPage.FreeList.Num() == MatchingBin->PageSizeInElements.X * MatchingBin->PageSizeInElements.Y)
+					{
+						FreePages.Add(BinPage.PageCoord);
+						MatchingBin->Pages.RemoveAt(PageIndex);
+					}
+					break;
+				}
+			}
+		}
+
+		void GetBinPages(uint32& OutNumPages, uint32& OutNumWastedPages) const
+		{
+			for (const FBin& Bin : Bins)
+			{
+				const int32 NumElementsPerPage = Bin.PageSizeInElements.X * Bin.PageSizeInElements.Y;
+				int32 NumElements = 0;
+				for (const FBinPage& BinPage : Bin.Pages)
+				{
+					NumElements += NumElementsPerPage - BinPage.FreeList.Num();
+				}
+				OutNumPages += Bin.Pages.Num();
+				OutNumWastedPages += Bin.Pages.Num() - FMath::DivideAndRoundUp(NumElements, NumElementsPerPage);
+			}
+		}
+
+	private:
+		struct FBinPage
+		{
+			FIntPoint PageCoord;
+			TArray<FIntPoint> FreeList;
+		};
+
+		struct FBin
+		{
+			FIntPoint ElementSize;
+			FIntPoint PageSizeInElements;
+			TArray<FBinPage> Pages;
+		};
+
+		TArray<FIntPoint> FreePages;
+		TArray<FBin> Bins;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLumenSurfaceCacheAllocatorTest, "System.Renderer.Lumen.SurfaceCacheAllocator", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLumenSurfaceCacheAllocatorTest::RunTest(const FString& Parameters)
+{
+	using namespace LumenSurfaceCacheAllocatorTests;
+
+	FRandomStream Random(0x4C534341);
+
+	const FIntPoint AtlasSizeInPages = FIntPoint(8, 8);
+	const int32 NumSteps = 20000;
+
+	FLumenSurfaceCacheAllocator Allocator;
+	Allocator.Init(AtlasSizeInPages);
+
+	FReferenceAtlas Reference(AtlasSizeInPages);
+	TArray<FLumenPageTableEntry> Live;
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		// Grow until the atlas is full, then churn around that, so bins run out of free pages and reuse partial ones
+		const bool bAllocate = Live.Num() == 0 || Random.RandRange(0, 99) < 55;
+
+		if (bAllocate)
+		{
+			const FIntPoint ElementSize = RandomElementSize(Random, 10);
+			const int32 ExpectedPageIndex = Reference.GetExpectedPageIndex(ElementSize);
+
+			FLumenPageTableEntry Request;
+			Request.SubAllocationSize = ElementSize;
+
+			FLumenSurfaceCacheAllocator::FAllocation Allocation;
+			Allocator.Allocate(Request, Allocation);
+			const FLumenPageTableEntry Entry = MakeEntry(ElementSize, Allocation);
+
+			if (!TestEqual(TEXT("Allocation succeeded"), Entry.IsMapped(), ExpectedPageIndex != INDEX_NONE))
+			{
+				return false;
+			}
+
+			if (Entry.IsMapped())
+			{
+				if (ExpectedPageIndex != MAX_int32 && !TestEqual(TEXT("Most recently linked partial page reused"), Reference.GetPageIndex(Entry.PhysicalPageCoord), ExpectedPageIndex))
+				{
+					return false;
+				}
+
+				if (!Reference.Add(*this, Entry))
+				{
+					return false;
+				}
+				Live.Add(Entry);
+			}
+		}
+		else
+		{
+			const int32 LiveIndex = Random.RandRange(0, Live.Num() - 1);
+			Allocator.Free(Live[LiveIndex]);
+
+			if (!Reference.Remove(*this, Live[LiveIndex]))
+			{
+				return false;
+			}
+			Live.RemoveAtSwap(LiveIndex, 1, false);
+		}
+
+		if (Step % 64 == 0 && !Reference.CheckStats(*this, Allocator))
+		{
+			return false;
+		}
+	}
+
+	if (!Reference.CheckStats(*this, Allocator))
+	{
+		return false;
+	}
+
+	// Freeing everything has to return every page of every bin to the free list
+	for (const FLumenPageTableEntry& Entry : Live)
+	{
+		Allocator.Free(Entry);
+		if (!Reference.Remove(*this, Entry))
+		{
+			return false;
+		}
+	}
+	Live.Reset();
+
+	FLumenSurfaceCacheAllocator::FStats Stats;
+	Allocator.GetStats(Stats);
+	TestEqual(TEXT("NumFreePages after freeing everything"), Stats.NumFreePages, (uint32)(AtlasSizeInPages.X * AtlasSizeInPages.Y));
+	TestEqual(TEXT("BinNumPages after freeing everything"), Stats.BinNumPages, 0u);
+	TestEqual(TEXT("BinPageFreeTexels after freeing everything"), Stats.BinPageFreeTexels, 0u);
+	TestEqual(TEXT("Num bins after freeing everything"), Stats.Bins.Num(), 0);
+
+	// And the whole atlas is available again for full pages
+	for (int32 PageIndex = 0; PageIndex < AtlasSizeInPages.X * AtlasSizeInPages.Y; ++PageIndex)
+	{
+		FLumenPageTableEntry Request;
+		FLumenSurfaceCacheAllocator::FAllocation Allocation;
+		Allocator.Allocate(Request, Allocation);
+
+		if (!TestTrue(TEXT("Full page allocation after freeing everything"), Allocation.PhysicalPageCoord.X >= 0 && Allocation.PhysicalPageCoord.Y >= 0)
+			|| !Reference.Add(*this, MakeEntry(FullPageSize, Allocation)))
+		{
+			return false;
+		}
+	}
+
+	FLumenPageTableEntry Request;
+	FLumenSurfaceCacheAllocator::FAllocation Allocation;
+	Allocator.Allocate(Request, Allocation);
+	TestEqual(TEXT("Allocation from a full atlas fails"), Allocation.PhysicalPageCoord, FIntPoint(-1, -1));
+	return true;
+}
+
+// Times sub page allocation churn against the allocator which searched the pages of a bin, and compares the pages the two placements use
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLumenSurfaceCacheAllocatorPerfTest, "System.Renderer.Lumen.SurfaceCacheAllocator.Perf", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLumenSurfaceCacheAllocatorPerfTest::RunTest(const FString& Parameters)
+{
+	using namespace LumenSurfaceCacheAllocatorTests;
+
+	const FIntPoint AtlasSizeInPages = FIntPoint(32, 32);
+	const int32 NumSteps = 400000;
+	const int32 TargetNumLive = 6000;
+
+	// Same requests for both, generated up front: true to allocate a size, false to free a random live allocation
+	struct FRequest
+	{
+		FIntPoint ElementSize;
+		float FreeFraction;
+		bool bAllocate;
+	};
+
+	TArray<FRequest> Requests;
+	{
+		FRandomStream Random(0x4C534341);
+		Requests.SetNumUninitialized(NumSteps);
+		for (FRequest& Request : Requests)
+		{
+			Request.ElementSize = RandomElementSize(Random, 0);
+			Request.FreeFraction = Random.GetFraction();
+			Request.bAllocate = Random.RandRange(0, 99) < 55;
+		}
+	}
+
+	// Stats are sampled once the atlas reached a steady state
+	auto Run = [&Requests, TargetNumLive](auto& Allocator, auto&& GetBinPages, double& OutSeconds, double& OutAverageNumPages, double& OutAverageNumWastedPages)
+	{
+		TArray<FLumenPageTableEntry> Live;
+		Live.Reserve(TargetNumLive * 2);
+		uint64 SumNumPages = 0;
+		uint64 SumNumWastedPages = 0;
+		int32 NumSamples = 0;
+		double Seconds = 0.0;
+
+		for (int32 Step = 0; Step < Requests.Num(); ++Step)
+		{
+			const FRequest& Request = Requests[Step];
+			const bool bAllocate = Live.Num() < TargetNumLive / 2 || (Request.bAllocate == (Live.Num() < TargetNumLive));
+			const double StartTime = FPlatformTime::Seconds();
+
+			if (bAllocate)
+			{
+				FLumenPageTableEntry Entry;
+				Entry.SubAllocationSize = Request.ElementSize;
+
+				FLumenSurfaceCacheAllocator::FAllocation Allocation;
+				Allocator.Allocate(Entry, Allocation);
+				if (Allocation.PhysicalPageCoord.X >= 0)
+				{
+					Live.Add(MakeEntry(Request.ElementSize, Allocation));
+				}
+			}
+			else if (Live.Num() > 0)
+			{
+				const int32 LiveIndex = FMath::Min((int32)(Request.FreeFraction * Live.Num()), Live.Num() - 1);
+				Allocator.Free(Live[LiveIndex]);
+				Live.RemoveAtSwap(LiveIndex, 1, false);
+			}
+
+			Seconds += FPlatformTime::Seconds() - StartTime;
+
+			if (Step >= Requests.Num() / 4 && Step % 100 == 0)
+			{
+				uint32 NumPages = 0;
+				uint32 NumWastedPages = 0;
+				GetBinPages(NumPages, NumWastedPages);
+				SumNumPages += NumPages;
+				SumNumWastedPages += NumWastedPages;
+				++NumSamples;
+			}
+		}
+
+		OutSeconds = Seconds;
+		OutAverageNumPages = SumNumPages / (double)FMath::Max(NumSamples, 1);
+		OutAverageNumWastedPages = SumNumWastedPages / (double)FMath::Max(NumSamples, 1);
+	};
+
+	double Seconds = 0.0;
+	double AverageNumPages = 0.0;
+	double AverageNumWastedPages = 0.0;
+	{
+		FLumenSurfaceCacheAllocator Allocator;
+		Allocator.Init(AtlasSizeInPages);
+		Run(Allocator, [&Allocator](uint32& OutNumPages, uint32& OutNumWastedPages)
+		{
+			FLumenSurfaceCacheAllocator::FStats Stats;
+			Allocator.GetStats(Stats);
+			OutNumPages = Stats.BinNumPages;
+			OutNumWastedPages = Stats.BinNumWastedPages;
+		}, Seconds, AverageNumPages, AverageNumWastedPages);
+	}
+
+	double SecondsOldestFirst = 0.0;
+	double AverageNumPagesOldestFirst = 0.0;
+	double AverageNumWastedPagesOldestFirst = 0.0;
+	{
+		FOldestPageFirstAllocator Allocator;
+		Allocator.Init(AtlasSizeInPages);
+		Run(Allocator, [&Allocator](uint32& OutNumPages, uint32& OutNumWastedPages)
+		{
+			Allocator.GetBinPages(OutNumPages, OutNumWastedPages);
+		}, SecondsOldestFirst, AverageNumPagesOldestFirst, AverageNumWastedPagesOldestFirst);
+	}
+
+	// Most recently linked first and oldest first only place differently when a bin has several partial pages, which should barely change the pages used
+	AddInfo(FString::Printf(TEXT("%d steps around %d sub page allocations in %dx%d pages: allocator %.2f ms using %.1f bin pages (%.1f wasted), oldest page first %.2f ms using %.1f bin pages (%.1f wasted)"),
+		NumSteps, TargetNumLive, AtlasSizeInPages.X, AtlasSizeInPages.Y,
+		Seconds * 1000.0, AverageNumPages, AverageNumWastedPages,
+		SecondsOldestFirst * 1000.0, AverageNumPagesOldestFirst, AverageNumWastedPagesOldestFirst));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
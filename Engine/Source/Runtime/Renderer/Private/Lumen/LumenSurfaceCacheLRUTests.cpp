@@ -0,0 +1,266 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	LumenSurfaceCacheLRUTests.cpp: Tests of the unlocked surface cache page LRU.
+=============================================================================*/
+
+#include "RendererPrivate.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Containers/BinaryHeap.h"
+#include "HAL/PlatformTime.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LumenSurfaceCacheLRUTests
+{
+	// Pages of the reference, ordered by Sequence which grows with every add and touch
+	struct FReferencePage
+	{
+		uint32 LastFrameUsed = 0;
+		uint64 Sequence = 0;
+	};
+
+	bool CheckMatchesReference(FAutomationTestBase& Test, const FLumenSurfaceCacheLRU& LRU, const TMap<uint32, FReferencePage>& Reference, uint32 MaxPageTableIndex)
+	{
+		if (!Test.TestEqual(TEXT("Num"), LRU.Num(), Reference.Num()))
+		{
+			return false;
+		}
+
+		for (uint32 PageTableIndex = 0; PageTableIndex < MaxPageTableIndex; ++PageTableIndex)
+		{
+			const FReferencePage* Page = Reference.Find(PageTableIndex);
+
+			if (!Test.TestEqual(*FString::Printf(TEXT("IsPresent(%u)"), PageTableIndex), LRU.IsPresent(PageTableIndex), Page != nullptr))
+			{
+				return false;
+			}
+
+			if (Page && !Test.TestEqual(*FString::Printf(TEXT("GetKey(%u)"), PageTableIndex), LRU.GetKey(PageTableIndex), Page->LastFrameUsed))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLumenSurfaceCacheLRUTest, "System.Renderer.Lumen.SurfaceCacheLRU", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLumenSurfaceCacheLRUTest::RunTest(const FString& Parameters)
+{
+	using namespace LumenSurfaceCacheLRUTests;
+
+	FMemMark Mark(FMemStack::Get());
+	FRandomStream Random(0x4C52553F);
+
+	const uint32 MaxPageTableIndex = 512;
+	const int32 NumSteps = 20000;
+
+	FLumenSurfaceCacheLRU LRU;
+	TMap<uint32, FReferencePage> Reference;
+	uint32 FrameIndex = 1;
+	uint64 Sequence = 0;
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		const uint32 PageTableIndex = (uint32)Random.RandRange(0, MaxPageTableIndex - 1);
+		const int32 Operation = Random.RandRange(0, 99);
+
+		if (Operation < 5)
+		{
+			FrameIndex += (uint32)Random.RandRange(1, 3);
+		}
+		else if (Operation < 45)
+		{
+			// Add for unlocked pages, touch for pages which were already unlocked, like the feedback does
+			if (LRU.IsPresent(PageTableIndex))
+			{
+				LRU.Update(FrameIndex, PageTableIndex);
+			}
+			else
+			{
+				LRU.Add(FrameIndex, PageTableIndex);
+			}
+
+			FReferencePage& Page = Reference.FindOrAdd(PageTableIndex);
+			Page.LastFrameUsed = FrameIndex;
+			Page.Sequence = ++Sequence;
+		}
+		else if (Operation < 65)
+		{
+			LRU.Remove(PageTableIndex);
+			Reference.Remove(PageTableIndex);
+		}
+		else if (Operation < 70)
+		{
+			const uint32 MaxFramesSinceLastUsed = (uint32)Random.RandRange(0, 8);
+			const int32 MaxNumPages = Random.RandRange(0, 64);
+
+			TArray<uint32, SceneRenderingAllocator> Popped;
+			LRU.PopOldest(FrameIndex, MaxFramesSinceLastUsed, MaxNumPages, Popped);
+
+			// Expected are the least recently used pages which are old enough, oldest first
+			TArray<TPair<uint64, uint32>> Expected;
+			for (const TPair<uint32, FReferencePage>& Pair : Reference)
+			{
+				if (Pair.Value.LastFrameUsed + MaxFramesSinceLastUsed <= FrameIndex)
+				{
+					Expected.Emplace(Pair.Value.Sequence, Pair.Key);
+				}
+			}
+			Expected.Sort([](const TPair<uint64, uint32>& A, const TPair<uint64, uint32>& B) { return A.Key < B.Key; });
+			Expected.SetNum(FMath::Min(Expected.Num(), MaxNumPages));
+
+			if (!TestEqual(TEXT("Num popped"), Popped.Num(), Expected.Num()))
+			{
+				return false;
+			}
+
+			for (int32 Index = 0; Index < Popped.Num(); ++Index)
+			{
+				if (!TestEqual(TEXT("Popped page"), Popped[Index], Expected[Index].Value))
+				{
+					return false;
+				}
+				Reference.Remove(Popped[Index]);
+			}
+		}
+		else if (Operation < 71)
+		{
+			// ForceEvictEntireCache
+			TArray<uint32, SceneRenderingAllocator> Popped;
+			LRU.PopOldest(FrameIndex + 1, 0, MAX_int32, Popped);
+			TestEqual(TEXT("Num force evicted"), Popped.Num(), Reference.Num());
+			Reference.Reset();
+		}
+
+		if (Step % 64 == 0 && !CheckMatchesReference(*this, LRU, Reference, MaxPageTableIndex))
+		{
+			return false;
+		}
+	}
+
+	if (!CheckMatchesReference(*this, LRU, Reference, MaxPageTableIndex))
+	{
+		return false;
+	}
+
+	LRU.Clear();
+	TestEqual(TEXT("Num after Clear"), LRU.Num(), 0);
+	TestFalse(TEXT("IsPresent after Clear"), LRU.IsPresent(0));
+	return true;
+}
+
+// Compares a frame of feedback touches and end of frame eviction against the binary heap the LRU replaced
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLumenSurfaceCacheLRUPerfTest, "System.Renderer.Lumen.SurfaceCacheLRU.Perf", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLumenSurfaceCacheLRUPerfTest::RunTest(const FString& Parameters)
+{
+	FMemMark Mark(FMemStack::Get());
+
+	const uint32 NumPages = 64 * 1024;
+	const uint32 NumFrames = 256;
+	const uint32 NumTouchesPerFrame = NumPages / 8;
+	const uint32 MaxFramesSinceLastUsed = 8;
+	const int32 MaxNumEvictedPerFrame = 1024;
+
+	// Same touches for both, generated up front
+	TArray<uint32> Touches;
+	{
+		FRandomStream Random(0x4C52553F);
+		Touches.SetNumUninitialized(NumFrames * NumTouchesPerFrame);
+		for (uint32& PageTableIndex : Touches)
+		{
+			PageTableIndex = (uint32)Random.RandRange(0, NumPages - 1);
+		}
+	}
+
+	int64 NumEvictedLRU = 0;
+	double SecondsLRU = 0.0;
+	{
+		FLumenSurfaceCacheLRU LRU;
+		for (uint32 PageTableIndex = 0; PageTableIndex < NumPages; ++PageTableIndex)
+		{
+			LRU.Add(0, PageTableIndex);
+		}
+
+		TArray<uint32, SceneRenderingAllocator> Evicted;
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (uint32 FrameIndex = 1; FrameIndex <= NumFrames; ++FrameIndex)
+		{
+			const uint32* FrameTouches = &Touches[(FrameIndex - 1) * NumTouchesPerFrame];
+			for (uint32 TouchIndex = 0; TouchIndex < NumTouchesPerFrame; ++TouchIndex)
+			{
+				if (LRU.IsPresent(FrameTouches[TouchIndex]))
+				{
+					LRU.Update(FrameIndex, FrameTouches[TouchIndex]);
+				}
+			}
+
+			// Evicted pages are reallocated right away, so the cache stays full
+			Evicted.Reset();
+			LRU.PopOldest(FrameIndex, MaxFramesSinceLastUsed, MaxNumEvictedPerFrame, Evicted);
+			for (uint32 PageTableIndex : Evicted)
+			{
+				LRU.Add(FrameIndex, PageTableIndex);
+			}
+			NumEvictedLRU += Evicted.Num();
+		}
+
+		SecondsLRU = FPlatformTime::Seconds() - StartTime;
+	}
+
+	int64 NumEvictedHeap = 0;
+	double SecondsHeap = 0.0;
+	{
+		FBinaryHeap<uint32, uint32> Heap;
+		for (uint32 PageTableIndex = 0; PageTableIndex < NumPages; ++PageTableIndex)
+		{
+			Heap.Add(0, PageTableIndex);
+		}
+
+		TArray<uint32, SceneRenderingAllocator> Evicted;
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (uint32 FrameIndex = 1; FrameIndex <= NumFrames; ++FrameIndex)
+		{
+			const uint32* FrameTouches = &Touches[(FrameIndex - 1) * NumTouchesPerFrame];
+			for (uint32 TouchIndex = 0; TouchIndex < NumTouchesPerFrame; ++TouchIndex)
+			{
+				if (Heap.IsPresent(FrameTouches[TouchIndex]))
+				{
+					Heap.Update(FrameIndex, FrameTouches[TouchIndex]);
+				}
+			}
+
+			Evicted.Reset();
+			while (Heap.Num() > 0 && Evicted.Num() < MaxNumEvictedPerFrame)
+			{
+				const uint32 PageTableIndex = Heap.Top();
+				if (Heap.GetKey(PageTableIndex) + MaxFramesSinceLastUsed > FrameIndex)
+				{
+					break;
+				}
+				Heap.Pop();
+				Evicted.Add(PageTableIndex);
+			}
+			for (uint32 PageTableIndex : Evicted)
+			{
+				Heap.Add(FrameIndex, PageTableIndex);
+			}
+			NumEvictedHeap += Evicted.Num();
+		}
+
+		SecondsHeap = FPlatformTime::Seconds() - StartTime;
+	}
+
+	// Pages with the same last used frame are evicted in another order, so the counts may differ slightly
+	AddInfo(FString::Printf(TEXT("%u pages, %u frames of %u touches: LRU %.2f ms with %lld pages evicted, binary heap %.2f ms with %lld pages evicted"),
+		NumPages, NumFrames, NumTouchesPerFrame, SecondsLRU * 1000.0, NumEvictedLRU, SecondsHeap * 1000.0, NumEvictedHeap));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
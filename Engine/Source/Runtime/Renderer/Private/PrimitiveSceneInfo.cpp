@@ -131,7 +131,9 @@ public:
 			bool bSupportsNaniteRendering = SupportsNaniteRendering(StaticMesh->VertexFactory, PrimitiveSceneProxy, Mesh.MaterialRenderProxy, FeatureLevel);
 			bool bSupportsGPUScene = StaticMesh->VertexFactory->SupportsGPUScene(FeatureLevel);
 			//begin sjw info
-			bool bUseOutline = Material.GetShadingModels().HasAnyShadingModel({MSM_ToonStandard, MSM_ToonSkin ,MSM_ToonHair }) ;
+			bool bIsToonMaterial = IsToonShadingModel(Material.GetShadingModels());
+			bool bUseMultiBasePass = bIsToonMaterial && Material.IsUsedWithMultiBasePass();
+			bool bUseHullOutline = bIsToonMaterial && !IsTranslucentBlendMode(Material.GetBlendMode()) && Material.IsUsedWithToonOutline();
 			//end sjw modify
 
 			FStaticMeshBatchRelevance* StaticMeshRelevance = new(PrimitiveSceneInfo->StaticMeshRelevances) FStaticMeshBatchRelevance(
@@ -142,7 +144,8 @@ public:
 				bUseSingleLayerWaterMaterial,
 				bUseAnisotropy,
 				//begin sjw modify
-				bUseOutline,
+				bUseMultiBasePass,
+				bUseHullOutline,
 				//end sjw modify
 				bSupportsNaniteRendering,
 				bSupportsGPUScene,
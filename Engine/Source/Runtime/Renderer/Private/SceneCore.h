@@ -176,7 +176,8 @@ class FStaticMeshBatchRelevance
 public:
 	FStaticMeshBatchRelevance(const FStaticMeshBatch& StaticMesh, float InScreenSize, bool InbSupportsCachingMeshDrawCommands, bool InbUseSkyMaterial, bool bInUseSingleLayerWaterMaterial, bool bInUseAnisotropy
 		//begin sjw modify
-	, bool bInUseOutline
+	, bool bInUseMultiBasePass
+	, bool bInUseHullOutline
 	, bool bInSupportsNaniteRendering, bool bInSupportsGPUScene, ERHIFeatureLevel::Type FeatureLevel)
 		: Id(StaticMesh.Id)
 		, ScreenSize(InScreenSize)
@@ -194,7 +195,8 @@ public:
 		, bUseHairStrands(StaticMesh.UseForHairStrands(FeatureLevel))
 		, bUseAnisotropy(bInUseAnisotropy)
 	//begin sjw modify
-	, bUseOutline(bInUseOutline)
+	, bUseMultiBasePass(bInUseMultiBasePass)
+	, bUseHullOutline(bInUseHullOutline)
 	//end sjw modify
 		, bRenderToVirtualTexture(StaticMesh.bRenderToVirtualTexture)
 		, RuntimeVirtualTextureMaterialType(StaticMesh.RuntimeVirtualTextureMaterialType)
@@ -237,7 +239,8 @@ public:
 	uint8 bUseSingleLayerWaterMaterial : 1; // Whether this batch uses a water material or not.
 	uint8 bUseHairStrands	: 1; // Whether it contains hair strands geometry.
 	uint8 bUseAnisotropy	: 1; // Whether material uses anisotropy parameter.
-	uint8 bUseOutline	: 1; // Whether material uses outline parameter.
+	uint8 bUseMultiBasePass	: 1; // Whether material opted in to the second base pass.
+	uint8 bUseHullOutline	: 1; // Whether material draws a hull-expanded toon outline.
 
 	/** Whether the mesh batch can be used for rendering to a virtual texture. */
 	uint8 bRenderToVirtualTexture : 1;
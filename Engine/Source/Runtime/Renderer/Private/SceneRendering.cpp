@@ -76,6 +76,8 @@
 #include "RendererOnScreenNotification.h"
 #include "Rendering/NaniteCoarseMeshStreamingManager.h"
 #include "Rendering/NaniteStreamingManager.h"
+#include "ToonBRDFLUT.h"
+#include "ToonOutlineRendering.h"
 
 /*-----------------------------------------------------------------------------
 	Globals
@@ -1840,9 +1842,14 @@ void FViewInfo::SetupUniformBufferParameters(
 
 	ViewUniformShaderParameters.PreIntegratedBRDF = GEngine->PreIntegratedSkinBRDFTexture->GetResource()->TextureRHI;
 	// begin sjw modify
-	ViewUniformShaderParameters.PreIntegratedToonBRDF = GEngine->PreIntegratedToonMetalicTexture != nullptr ? GEngine->PreIntegratedToonMetalicTexture->GetResource()->TextureRHI : GWhiteTexture->TextureRHI;
-	ViewUniformShaderParameters.PreIntegratedToonSkinBRDF = GEngine->PreIntegratedToonSkinBRDFTexture != nullptr ? GEngine->PreIntegratedToonSkinBRDFTexture->GetResource()->TextureRHI : GWhiteTexture->TextureRHI;
-	ViewUniformShaderParameters.PreIntegratedToonRoughnessBRDF = GEngine->PreIntegratedToonRoughnessTexture != nullptr ? GEngine->PreIntegratedToonRoughnessTexture->GetResource()->TextureRHI : GWhiteTexture->TextureRHI;
+	const FToonBRDFLUTs ToonBRDFLUTs = GetToonBRDFLUTs();
+	ViewUniformShaderParameters.PreIntegratedToonBRDF = ToonBRDFLUTs.SpecularBRDF;
+	ViewUniformShaderParameters.PreIntegratedToonSkinBRDF = ToonBRDFLUTs.SkinBRDF;
+	ViewUniformShaderParameters.ToonOutlineMinScreenRadiusSquared = GetToonOutlineMinScreenRadiusSquared(*this);
+	// Streamed in after startup, so the texture or its RHI resource may not be there yet
+	const UTexture2D* ToonRoughnessTexture = GEngine->PreIntegratedToonRoughnessTexture;
+	const FTextureResource* ToonRoughnessResource = ToonRoughnessTexture != nullptr ? ToonRoughnessTexture->GetResource() : nullptr;
+	ViewUniformShaderParameters.PreIntegratedToonRoughnessBRDF = ToonRoughnessResource != nullptr && ToonRoughnessResource->TextureRHI.IsValid() ? ToonRoughnessResource->TextureRHI : GWhiteTexture->TextureRHI;
 	
 	//end sjw modify
 
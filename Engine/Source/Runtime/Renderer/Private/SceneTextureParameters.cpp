@@ -25,8 +25,6 @@ FSceneTextureParameters GetSceneTextureParameters(FRDGBuilder& GraphBuilder, con
 	// when a pass is trying to access a resource before any other pass actually created it.
 	Parameters.GBufferVelocityTexture = GetIfProduced(SceneTextures.Velocity);
 	Parameters.GBufferATexture = GetIfProduced(SceneTextures.GBufferA);
-	//begin sjw modify
-	Parameters.ToonBufferATexture = GetIfProduced(SceneTextures.ToonDataTexture01, SystemTextures.MidGrey);
 	Parameters.GBufferBTexture = GetIfProduced(SceneTextures.GBufferB);
 	Parameters.GBufferCTexture = GetIfProduced(SceneTextures.GBufferC);
 	Parameters.GBufferDTexture = GetIfProduced(SceneTextures.GBufferD);
@@ -50,9 +48,6 @@ FSceneTextureParameters GetSceneTextureParameters(FRDGBuilder& GraphBuilder, TRD
 	Parameters.GBufferDTexture = (*SceneTextureUniformBuffer)->GBufferDTexture;
 	Parameters.GBufferETexture = (*SceneTextureUniformBuffer)->GBufferETexture;
 	Parameters.GBufferFTexture = (*SceneTextureUniformBuffer)->GBufferFTexture;
-	//begin sjw modify
-	Parameters.ToonBufferATexture = (*SceneTextureUniformBuffer)->ToonBufferATexture;
-	//end sjw modify
 	Parameters.GBufferVelocityTexture = (*SceneTextureUniformBuffer)->GBufferVelocityTexture;
 	return Parameters;
 }
@@ -16,9 +16,6 @@ BEGIN_SHADER_PARAMETER_STRUCT(FSceneTextureParameters, )
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferDTexture)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferETexture)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferFTexture)
-//begin sjw modify
-	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, ToonBufferATexture)
-//end sjw modify
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferVelocityTexture)
 END_SHADER_PARAMETER_STRUCT()
 
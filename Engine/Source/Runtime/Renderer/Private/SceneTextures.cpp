@@ -739,7 +739,6 @@ FSceneTextures& FSceneTextures::Create(FRDGBuilder& GraphBuilder, const FSceneTe
 		{
 			const FRDGTextureDesc Desc(FRDGTextureDesc::Create2D(Config.Extent, Config.GBufferA.Format, FClearValueBinding::Transparent, Config.GBufferA.Flags | FlagsToAdd | GFastVRamConfig.GBufferA));
 			SceneTextures.GBufferA = GraphBuilder.CreateTexture(Desc, TEXT("GBufferA"));
-			SceneTextures.ToonDataTexture01 = GraphBuilder.CreateTexture(Desc, TEXT("ToonDataTexture01"));
 		}
 
 		if (Config.GBufferB.Index >= 0)
@@ -973,9 +972,6 @@ void SetupSceneTextureUniformParameters(
 	SceneTextureParameters.SceneColorTexture = SystemTextures.Black;
 	SceneTextureParameters.SceneDepthTexture = SystemTextures.DepthDummy;
 	SceneTextureParameters.GBufferATexture = SystemTextures.Black;
-	//begin sjw modify
-	SceneTextureParameters.ToonBufferATexture = SystemTextures.Black;
-	//end sjw modify
 	SceneTextureParameters.GBufferBTexture = SystemTextures.Black;
 	SceneTextureParameters.GBufferCTexture = SystemTextures.Black;
 	SceneTextureParameters.GBufferDTexture = SystemTextures.Black;
@@ -1005,9 +1001,6 @@ void SetupSceneTextureUniformParameters(
 			if (EnumHasAnyFlags(SetupMode, ESceneTextureSetupMode::GBufferA) && HasBeenProduced(SceneTextures->GBufferA))
 			{
 				SceneTextureParameters.GBufferATexture = SceneTextures->GBufferA;
-				if(HasBeenProduced(SceneTextures->ToonDataTexture01)) {
-					SceneTextureParameters.ToonBufferATexture = SceneTextures->ToonDataTexture01;
-				}
 			}
 
 			if (EnumHasAnyFlags(SetupMode, ESceneTextureSetupMode::GBufferB) && HasBeenProduced(SceneTextures->GBufferB))
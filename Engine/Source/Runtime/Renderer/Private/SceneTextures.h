@@ -160,8 +160,6 @@ struct RENDERER_API FSceneTextures : public FMinimalSceneTextures
 	FRDGTextureRef GBufferD{};
 	FRDGTextureRef GBufferE{};
 	FRDGTextureRef GBufferF{};
-	//begin sjw modify
-	FRDGTextureRef ToonDataTexture01{};
 
 	// Additional Buffer texture used by mobile
 	FRDGTextureMSAA DepthAux{};
@@ -46,6 +46,10 @@
 #include "TemporalAA.h"
 #include "RayTracing/RayTracingInstanceCulling.h"
 #include "RendererModule.h"
+//begin sjw modify
+#include "SceneTextures.h"
+#include "ToonOutlineRendering.h"
+//end sjw modify
 
 /*------------------------------------------------------------------------------
 	Globals
@@ -75,6 +79,16 @@ static FAutoConsoleVariableRef CVarMinScreenRadiusForDepthPrepass(
 	ECVF_RenderThreadSafe
 	);
 
+//begin sjw modify
+float GMinScreenRadiusForToonOutline = 0.02f;
+static FAutoConsoleVariableRef CVarMinScreenRadiusForToonOutline(
+	TEXT("r.Toon.Outline.MinScreenRadius"),
+	GMinScreenRadiusForToonOutline,
+	TEXT("Threshold below which meshes will be culled from the toon hull outline pass."),
+	ECVF_Scalability | ECVF_RenderThreadSafe
+	);
+//end sjw modify
+
 float GMinScreenRadiusForCSMDepth = 0.01f;
 static FAutoConsoleVariableRef CVarMinScreenRadiusForCSMDepth(
 	TEXT("r.MinScreenRadiusForCSMDepth"),
@@ -2519,6 +2533,9 @@ struct FRelevancePacket
 		const bool bMobileBasePassAlwaysUsesCSM = (ShadingPath == EShadingPath::Mobile) && MobileBasePassAlwaysUsesCSM(Scene->GetShaderPlatform());
 		const bool bVelocityPassWritesDepth = Scene->EarlyZPassMode == DDM_AllOpaqueNoVelocity;
 		const bool bHLODActive = Scene->SceneLODHierarchy.IsActive();
+		//begin sjw modify
+		const bool bToonScreenSpaceOutline = UseToonScreenSpaceOutline(FSceneTexturesConfig::Get());
+		//end sjw modify
 		const FHLODVisibilityState* const HLODState = bHLODActive && ViewState ? &ViewState->HLODVisibilityState : nullptr;
 
 		
@@ -2545,6 +2562,9 @@ struct FRelevancePacket
 			const float LODFactorDistanceSquared = DistanceSquared * FMath::Square(ViewData.LODScale);
 			const bool bDrawShadowDepth = FMath::Square(Bounds.BoxSphereBounds.SphereRadius) > ViewData.MinScreenRadiusForCSMDepthSquared * LODFactorDistanceSquared;
 			const bool bDrawDepthOnly = ViewData.bFullEarlyZPass || ((ShadingPath != EShadingPath::Mobile) && (FMath::Square(Bounds.BoxSphereBounds.SphereRadius) > GMinScreenRadiusForDepthPrepass * GMinScreenRadiusForDepthPrepass * LODFactorDistanceSquared));
+			//begin sjw modify
+			const bool bDrawToonHullOutline = ViewRelevance.bUsesToonHullOutline && !bToonScreenSpaceOutline && ShouldDrawToonHullOutline(View, Bounds.BoxSphereBounds);
+			//end sjw modify
 
 			const bool bAddLightmapDensityCommands = View.Family->EngineShowFlags.LightMapDensity && AllowDebugViewmodes();
 
@@ -2679,7 +2699,10 @@ struct FRelevancePacket
 								{
 									DrawCommandPacket.AddCommandsForMesh(PrimitiveIndex, PrimitiveSceneInfo, StaticMeshRelevance, StaticMesh, Scene, bCanCache, EMeshPass::BasePass);
 									//begin sjw modify
-									DrawCommandPacket.AddCommandsForMesh(PrimitiveIndex, PrimitiveSceneInfo, StaticMeshRelevance, StaticMesh, Scene, bCanCache, EMeshPass::MultiBasePass);
+									if (StaticMeshRelevance.bUseMultiBasePass)
+									{
+										DrawCommandPacket.AddCommandsForMesh(PrimitiveIndex, PrimitiveSceneInfo, StaticMeshRelevance, StaticMesh, Scene, bCanCache, EMeshPass::MultiBasePass);
+									}
 									// end sjw modify
 									MarkMask |= EMarkMaskBits::StaticMeshVisibilityMapMask;
 
@@ -2698,9 +2721,10 @@ struct FRelevancePacket
 									DrawCommandPacket.AddCommandsForMesh(PrimitiveIndex, PrimitiveSceneInfo, StaticMeshRelevance, StaticMesh, Scene, bCanCache, EMeshPass::AnisotropyPass);
 								}
 								//begin sjw modify
-								if (StaticMeshRelevance.bUseOutline)
+								// Small on screen toon meshes skip the extra geometry pass and rely on the edge detect fallback.
+								if (StaticMeshRelevance.bUseHullOutline && bDrawToonHullOutline)
 								{
-									DrawCommandPacket.AddCommandsForMesh(PrimitiveIndex, PrimitiveSceneInfo, StaticMeshRelevance, StaticMesh, Scene, bCanCache, EMeshPass::ToonOutline);
+									DrawCommandPacket.AddCommandsForMesh(PrimitiveIndex, PrimitiveSceneInfo, StaticMeshRelevance, StaticMesh, Scene, bCanCache, EMeshPass::ToonHullOutline);
 								}
 								//end sjw modify
 
@@ -3155,10 +3179,20 @@ void ComputeDynamicMeshRelevance(EShadingPath ShadingPath, bool bAddLightmapDens
 				PassMask.Set(EMeshPass::AnisotropyPass);
 				View.NumVisibleDynamicMeshElements[EMeshPass::AnisotropyPass] += NumElements;
 			}
-			if (ViewRelevance.bUsesToonOutline)
+
+			if (ViewRelevance.bUsesMultiBasePass && ShadingPath == EShadingPath::Deferred)
 			{
-				PassMask.Set(EMeshPass::ToonOutline);
-				View.NumVisibleDynamicMeshElements[EMeshPass::ToonOutline] += NumElements;
+				PassMask.Set(EMeshPass::MultiBasePass);
+				View.NumVisibleDynamicMeshElements[EMeshPass::MultiBasePass] += NumElements;
+			}
+
+			if (ViewRelevance.bUsesToonHullOutline && !UseToonScreenSpaceOutline(FSceneTexturesConfig::Get()))
+			{
+				if (ShouldDrawToonHullOutline(View, Bounds.BoxSphereBounds))
+				{
+					PassMask.Set(EMeshPass::ToonHullOutline);
+					View.NumVisibleDynamicMeshElements[EMeshPass::ToonHullOutline] += NumElements;
+				}
 			}
 
 			if (ShadingPath == EShadingPath::Mobile)
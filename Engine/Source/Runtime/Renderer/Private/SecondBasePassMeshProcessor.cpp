@@ -37,32 +37,11 @@ public:
 
 	static bool ShouldCompilePermutation(const FMeshMaterialShaderPermutationParameters& Parameters)
 	{
-		// Compile for default material.
-		const bool bIsDefault = Parameters.MaterialParameters.bIsSpecialEngineMaterial;
-
-		// Compile for masked materials.
-		const bool bIsMasked = !Parameters.MaterialParameters.bWritesEveryPixel;
-
-		// Compile for opaque and two-sided materials.
-		const bool bIsOpaqueAndTwoSided = (Parameters.MaterialParameters.bIsTwoSided && !IsTranslucentBlendMode(Parameters.MaterialParameters.BlendMode));
-
-		// Compile for materials which modify meshes.
-		const bool bMayModifyMeshes = Parameters.MaterialParameters.bMaterialMayModifyMeshPosition;
-
-		const bool bHasPlatformSupport = PlatformSupportsVelocityRendering(Parameters.Platform);
-
-		/**
-		 * Any material with a vertex factory incompatible with base pass velocity generation must generate
-		 * permutations for this shader. Shaders which don't fall into this set are considered "simple" enough
-		 * to swap against the default material. This massively simplifies the calculations.
-		 */
-		const bool bIsSeparateVelocityPassRequired = (bIsDefault || bIsMasked || bIsOpaqueAndTwoSided || bMayModifyMeshes) &&
-			FVelocityRendering::IsSeparateVelocityPassRequiredByVertexFactory(Parameters.Platform, Parameters.VertexFactoryType->SupportsStaticLighting());
-
-		// The material may explicitly override and request that it be rendered into the velocity pass.
-		const bool bIsSeparateVelocityPassRequiredByMaterial = Parameters.MaterialParameters.bIsTranslucencyWritingVelocity;
-
-		return bHasPlatformSupport && (bIsSeparateVelocityPassRequired || bIsSeparateVelocityPassRequiredByMaterial);
+		// Only opaque toon materials which opted in to the second base pass, see FMaterial::IsUsedWithMultiBasePass().
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& Parameters.MaterialParameters.bIsUsedWithMultiBasePass
+			&& IsToonShadingModel(Parameters.MaterialParameters.ShadingModels)
+			&& Parameters.MaterialParameters.BlendMode == BLEND_Opaque;
 	}
 
 	FToon1VS() = default;
@@ -125,12 +104,18 @@ void FSecondBasePassMeshProcessor::AddMeshBatch(
 	const FMaterial& Material = MeshBatch.MaterialRenderProxy->GetMaterialWithFallback(FeatureLevel, FallBackMaterialRenderProxyPtr);
 
 	const EBlendMode BlendMode = Material.GetBlendMode();
-	//const ERasterizerFillMode MeshFillMode = ComputeMeshFillMode(MeshBatch, Material);
-	const ERasterizerFillMode MeshFillMode = ERasterizerFillMode::FM_Wireframe;
+	const FMeshDrawingPolicyOverrideSettings OverrideSettings = ComputeMeshOverrideSettings(MeshBatch);
+	const ERasterizerFillMode MeshFillMode = ComputeMeshFillMode(MeshBatch, Material, OverrideSettings);
 	//const ERasterizerCullMode MeshCullMode = ComputeMeshCullMode(MeshBatch, Material);
 	const ERasterizerCullMode MeshCullMode = ERasterizerCullMode::CM_CCW;
 	const bool bIsTranslucent = IsTranslucentBlendMode(BlendMode);
 
+	// The pass is opt-in per material, so nothing is built or cached for meshes that don't ask for it.
+	if (!Material.IsUsedWithMultiBasePass() || !IsToonShadingModel(Material.GetShadingModels()))
+	{
+		return;
+	}
+
 	if (
 		(!PrimitiveSceneProxy || PrimitiveSceneProxy->ShouldRenderInMainPass())
 		&& ShouldIncludeDomainInMeshPass(Material.GetMaterialDomain())
@@ -0,0 +1,352 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ToonBRDFLUT.cpp: Procedural pre-integrated toon BRDF lookup table.
+=============================================================================*/
+
+#include "ToonBRDFLUT.h"
+#include "RenderResource.h"
+#include "RenderingThread.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#if WITH_EDITOR
+#include "DerivedDataCacheInterface.h"
+#endif
+
+static TAutoConsoleVariable<float> CVarToonBRDFTerminatorSoftnessMin(
+	TEXT("r.Toon.BRDF.TerminatorSoftnessMin"),
+	0.01f,
+	TEXT("Width of the toon diffuse terminator at the hardest end of the LUT, in wrapped NoL units."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarToonBRDFTerminatorSoftnessMax(
+	TEXT("r.Toon.BRDF.TerminatorSoftnessMax"),
+	0.25f,
+	TEXT("Width of the toon diffuse terminator at the softest end of the LUT, in wrapped NoL units."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarToonBRDFSpecularThreshold(
+	TEXT("r.Toon.BRDF.SpecularThreshold"),
+	0.5f,
+	TEXT("Fraction of the GGX peak above which the toon specular band is lit."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarToonBRDFSpecularSoftness(
+	TEXT("r.Toon.BRDF.SpecularSoftness"),
+	0.02f,
+	TEXT("Width of the toon specular band edge, in NoH units."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarToonBRDFSkinScatterWidth(
+	TEXT("r.Toon.BRDF.SkinScatterWidth"),
+	3.0f,
+	TEXT("Width of the wide scattering lobe of the toon skin terminator, relative to the terminator softness."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarToonBRDFSkinScatterWeight(
+	TEXT("r.Toon.BRDF.SkinScatterWeight"),
+	0.4f,
+	TEXT("Weight of the wide scattering lobe in the toon skin terminator, the narrow lobe gets the rest."),
+	ECVF_RenderThreadSafe);
+
+namespace ToonBRDFLUT
+{
+	static constexpr int32 Size = 128;
+	static constexpr int32 NumSamples = 64;
+
+	/** Bump when the bake changes to invalidate cached LUTs in the DDC. */
+	static const TCHAR* DDCVersion = TEXT("2E7B9C14-6A3D-4F58-8D01-B5C3E9A7F264");
+
+	struct FParameters
+	{
+		float TerminatorSoftnessMin = 0.0f;
+		float TerminatorSoftnessMax = 0.0f;
+		float SpecularThreshold = 0.0f;
+		float SpecularSoftness = 0.0f;
+		float SkinScatterWidth = 0.0f;
+		float SkinScatterWeight = 0.0f;
+
+		static FParameters FromCVars()
+		{
+			FParameters Parameters;
+			Parameters.TerminatorSoftnessMin = FMath::Max(CVarToonBRDFTerminatorSoftnessMin.GetValueOnRenderThread(), 0.001f);
+			Parameters.TerminatorSoftnessMax = FMath::Max(CVarToonBRDFTerminatorSoftnessMax.GetValueOnRenderThread(), Parameters.TerminatorSoftnessMin);
+			Parameters.SpecularThreshold = FMath::Clamp(CVarToonBRDFSpecularThreshold.GetValueOnRenderThread(), 0.0f, 1.0f);
+			Parameters.SpecularSoftness = FMath::Max(CVarToonBRDFSpecularSoftness.GetValueOnRenderThread(), 0.001f);
+			Parameters.SkinScatterWidth = FMath::Max(CVarToonBRDFSkinScatterWidth.GetValueOnRenderThread(), 1.0f);
+			Parameters.SkinScatterWeight = FMath::Clamp(CVarToonBRDFSkinScatterWeight.GetValueOnRenderThread(), 0.0f, 1.0f);
+			return Parameters;
+		}
+
+		/** Same LUTs without the filtering, a hard terminator and specular band. Cheap enough to bake on the render thread. */
+		FParameters WithoutFiltering() const
+		{
+			FParameters Parameters = *this;
+			Parameters.TerminatorSoftnessMin = 0.0f;
+			Parameters.TerminatorSoftnessMax = 0.0f;
+			Parameters.SpecularSoftness = 0.0f;
+			return Parameters;
+		}
+
+		bool operator==(const FParameters& Other) const
+		{
+			return TerminatorSoftnessMin == Other.TerminatorSoftnessMin
+				&& TerminatorSoftnessMax == Other.TerminatorSoftnessMax
+				&& SpecularThreshold == Other.SpecularThreshold
+				&& SpecularSoftness == Other.SpecularSoftness
+				&& SkinScatterWidth == Other.SkinScatterWidth
+				&& SkinScatterWeight == Other.SkinScatterWeight;
+		}
+
+		FString GetDDCKey() const
+		{
+			return FString::Printf(TEXT("TOONBRDFLUT_%s_%d_%08x_%08x_%08x_%08x_%08x_%08x"), DDCVersion, Size,
+				FMath::AsUInt(TerminatorSoftnessMin), FMath::AsUInt(TerminatorSoftnessMax),
+				FMath::AsUInt(SpecularThreshold), FMath::AsUInt(SpecularSoftness),
+				FMath::AsUInt(SkinScatterWidth), FMath::AsUInt(SkinScatterWeight));
+		}
+	};
+
+	/** Both single channel LUTs of one bake, Size x Size texels each. */
+	struct FBakedTexels
+	{
+		TArray<uint8> Specular;
+		TArray<uint8> SkinTerminator;
+
+		friend FArchive& operator<<(FArchive& Ar, FBakedTexels& Texels)
+		{
+			return Ar << Texels.Specular << Texels.SkinTerminator;
+		}
+
+		bool IsValid() const
+		{
+			return Specular.Num() == Size * Size && SkinTerminator.Num() == Size * Size;
+		}
+	};
+
+	/** Offsets of the samples spread over +-3 sigma and their gaussian weights normalized to sum to one, 4 samples per vector. */
+	struct FGaussianSamples
+	{
+		alignas(16) float Offsets[NumSamples];
+		alignas(16) float Weights[NumSamples];
+
+		FGaussianSamples()
+		{
+			float WeightSum = 0.0f;
+			for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+			{
+				const float T = ((SampleIndex + 0.5f) / NumSamples) * 6.0f - 3.0f;
+				Offsets[SampleIndex] = T;
+				Weights[SampleIndex] = FMath::Exp(-0.5f * T * T);
+				WeightSum += Weights[SampleIndex];
+			}
+			for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+			{
+				Weights[SampleIndex] /= WeightSum;
+			}
+		}
+	};
+	static_assert(NumSamples % 4 == 0, "Samples are integrated 4 at a time");
+	static const FGaussianSamples GaussianSamples;
+
+	/**
+	 * Integrates a step function over a gaussian footprint centered on X.
+	 * StepFunction takes 4 positions and returns a mask of the lit ones, so every sample is a compare and a select without branches.
+	 */
+	template<typename StepFunctionType>
+	static float IntegrateGaussian(float X, float Sigma, StepFunctionType&& StepFunction)
+	{
+		const VectorRegister VectorX = VectorSetFloat1(X);
+		const VectorRegister VectorSigma = VectorSetFloat1(Sigma);
+		VectorRegister Sum = VectorZero();
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex += 4)
+		{
+			const VectorRegister Offsets = VectorLoadAligned(&GaussianSamples.Offsets[SampleIndex]);
+			const VectorRegister Weights = VectorLoadAligned(&GaussianSamples.Weights[SampleIndex]);
+			const VectorRegister LitMask = StepFunction(VectorMultiplyAdd(Offsets, VectorSigma, VectorX));
+			Sum = VectorAdd(Sum, VectorSelect(LitMask, Weights, VectorZero()));
+		}
+
+		alignas(16) float Sums[4];
+		VectorStoreAligned(Sum, Sums);
+		return (Sums[0] + Sums[1]) + (Sums[2] + Sums[3]);
+	}
+
+	/**
+	 * Hard light/shadow terminator at wrapped NoL 0.5, diffused by a narrow and a wide lobe so the ramp keeps a soft scattered tail into the shadow.
+	 * Rows are indexed by terminator softness rather than metallic: toon skin stores its specular range in the metallic GBuffer channel,
+	 * and the softness it derives from roughness is what widens the terminator.
+	 */
+	static float IntegrateSkinTerminator(float NoL, float Softness, const FParameters& Parameters)
+	{
+		const float Sigma = FMath::Lerp(Parameters.TerminatorSoftnessMin, Parameters.TerminatorSoftnessMax, Softness);
+		const VectorRegister Terminator = VectorSetFloat1(0.5f);
+		const auto Step = [Terminator](const VectorRegister& X) { return VectorCompareGE(X, Terminator); };
+		const float Narrow = IntegrateGaussian(NoL, Sigma, Step);
+		const float Wide = IntegrateGaussian(NoL, Sigma * Parameters.SkinScatterWidth, Step);
+		return FMath::Lerp(Narrow, Wide, Parameters.SkinScatterWeight);
+	}
+
+	/** GGX distribution normalized to its peak and thresholded into a single band, with an anti-aliased edge. */
+	static float IntegrateSpecular(float NoH, float Roughness, const FParameters& Parameters)
+	{
+		const float a2 = FMath::Square(FMath::Max(Roughness * Roughness, 0.02f));
+		const VectorRegister a2Minus1 = VectorSetFloat1(a2 - 1.0f);
+		const VectorRegister a4 = VectorSetFloat1(a2 * a2);
+		const VectorRegister Threshold = VectorSetFloat1(Parameters.SpecularThreshold);
+		return IntegrateGaussian(NoH, Parameters.SpecularSoftness, [a2Minus1, a4, Threshold](const VectorRegister& X)
+		{
+			// a4 / d^2 >= Threshold, with d >= a2 > 0 so the divide can be moved to the right side
+			const VectorRegister ClampedNoH = VectorMin(VectorMax(X, VectorZero()), VectorOne());
+			const VectorRegister d = VectorMultiplyAdd(VectorMultiply(ClampedNoH, ClampedNoH), a2Minus1, VectorOne());
+			return VectorCompareGE(a4, VectorMultiply(Threshold, VectorMultiply(d, d)));
+		});
+	}
+
+	static uint8 ToUNorm8(float Value)
+	{
+		return (uint8)FMath::Clamp<int32>(FMath::RoundToInt(Value * 255.0f), 0, 255);
+	}
+
+	static FBakedTexels Bake(const FParameters& Parameters)
+	{
+		FBakedTexels Texels;
+		Texels.Specular.SetNumUninitialized(Size * Size);
+		Texels.SkinTerminator.SetNumUninitialized(Size * Size);
+
+		ParallelFor(Size, [&Texels, &Parameters](int32 Y)
+		{
+			const float V = (Y + 0.5f) / Size;
+			for (int32 X = 0; X < Size; X++)
+			{
+				const float U = (X + 0.5f) / Size;
+				Texels.Specular[Y * Size + X] = ToUNorm8(IntegrateSpecular(U, V, Parameters));
+				Texels.SkinTerminator[Y * Size + X] = ToUNorm8(IntegrateSkinTerminator(U, V, Parameters));
+			}
+		});
+
+		return Texels;
+	}
+
+	/** Loads the bake from the DDC in the editor, or bakes and stores it there. Runs on a worker thread. */
+	static FBakedTexels BakeCached(const FParameters& Parameters)
+	{
+#if WITH_EDITOR
+		const FString DDCKey = Parameters.GetDDCKey();
+
+		TArray<uint8> CachedData;
+		if (GetDerivedDataCacheRef().GetSynchronous(*DDCKey, CachedData, TEXT("ToonBRDFLUT")))
+		{
+			FBakedTexels Texels;
+			FMemoryReader Ar(CachedData);
+			Ar << Texels;
+			if (!Ar.IsError() && Texels.IsValid())
+			{
+				return Texels;
+			}
+		}
+
+		FBakedTexels Texels = Bake(Parameters);
+
+		TArray<uint8> SaveData;
+		FMemoryWriter Ar(SaveData);
+		Ar << Texels;
+		GetDerivedDataCacheRef().Put(*DDCKey, SaveData, TEXT("ToonBRDFLUT"));
+		return Texels;
+#else
+		return Bake(Parameters);
+#endif
+	}
+}
+
+class FToonBRDFLUTResource : public FRenderResource
+{
+public:
+	FTexture2DRHIRef SpecularTexture;
+	FTexture2DRHIRef SkinTexture;
+
+	/** Parameters of the uploaded textures. */
+	ToonBRDFLUT::FParameters UploadedParameters;
+
+	/** Bake in flight, uploaded by the first GetToonBRDFLUTs after it finished. */
+	TFuture<ToonBRDFLUT::FBakedTexels> PendingBake;
+	ToonBRDFLUT::FParameters PendingParameters;
+
+	void RequestBake(const ToonBRDFLUT::FParameters& Parameters)
+	{
+		PendingParameters = Parameters;
+		PendingBake = Async(EAsyncExecution::ThreadPool, [Parameters]()
+		{
+			return ToonBRDFLUT::BakeCached(Parameters);
+		});
+	}
+
+	static FTexture2DRHIRef CreateTexture(const TCHAR* Name, const TArray<uint8>& Texels)
+	{
+		FRHIResourceCreateInfo CreateInfo(Name);
+		FTexture2DRHIRef NewTexture = RHICreateTexture2D(ToonBRDFLUT::Size, ToonBRDFLUT::Size, PF_G8, 1, 1, TexCreate_ShaderResource, CreateInfo);
+
+		uint32 DestStride = 0;
+		uint8* DestData = (uint8*)RHILockTexture2D(NewTexture, 0, RLM_WriteOnly, DestStride, false);
+		for (int32 Y = 0; Y < ToonBRDFLUT::Size; Y++)
+		{
+			FMemory::Memcpy(DestData + Y * DestStride, &Texels[Y * ToonBRDFLUT::Size], ToonBRDFLUT::Size);
+		}
+		RHIUnlockTexture2D(NewTexture, 0, false);
+
+		return NewTexture;
+	}
+
+	void Upload(const ToonBRDFLUT::FBakedTexels& Texels)
+	{
+		SpecularTexture = CreateTexture(TEXT("ToonSpecularBRDFLUT"), Texels.Specular);
+		SkinTexture = CreateTexture(TEXT("ToonSkinBRDFLUT"), Texels.SkinTerminator);
+	}
+
+	/**
+	 * Uploads unfiltered LUTs as a fallback and starts the first bake in the background, so startup never waits on the integration.
+	 * The fallback keeps UploadedParameters unset, which no clamped cvar value matches, so it is always replaced by a real bake.
+	 */
+	virtual void InitRHI() override
+	{
+		const ToonBRDFLUT::FParameters Parameters = ToonBRDFLUT::FParameters::FromCVars();
+		Upload(ToonBRDFLUT::Bake(Parameters.WithoutFiltering()));
+		UploadedParameters = ToonBRDFLUT::FParameters();
+		RequestBake(Parameters);
+	}
+
+	virtual void ReleaseRHI() override
+	{
+		SpecularTexture.SafeRelease();
+		SkinTexture.SafeRelease();
+	}
+};
+
+static TGlobalResource<FToonBRDFLUTResource> GToonBRDFLUT;
+
+FToonBRDFLUTs GetToonBRDFLUTs()
+{
+	check(IsInRenderingThread());
+
+	const ToonBRDFLUT::FParameters Parameters = ToonBRDFLUT::FParameters::FromCVars();
+	if (!GToonBRDFLUT.PendingBake.IsValid() && !(Parameters == GToonBRDFLUT.UploadedParameters))
+	{
+		GToonBRDFLUT.RequestBake(Parameters);
+	}
+
+	// Bakes land once ready, the fallback or previous LUTs stay bound meanwhile
+	if (GToonBRDFLUT.PendingBake.IsValid() && GToonBRDFLUT.PendingBake.IsReady())
+	{
+		GToonBRDFLUT.Upload(GToonBRDFLUT.PendingBake.Get());
+		GToonBRDFLUT.UploadedParameters = GToonBRDFLUT.PendingParameters;
+		GToonBRDFLUT.PendingBake = TFuture<ToonBRDFLUT::FBakedTexels>();
+	}
+
+	FToonBRDFLUTs LUTs;
+	LUTs.SpecularBRDF = GToonBRDFLUT.SpecularTexture;
+	LUTs.SkinBRDF = GToonBRDFLUT.SkinTexture;
+	return LUTs;
+}
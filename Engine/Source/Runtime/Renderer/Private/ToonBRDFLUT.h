@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHI.h"
+
+struct FToonBRDFLUTs
+{
+	/** Toon specular band indexed by NoH and roughness. */
+	FRHITexture* SpecularBRDF = nullptr;
+	/** Toon skin terminator ramp indexed by wrapped NoL and terminator softness, with a wider scattered tail. */
+	FRHITexture* SkinBRDF = nullptr;
+};
+
+/**
+ * Returns the procedurally baked toon BRDF lookup tables, single channel.
+ * Bakes run on a worker thread and are served from the DDC in the editor. The first one starts with the RHI, with unfiltered
+ * LUTs bound until it lands, later ones after r.Toon.BRDF.* changed keep the previous LUTs bound until they land.
+ * Render thread only.
+ */
+FToonBRDFLUTs GetToonBRDFLUTs();
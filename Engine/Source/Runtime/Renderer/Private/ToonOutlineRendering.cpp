@@ -6,19 +6,74 @@
 #include "MeshPassProcessor.inl"
 #include "ScenePrivate.h"
 #include "DeferredShadingRenderer.h"
+#include "PixelShaderUtils.h"
+#include "SceneTextureParameters.h"
+#include "SceneTextures.h"
+
+DECLARE_GPU_STAT_NAMED(RenderToonHullOutlinePass, TEXT("Render Toon Hull Outline Pass"));
+
+int32 GToonOutlineMethod = 0;
+static FAutoConsoleVariableRef CVarToonOutlineMethod(
+	TEXT("r.Toon.Outline.Method"),
+	GToonOutlineMethod,
+	TEXT("How toon outlines are drawn.\n")
+	TEXT(" 0: hull outline mesh pass, cost scales with toon mesh and triangle count (default)\n")
+	TEXT(" 1: screen space compute pass over depth, GBuffer normals and toon data, cost is fixed per pixel.\n")
+	TEXT("    Falls back to 0 with MSAA or multi-view, where scene color has no UAV."),
+	ECVF_Scalability | ECVF_RenderThreadSafe
+	);
+
+bool UseToonScreenSpaceOutline(const FSceneTexturesConfig& Config)
+{
+	// Mirrors when FMinimalSceneTextures::Create gives scene color TexCreate_UAV.
+	return GToonOutlineMethod == 1
+		&& Config.ShadingPath == EShadingPath::Deferred
+		&& Config.FeatureLevel >= ERHIFeatureLevel::SM5
+		&& Config.NumSamples == 1
+		&& !Config.bRequireMultiView;
+}
 
-DECLARE_GPU_STAT_NAMED(RenderToonOutlinePass, TEXT("Render ToonOutline Pass"));
-
+static float GToonOutlineScreenSpaceWidth = 1.0f;
+static FAutoConsoleVariableRef CVarToonOutlineScreenSpaceWidth(
+	TEXT("r.Toon.Outline.ScreenSpaceWidth"),
+	GToonOutlineScreenSpaceWidth,
+	TEXT("Outline width in pixels when r.Toon.Outline.Method is 1."),
+	ECVF_Scalability | ECVF_RenderThreadSafe
+	);
+
+static int32 GToonOutlineEdgeDetectFallback = 0;
+static FAutoConsoleVariableRef CVarToonOutlineEdgeDetectFallback(
+	TEXT("r.Toon.Outline.EdgeDetectFallback"),
+	GToonOutlineEdgeDetectFallback,
+	TEXT("Whether toon meshes below r.Toon.Outline.MinScreenRadius get a screen space edge detect outline instead of the hull outline."),
+	ECVF_Scalability | ECVF_RenderThreadSafe
+	);
+
+extern float GMinScreenRadiusForToonOutline;
+
+float GetToonOutlineMinScreenRadiusSquared(const FSceneView& View)
+{
+	if (UseToonScreenSpaceOutline(FSceneTexturesConfig::Get()))
+	{
+		return -1.0f;
+	}
+	return FMath::Square(GMinScreenRadiusForToonOutline * View.LODDistanceFactor);
+}
 
+bool ShouldDrawToonHullOutline(const FSceneView& View, const FBoxSphereBounds& Bounds)
+{
+	const float MinScreenRadiusSquared = GetToonOutlineMinScreenRadiusSquared(View);
+	const float DistanceSquared = (Bounds.Origin - View.ViewMatrices.GetViewOrigin()).SizeSquared();
+	return MinScreenRadiusSquared >= 0.0f && FMath::Square(2.0f * Bounds.SphereRadius) > MinScreenRadiusSquared * DistanceSquared;
+}
 
-IMPLEMENT_SHADER_TYPE(, FToonOutlineVS, TEXT("/Engine/Private/ToonDataPassShader.usf"), TEXT("MainVertexShader"), SF_Vertex);
-IMPLEMENT_SHADER_TYPE(, FToonOutlinePS, TEXT("/Engine/Private/ToonDataPassShader.usf"), TEXT("MainPixelShader"), SF_Pixel);
-IMPLEMENT_SHADERPIPELINE_TYPE_VSPS(ToonOutlinePipeline, FToonOutlineVS, FToonOutlinePS, true);
 
-DECLARE_CYCLE_STAT(TEXT("ToonOutlinePass"), STAT_CLP_ToonOutlinePass, STATGROUP_ParallelCommandListMarkers);
+IMPLEMENT_SHADER_TYPE(, FToonHullOutlineVS, TEXT("/Engine/Private/ToonOutlinePassShader.usf"), TEXT("MainVertexShader"), SF_Vertex);
+IMPLEMENT_SHADER_TYPE(, FToonHullOutlinePS, TEXT("/Engine/Private/ToonOutlinePassShader.usf"), TEXT("MainPixelShader"), SF_Pixel);
+IMPLEMENT_SHADERPIPELINE_TYPE_VSPS(ToonHullOutlinePipeline, FToonHullOutlineVS, FToonHullOutlinePS, true);
 
 
-FToonOutlineMeshProcessor::FToonOutlineMeshProcessor(
+FToonHullOutlineMeshProcessor::FToonHullOutlineMeshProcessor(
 	const FScene* Scene, 
 	ERHIFeatureLevel::Type InFeatureLevel,
 	const FSceneView* InViewIfDynamicMeshCommand,
@@ -30,86 +85,19 @@ FToonOutlineMeshProcessor::FToonOutlineMeshProcessor(
 {
 }
 
-
-FMeshPassProcessor* CreateToonOutlinePassProcessor(const FScene* Scene, const FSceneView* InViewIfDynamicMeshCommand, FMeshPassDrawListContext* InDrawListContext)
+FMeshPassProcessor* CreateToonHullOutlinePassProcessor(const FScene* Scene, const FSceneView* InViewIfDynamicMeshCommand, FMeshPassDrawListContext* InDrawListContext)
 {
 	const ERHIFeatureLevel::Type FeatureLevel = Scene ? Scene->GetFeatureLevel() : (InViewIfDynamicMeshCommand ? InViewIfDynamicMeshCommand->GetFeatureLevel() : GMaxRHIFeatureLevel);
 	FMeshPassProcessorRenderState PassDrawRenderState;
 	PassDrawRenderState.SetBlendState(TStaticBlendStateWriteMask<CW_RGBA>::GetRHI());
-	PassDrawRenderState.SetDepthStencilAccess(Scene->DefaultBasePassDepthStencilAccess);
-	PassDrawRenderState.SetDepthStencilState(TStaticDepthStencilState<true, CF_DepthNearOrEqual>::GetRHI());
- 
-	return new(FMemStack::Get()) FToonOutlineMeshProcessor(Scene, FeatureLevel, InViewIfDynamicMeshCommand, PassDrawRenderState, InDrawListContext);
-}
-
-
-
+	// The hull only tests against the scene depth, writing its extruded depth would leak into everything sampling depth afterwards.
+	PassDrawRenderState.SetDepthStencilAccess(FExclusiveDepthStencil::DepthRead_StencilNop);
+	PassDrawRenderState.SetDepthStencilState(TStaticDepthStencilState<false, CF_DepthNearOrEqual>::GetRHI());
 
-bool GetBorderGlowPassShaders(
-	const FMaterial& Material,
-	FVertexFactoryType* VertexFactoryType,
-	TShaderRef<FToonOutlineVS>& VertexShader,
-	TShaderRef<FToonOutlinePS>& PixelShader)
-{
-	FMaterialShaderTypes ShaderTypes;
-	ShaderTypes.PipelineType = &ToonOutlinePipeline;
-	FMaterialShaders Shaders;
-	ShaderTypes.AddShaderType<FToonOutlineVS>();
-	ShaderTypes.AddShaderType<FToonOutlinePS>();
-	if (!Material.TryGetShaders(ShaderTypes, VertexFactoryType, Shaders))
-	{
-		return false;
-	}
- 
-	Shaders.TryGetVertexShader(VertexShader);
-	Shaders.TryGetPixelShader(PixelShader);
-	return true;
+	return new(FMemStack::Get()) FToonHullOutlineMeshProcessor(Scene, FeatureLevel, InViewIfDynamicMeshCommand, PassDrawRenderState, InDrawListContext);
 }
 
-bool FToonOutlineMeshProcessor::Process(
-	const FMeshBatch& MeshBatch,
-	uint64 BatchElementMask,
-	int32 StaticMeshId,
-	const FPrimitiveSceneProxy* RESTRICT PrimitiveSceneProxy,
-	const FMaterialRenderProxy& RESTRICT MaterialRenderProxy,
-	const FMaterial& RESTRICT MaterialResource,
-	ERasterizerFillMode MeshFillMode,
-	ERasterizerCullMode MeshCullMode)
-{
-	const FVertexFactory* VertexFactory = MeshBatch.VertexFactory;
- 
-	TMeshProcessorShaders<
-		FToonOutlineVS,
-		FToonOutlinePS> BorderGlowPassShader;
- 
-	if (!GetBorderGlowPassShaders(MaterialResource, VertexFactory->GetType(), BorderGlowPassShader.VertexShader, BorderGlowPassShader.PixelShader))
-		return false;
-	
-	FMeshMaterialShaderElementData ShaderElementData;
-	ShaderElementData.InitializeMeshMaterialData(ViewIfDynamicMeshCommand, PrimitiveSceneProxy, MeshBatch, StaticMeshId, false);
- 
-	const FMeshDrawCommandSortKey SortKey = CalculateMeshStaticSortKey(BorderGlowPassShader.VertexShader, BorderGlowPassShader.PixelShader);
-	
- 
-	BuildMeshDrawCommands(
-		MeshBatch,
-		BatchElementMask,
-		PrimitiveSceneProxy,
-		MaterialRenderProxy,
-		MaterialResource,
-		PassDrawRenderState,
-		BorderGlowPassShader,
-		MeshFillMode,
-		MeshCullMode,
-		SortKey,
-		EMeshPassFeatures::Default,
-		ShaderElementData);
-	
-	return true;
-}
-
-
-void FToonOutlineMeshProcessor::AddMeshBatch(
+void FToonHullOutlineMeshProcessor::AddMeshBatch(
 	const FMeshBatch& RESTRICT MeshBatch, 
 	uint64 BatchElementMask, 
 	const FPrimitiveSceneProxy* RESTRICT PrimitiveSceneProxy, 
@@ -135,7 +123,7 @@ void FToonOutlineMeshProcessor::AddMeshBatch(
 	}
 }
 
-bool FToonOutlineMeshProcessor::TryAddMeshBatch(
+bool FToonHullOutlineMeshProcessor::TryAddMeshBatch(
 	const FMeshBatch& RESTRICT MeshBatch,
 	uint64 BatchElementMask,
 	const FPrimitiveSceneProxy* RESTRICT PrimitiveSceneProxy,
@@ -143,98 +131,213 @@ bool FToonOutlineMeshProcessor::TryAddMeshBatch(
 	const FMaterialRenderProxy& MaterialRenderProxy,
 	const FMaterial& Material)
 {
-	const EBlendMode BlendMode = Material.GetBlendMode();
-	const bool bIsNotTranslucent = BlendMode == BLEND_Opaque || BlendMode == BLEND_Masked;
-
-	bool bResult = true;
-	if ( bIsNotTranslucent && Material.GetShadingModels().HasAnyShadingModel({ MSM_ToonStandard, MSM_ToonSkin, MSM_ToonHair}))
+	if (IsTranslucentBlendMode(Material.GetBlendMode()) || !Material.IsUsedWithToonOutline() || !IsToonShadingModel(Material.GetShadingModels()))
 	{
-		const FMeshDrawingPolicyOverrideSettings OverrideSettings = ComputeMeshOverrideSettings(MeshBatch);
-		const ERasterizerFillMode MeshFillMode = ComputeMeshFillMode(MeshBatch, Material, OverrideSettings);
-		//const ERasterizerCullMode MeshCullMode = ERasterizerCullMode::CM_CCW;
-		const ERasterizerCullMode MeshCullMode = ComputeMeshCullMode(MeshBatch, Material, OverrideSettings);
+		return true;
+	}
+
+	TMeshProcessorShaders<
+		FToonHullOutlineVS,
+		FToonHullOutlinePS> HullOutlinePassShaders;
 
-		bResult = Process(MeshBatch, BatchElementMask, StaticMeshId, PrimitiveSceneProxy, MaterialRenderProxy, Material, MeshFillMode, MeshCullMode);
+	FMaterialShaderTypes ShaderTypes;
+	ShaderTypes.PipelineType = &ToonHullOutlinePipeline;
+	ShaderTypes.AddShaderType<FToonHullOutlineVS>();
+	ShaderTypes.AddShaderType<FToonHullOutlinePS>();
+
+	FMaterialShaders Shaders;
+	if (!Material.TryGetShaders(ShaderTypes, MeshBatch.VertexFactory->GetType(), Shaders))
+	{
+		return false;
 	}
 
-	return bResult;
+	Shaders.TryGetVertexShader(HullOutlinePassShaders.VertexShader);
+	Shaders.TryGetPixelShader(HullOutlinePassShaders.PixelShader);
+
+	// Only the back faces of the extruded hull are drawn, the front of the mesh then covers everything but the rim.
+	const FMeshDrawingPolicyOverrideSettings OverrideSettings = ComputeMeshOverrideSettings(MeshBatch);
+	const ERasterizerFillMode MeshFillMode = ComputeMeshFillMode(MeshBatch, Material, OverrideSettings);
+	const ERasterizerCullMode MeshCullMode = ComputeMeshCullMode(MeshBatch, Material, OverrideSettings);
+	const ERasterizerCullMode HullCullMode = MeshCullMode == CM_None ? CM_CCW : InverseCullMode(MeshCullMode);
+
+	// Only the default width of the base material is baked into the command, the OutlineWidth output is evaluated by the vertex shader.
+	FToonHullOutlineShaderElementData ShaderElementData(Material.GetToonOutlineWidth());
+	ShaderElementData.InitializeMeshMaterialData(ViewIfDynamicMeshCommand, PrimitiveSceneProxy, MeshBatch, StaticMeshId, false);
+
+	const FMeshDrawCommandSortKey SortKey = CalculateMeshStaticSortKey(HullOutlinePassShaders.VertexShader, HullOutlinePassShaders.PixelShader);
+
+	BuildMeshDrawCommands(
+		MeshBatch,
+		BatchElementMask,
+		PrimitiveSceneProxy,
+		MaterialRenderProxy,
+		Material,
+		PassDrawRenderState,
+		HullOutlinePassShaders,
+		MeshFillMode,
+		HullCullMode,
+		SortKey,
+		EMeshPassFeatures::Default,
+		ShaderElementData);
+
+	return true;
 }
 
-BEGIN_SHADER_PARAMETER_STRUCT(FToonOutlinePassParameters, )
+FRegisterPassProcessorCreateFunction RegisterToonHullOutlinePass(
+	&CreateToonHullOutlinePassProcessor,
+	EShadingPath::Deferred, 
+	EMeshPass::ToonHullOutline, 
+	EMeshPassFlags::CachedMeshCommands | EMeshPassFlags::MainView);
+
+class FToonOutlineEdgeDetectPS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToonOutlineEdgeDetectPS);
+	SHADER_USE_PARAMETER_STRUCT(FToonOutlineEdgeDetectPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+		SHADER_PARAMETER_RDG_UNIFORM_BUFFER(FSceneTextureUniformParameters, SceneTextures)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+};
+
+IMPLEMENT_GLOBAL_SHADER(FToonOutlineEdgeDetectPS, "/Engine/Private/ToonOutlineEdgeDetect.usf", "MainPS", SF_Pixel);
+
+class FToonOutlineScreenSpaceCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FToonOutlineScreenSpaceCS);
+	SHADER_USE_PARAMETER_STRUCT(FToonOutlineScreenSpaceCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FViewUniformShaderParameters, View)
+		SHADER_PARAMETER_RDG_UNIFORM_BUFFER(FSceneTextureUniformParameters, SceneTextures)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, RWSceneColor)
+		SHADER_PARAMETER(float, OutlineWidth)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), GetGroupSize());
+	}
+
+	static int32 GetGroupSize()
+	{
+		return 8;
+	}
+};
+
+IMPLEMENT_GLOBAL_SHADER(FToonOutlineScreenSpaceCS, "/Engine/Private/ToonOutlineEdgeDetect.usf", "MainCS", SF_Compute);
+
+BEGIN_SHADER_PARAMETER_STRUCT(FToonHullOutlinePassParameters, )
 	SHADER_PARAMETER_STRUCT_INCLUDE(FViewShaderParameters, View)
 	SHADER_PARAMETER_STRUCT_INCLUDE(FInstanceCullingDrawParams, InstanceCullingDrawParams)
 	RENDER_TARGET_BINDING_SLOTS()
 END_SHADER_PARAMETER_STRUCT()
 
-void FDeferredShadingSceneRenderer::RenderToonDataPass(
-	FRDGBuilder& GraphBuilder, 
-	FSceneTextures& SceneTextures,
-	bool bDoParallelPass
+void FDeferredShadingSceneRenderer::RenderToonOutlinePass(
+	FRDGBuilder& GraphBuilder,
+	const FSceneTextures& SceneTextures
 )
 {
-	RDG_CSV_STAT_EXCLUSIVE_SCOPE(GraphBuilder, RenderToonOutlinePass);
-	SCOPED_NAMED_EVENT(FDeferredShadingSceneRenderer_RenderToonOutlinePass, FColor::Emerald);
-	SCOPE_CYCLE_COUNTER(STAT_RenderToonOutlinePassDrawTime);
-	RDG_GPU_STAT_SCOPE(GraphBuilder, RenderToonOutlinePass);
+	RDG_CSV_STAT_EXCLUSIVE_SCOPE(GraphBuilder, RenderToonHullOutlinePass);
+	SCOPED_NAMED_EVENT(FDeferredShadingSceneRenderer_RenderToonHullOutlinePass, FColor::Emerald);
+	RDG_GPU_STAT_SCOPE(GraphBuilder, RenderToonHullOutlinePass);
+
+	const bool bScreenSpaceOutline = UseToonScreenSpaceOutline(SceneTextures.Config);
+	check(!bScreenSpaceOutline || EnumHasAnyFlags(SceneTextures.Color.Target->Desc.Flags, TexCreate_UAV));
+
+	// The edge detect writes scene color, so it must not see it through the scene texture uniform buffer.
+	TRDGUniformBufferRef<FSceneTextureUniformParameters> EdgeDetectSceneTextures = nullptr;
+	if (bScreenSpaceOutline || GToonOutlineEdgeDetectFallback)
+	{
+		ESceneTextureSetupMode SetupMode = SceneTextures.SetupMode;
+		EnumRemoveFlags(SetupMode, ESceneTextureSetupMode::SceneColor);
+		EdgeDetectSceneTextures = CreateSceneTextureUniformBuffer(GraphBuilder, FeatureLevel, SetupMode);
+	}
 
 	for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 	{
 		FViewInfo& View = Views[ViewIndex];
 
-		if (View.ShouldRenderView())
+		if (!View.ShouldRenderView())
 		{
-			FParallelMeshDrawCommandPass& ParallelMeshPass = View.ParallelMeshDrawCommandPasses[EMeshPass::ToonOutline];
+			continue;
+		}
 
-			if (!ParallelMeshPass.HasAnyDraw())
-			{
-				continue;
-			}
+		if (bScreenSpaceOutline)
+		{
+			FToonOutlineScreenSpaceCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FToonOutlineScreenSpaceCS::FParameters>();
+			PassParameters->View = View.ViewUniformBuffer;
+			PassParameters->SceneTextures = EdgeDetectSceneTextures;
+			PassParameters->RWSceneColor = GraphBuilder.CreateUAV(SceneTextures.Color.Target);
+			PassParameters->OutlineWidth = FMath::Max(GToonOutlineScreenSpaceWidth, 0.0f);
+
+			TShaderMapRef<FToonOutlineScreenSpaceCS> ComputeShader(View.ShaderMap);
+
+			FComputeShaderUtils::AddPass(
+				GraphBuilder,
+				RDG_EVENT_NAME("ToonOutlineScreenSpace %dx%d", View.ViewRect.Width(), View.ViewRect.Height()),
+				ComputeShader,
+				PassParameters,
+				FComputeShaderUtils::GetGroupCount(View.ViewRect.Size(), FToonOutlineScreenSpaceCS::GetGroupSize()));
+
+			continue;
+		}
 
+		FParallelMeshDrawCommandPass& ParallelMeshPass = View.ParallelMeshDrawCommandPasses[EMeshPass::ToonHullOutline];
+		if (ParallelMeshPass.HasAnyDraw())
+		{
 			View.BeginRenderView();
 
-			auto* PassParameters = GraphBuilder.AllocParameters<FToonOutlinePassParameters>();
+			auto* PassParameters = GraphBuilder.AllocParameters<FToonHullOutlinePassParameters>();
 			PassParameters->View = View.GetShaderParameters();
-			PassParameters->RenderTargets.DepthStencil = FDepthStencilBinding(SceneTextures.Depth.Target, ERenderTargetLoadAction::ELoad, FExclusiveDepthStencil::DepthWrite_StencilWrite);
+			PassParameters->RenderTargets[0] = FRenderTargetBinding(SceneTextures.Color.Target, ERenderTargetLoadAction::ELoad);
+			PassParameters->RenderTargets.DepthStencil = FDepthStencilBinding(SceneTextures.Depth.Target, ERenderTargetLoadAction::ELoad, FExclusiveDepthStencil::DepthRead_StencilNop);
 
 			ParallelMeshPass.BuildRenderingCommands(GraphBuilder, Scene->GPUScene, PassParameters->InstanceCullingDrawParams);
-			if (bDoParallelPass)
-			{
-				AddClearRenderTargetPass(GraphBuilder, SceneTextures.ToonDataTexture01);
-
-				PassParameters->RenderTargets[0] = FRenderTargetBinding(SceneTextures.ToonDataTexture01, ERenderTargetLoadAction::ELoad);
 
-				GraphBuilder.AddPass(
-					RDG_EVENT_NAME("ToonOulinePassParallel"),
-					PassParameters,
-					ERDGPassFlags::Raster | ERDGPassFlags::SkipRenderPass,
-					[this, &View, &ParallelMeshPass, PassParameters](FRHICommandListImmediate& RHICmdList)
-				{
-					FRDGParallelCommandListSet ParallelCommandListSet(RHICmdList, GET_STATID(STAT_CLP_ToonOutlinePass), *this, View, FParallelCommandListBindings(PassParameters));
-
-					ParallelMeshPass.DispatchDraw(&ParallelCommandListSet, RHICmdList, &PassParameters->InstanceCullingDrawParams);
-				});
-			}
-			else
+			GraphBuilder.AddPass(
+				RDG_EVENT_NAME("ToonHullOutlinePass"),
+				PassParameters,
+				ERDGPassFlags::Raster,
+				[this, &View, &ParallelMeshPass, PassParameters](FRHICommandList& RHICmdList)
 			{
-				PassParameters->RenderTargets[0] = FRenderTargetBinding(SceneTextures.ToonDataTexture01, ERenderTargetLoadAction::EClear);
+				SetStereoViewport(RHICmdList, View);
 
-				GraphBuilder.AddPass(
-					RDG_EVENT_NAME("ToonOulinePassParallel"),
-					PassParameters,
-					ERDGPassFlags::Raster,
-					[this, &View, &ParallelMeshPass, PassParameters](FRHICommandList& RHICmdList)
-				{
-					SetStereoViewport(RHICmdList, View);
+				ParallelMeshPass.DispatchDraw(nullptr, RHICmdList, &PassParameters->InstanceCullingDrawParams);
+			});
+		}
 
-					ParallelMeshPass.DispatchDraw(nullptr, RHICmdList, &PassParameters->InstanceCullingDrawParams);
-				});
-			}
+		if (EdgeDetectSceneTextures)
+		{
+			FToonOutlineEdgeDetectPS::FParameters* PassParameters = GraphBuilder.AllocParameters<FToonOutlineEdgeDetectPS::FParameters>();
+			PassParameters->View = View.ViewUniformBuffer;
+			PassParameters->SceneTextures = EdgeDetectSceneTextures;
+			PassParameters->RenderTargets[0] = FRenderTargetBinding(SceneTextures.Color.Target, ERenderTargetLoadAction::ELoad);
+
+			TShaderMapRef<FToonOutlineEdgeDetectPS> PixelShader(View.ShaderMap);
+
+			FPixelShaderUtils::AddFullscreenPass(
+				GraphBuilder,
+				View.ShaderMap,
+				RDG_EVENT_NAME("ToonOutlineEdgeDetect"),
+				PixelShader,
+				PassParameters,
+				View.ViewRect,
+				TStaticBlendState<CW_RGB, BO_Add, BF_SourceAlpha, BF_InverseSourceAlpha>::GetRHI());
 		}
 	}
 }
-
-FRegisterPassProcessorCreateFunction RegisterToonOutlinePass(
-	&CreateToonOutlinePassProcessor,
-	EShadingPath::Deferred, 
-	EMeshPass::ToonOutline, 
-	EMeshPassFlags::CachedMeshCommands | EMeshPassFlags::MainView);
\ No newline at end of file
@@ -1,4 +1,5 @@
-﻿
+﻿#pragma once
+
 #include "CoreMinimal.h"
 #include "RHI.h"
 #include "RendererInterface.h"
@@ -6,73 +7,109 @@
 
 
 class FScene;
+struct FSceneTexturesConfig;
+
+extern int32 GToonOutlineMethod;
+
+/**
+ * Whether toon outlines are drawn by the screen space compute pass instead of the hull mesh pass. The compute pass
+ * writes scene color through a UAV, which only exists for single sampled SM5 scene color, so MSAA keeps the hull pass.
+ * Visibility and rendering both use this so hull commands are gathered exactly when they are drawn.
+ */
+bool UseToonScreenSpaceOutline(const FSceneTexturesConfig& Config);
+
+/**
+ * Squared r.Toon.Outline.MinScreenRadius scaled by the view LOD distance factor, or -1 when the screen space pass outlines
+ * every toon mesh. Toon meshes with a smaller screen radius are left to the edge detect outline instead of the hull pass.
+ * The exact test runs on the GPU, in the hull vertex shader and in the base pass where it sets the edge outline bit of the toon
+ * GBuffer data (IsToonHullOutlineVisible in ToonShadersCommon.ush), so both passes see the same result for a mesh.
+ */
+float GetToonOutlineMinScreenRadiusSquared(const FSceneView& View);
+
+/**
+ * Whether a mesh may be drawn by the hull outline pass. Only culls meshes at half the minimum screen radius and below, so float
+ * differences with the exact GPU test can't cull a mesh the base pass left to the hull pass.
+ */
+bool ShouldDrawToonHullOutline(const FSceneView& View, const FBoxSphereBounds& Bounds);
 
 static bool IsToonOutlinePassCompatible(const EShaderPlatform Platform, FMaterialShaderParameters MaterialParameters)
 {
 	return 
 		!IsTranslucentBlendMode(MaterialParameters.BlendMode) && 
+		MaterialParameters.bIsUsedWithToonOutline &&
 		MaterialParameters.ShadingModels.HasAnyShadingModel({ MSM_ToonStandard,  MSM_ToonHair, MSM_ToonSkin});
 }
 
-class FToonOutlineVS : public FMeshMaterialShader
+class FToonHullOutlineShaderElementData : public FMeshMaterialShaderElementData
+{
+public:
+	FToonHullOutlineShaderElementData(float InOutlineWidth)
+		: OutlineWidth(InOutlineWidth)
+	{
+	}
+
+	float OutlineWidth;
+};
+
+class FToonHullOutlineVS : public FMeshMaterialShader
 {
 public:
-	DECLARE_SHADER_TYPE(FToonOutlineVS, MeshMaterial);
+	DECLARE_SHADER_TYPE(FToonHullOutlineVS, MeshMaterial);
 
-	// decided which material should compile with this pipeline
 	static bool ShouldCompilePermutation(const FMeshMaterialShaderPermutationParameters& Parameters)
 	{
-		// Compile if supported by the hardware.
-		const bool bIsFeatureSupported = IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
-
-		return 
-			bIsFeatureSupported && FMeshMaterialShader::ShouldCompilePermutation(Parameters)
-		&&IsToonOutlinePassCompatible(Parameters.Platform, Parameters.MaterialParameters);
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+			&& FMeshMaterialShader::ShouldCompilePermutation(Parameters)
+			&& IsToonOutlinePassCompatible(Parameters.Platform, Parameters.MaterialParameters);
 	}
 
-	FToonOutlineVS() = default;
-	FToonOutlineVS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
+	FToonHullOutlineVS() = default;
+	FToonHullOutlineVS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
 		: FMeshMaterialShader(Initializer)
 	{
-		//BorderGlowSize.Bind(Initializer.ParameterMap, TEXT("BorderGlowSize"));
+		OutlineWidth.Bind(Initializer.ParameterMap, TEXT("OutlineWidth"));
 	}
 
+	void GetShaderBindings(
+		const FScene* Scene,
+		ERHIFeatureLevel::Type FeatureLevel,
+		const FPrimitiveSceneProxy* PrimitiveSceneProxy,
+		const FMaterialRenderProxy& MaterialRenderProxy,
+		const FMaterial& Material,
+		const FMeshPassProcessorRenderState& DrawRenderState,
+		const FToonHullOutlineShaderElementData& ShaderElementData,
+		FMeshDrawSingleShaderBindings& ShaderBindings) const
+	{
+		FMeshMaterialShader::GetShaderBindings(Scene, FeatureLevel, PrimitiveSceneProxy, MaterialRenderProxy, Material, DrawRenderState, ShaderElementData, ShaderBindings);
+		ShaderBindings.Add(OutlineWidth, ShaderElementData.OutlineWidth);
+	}
 
 private:
-	//LAYOUT_FIELD(FShaderParameter, BorderGlowSize);
+	LAYOUT_FIELD(FShaderParameter, OutlineWidth);
 };
 
-class FToonOutlinePS : public FMeshMaterialShader
+class FToonHullOutlinePS : public FMeshMaterialShader
 {
 public:
-	DECLARE_SHADER_TYPE(FToonOutlinePS, MeshMaterial);
+	DECLARE_SHADER_TYPE(FToonHullOutlinePS, MeshMaterial);
 
 	static bool ShouldCompilePermutation(const FMeshMaterialShaderPermutationParameters& Parameters)
 	{
-		return FToonOutlineVS::ShouldCompilePermutation(Parameters);
+		return FToonHullOutlineVS::ShouldCompilePermutation(Parameters);
 	}
 
-	static void ModifyCompilationEnvironment(const FMaterialShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
-	{
-		FMaterialShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
-	}
-
-	FToonOutlinePS() = default;
-	FToonOutlinePS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
+	FToonHullOutlinePS() = default;
+	FToonHullOutlinePS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
 		: FMeshMaterialShader(Initializer)
 	{
-		BorderGlowColor.Bind(Initializer.ParameterMap, TEXT("BorderGlowColor"));
-
 	}
-	
-private:
-	LAYOUT_FIELD(FShaderParameter, BorderGlowColor);
 };
 
-class FToonOutlineMeshProcessor : public FMeshPassProcessor
+/** Draws the back faces of toon meshes extruded along their normals, for materials with UMaterial::bUseToonOutline. */
+class FToonHullOutlineMeshProcessor : public FMeshPassProcessor
 {
 public:
-	FToonOutlineMeshProcessor(
+	FToonHullOutlineMeshProcessor(
 			const FScene* Scene,
 			ERHIFeatureLevel::Type InFeatureLevel,
 			const FSceneView* InViewIfDynamicMeshCommand,
@@ -88,7 +125,7 @@ public:
 		const FPrimitiveSceneProxy* RESTRICT PrimitiveSceneProxy,
 		int32 StaticMeshId = -1
 		) override final;
-	
+
 protected:
 	bool TryAddMeshBatch(
 		const FMeshBatch& RESTRICT MeshBatch,
@@ -97,17 +134,4 @@ protected:
 		int32 StaticMeshId,
 		const FMaterialRenderProxy& MaterialRenderProxy,
 		const FMaterial& Material);
-
-	bool Process(
-		const FMeshBatch& MeshBatch,
-		uint64 BatchElementMask,
-		int32 StaticMeshId,
-		const FPrimitiveSceneProxy* RESTRICT PrimitiveSceneProxy,
-		const FMaterialRenderProxy& RESTRICT MaterialRenderProxy,
-		const FMaterial& RESTRICT MaterialResource,
-		ERasterizerFillMode MeshFillMode,
-		ERasterizerCullMode MeshCullMode
-		);
 };
-
-
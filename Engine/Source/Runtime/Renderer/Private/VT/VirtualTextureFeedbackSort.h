@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FMemStack;
+class FUniquePageList;
+
+// Unique pages requested by a section of the feedback buffer, in ascending order
+struct FSortedPageList
+{
+	// Scratch space for twice the number of feedback entries, Pages and Counts point into it
+	uint32* Buffer = nullptr;
+
+	const uint32* Pages = nullptr;
+	const uint32* Counts = nullptr;
+	uint32 Num = 0u;
+};
+
+namespace VirtualTextureFeedback
+{
+	/**
+	 * Sorts the valid entries of a feedback buffer with a LSD radix sort, 11 bits per pass.
+	 * Passes where all pages share the same digit are skipped, which is common for the space and level bits.
+	 * Unique pages and their request counts are then taken from the runs of identical pages.
+	 */
+	void SortFeedbackPages(const uint32* RESTRICT FeedbackBuffer, uint32 FeedbackSize, FSortedPageList& OutList);
+
+	/**
+	 * Merges sorted lists, so that every unique page is added to the empty unique page list once with its summed count.
+	 * Pages are added round-robin over buckets of the same space and level, so if the list overflows each bucket keeps
+	 * an equal share instead of the pages with the lowest IDs. Rotation, usually the frame number, offsets where each
+	 * bucket starts, so that a bucket larger than its share doesn't drop the same pages every frame.
+	 */
+	void MergeSortedPageLists(TArrayView<const FSortedPageList> Lists, uint32 Rotation, FMemStack& MemStack, FUniquePageList* RESTRICT UniquePageList);
+}
@@ -0,0 +1,307 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	VirtualTextureFeedbackSortTests.cpp: Tests of the sorted virtual texture feedback analysis.
+=============================================================================*/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformTime.h"
+#include "VT/UniquePageList.h"
+#include "VT/VirtualTextureFeedbackSort.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VirtualTextureFeedbackSortTests
+{
+	/**
+	 * Fills a feedback buffer like the GPU does: runs of identical pages from neighboring pixels, with gaps of invalid entries.
+	 * Pages are drawn from NumDistinctPages pages spread over spaces, levels and tiles.
+	 */
+	void MakeFeedback(FRandomStream& Random, uint32 NumDistinctPages, uint32 Size, TArray<uint32>& OutFeedback)
+	{
+		TArray<uint32> DistinctPages;
+		TSet<uint32> Seen;
+		while ((uint32)DistinctPages.Num() < NumDistinctPages)
+		{
+			const uint32 ID = (uint32)Random.RandRange(0, 7);
+			const uint32 vLevelPlus1 = (uint32)Random.RandRange(1, 12);
+			const uint32 vTileX = (uint32)Random.RandRange(0, 4095);
+			const uint32 vTileY = (uint32)Random.RandRange(0, 4095);
+			const uint32 Page = vTileX | (vTileY << 12) | (vLevelPlus1 << 24) | (ID << 28);
+
+			if (!Seen.Contains(Page))
+			{
+				Seen.Add(Page);
+				DistinctPages.Add(Page);
+			}
+		}
+
+		OutFeedback.Reset(Size);
+		while ((uint32)OutFeedback.Num() < Size)
+		{
+			const bool bInvalid = Random.RandRange(0, 7) == 0;
+			const uint32 Page = bInvalid ? 0xffffffff : DistinctPages[Random.RandRange(0, DistinctPages.Num() - 1)];
+			const int32 RunLength = FMath::Min(Random.RandRange(1, 16), (int32)Size - OutFeedback.Num());
+			for (int32 Index = 0; Index < RunLength; ++Index)
+			{
+				OutFeedback.Add(Page);
+			}
+		}
+	}
+
+	// The feedback analysis before the sort: runs of identical entries are added to a hash based unique page list per section, which are then merged
+	FUniquePageList* AnalyzeWithHash(FMemStack& MemStack, const TArray<uint32>& Feedback, uint32 NumSections)
+	{
+		FUniquePageList* Merged = nullptr;
+		const uint32 SectionSize = FMath::DivideAndRoundUp((uint32)Feedback.Num(), NumSections);
+
+		for (uint32 Offset = 0; Offset < (uint32)Feedback.Num(); Offset += SectionSize)
+		{
+			FUniquePageList* List = new(MemStack) FUniquePageList;
+			List->Initialize();
+
+			const uint32 End = FMath::Min(Offset + SectionSize, (uint32)Feedback.Num());
+			uint32 LastPixel = 0xffffffff;
+			uint32 LastCount = 0;
+			for (uint32 Index = Offset; Index < End; Index++)
+			{
+				const uint32 Pixel = Feedback[Index];
+				if (Pixel == LastPixel)
+				{
+					LastCount++;
+					continue;
+				}
+				if (LastPixel != 0xffffffff)
+				{
+					List->Add(LastPixel, LastCount);
+				}
+				LastPixel = Pixel;
+				LastCount = 1;
+			}
+			if (LastPixel != 0xffffffff)
+			{
+				List->Add(LastPixel, LastCount);
+			}
+
+			if (Merged)
+			{
+				Merged->MergePages(List);
+			}
+			else
+			{
+				Merged = List;
+			}
+		}
+		return Merged;
+	}
+
+	// Appends NumPages distinct pages of one space and level, each requested 1 to 4 times, and records their counts
+	void AddBucketFeedback(FRandomStream& Random, uint32 ID, uint32 vLevelPlus1, uint32 NumPages, TArray<uint32>& OutFeedback, TMap<uint32, uint32>& OutCounts)
+	{
+		for (uint32 TileIndex = 0; TileIndex < NumPages; ++TileIndex)
+		{
+			// Tiles in row major order, 4096 per row
+			const uint32 Page = TileIndex | (vLevelPlus1 << 24) | (ID << 28);
+			const int32 Count = Random.RandRange(1, 4);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				OutFeedback.Add(Page);
+			}
+			OutCounts.Add(Page, (uint32)Count);
+		}
+	}
+
+	FUniquePageList* AnalyzeWithSort(FMemStack& MemStack, const TArray<uint32>& Feedback, uint32 NumSections, uint32 Rotation = 0u)
+	{
+		const uint32 SectionSize = FMath::DivideAndRoundUp((uint32)Feedback.Num(), NumSections);
+
+		TArray<FSortedPageList, TInlineAllocator<16>> Lists;
+		for (uint32 Offset = 0; Offset < (uint32)Feedback.Num(); Offset += SectionSize)
+		{
+			const uint32 Size = FMath::Min(SectionSize, (uint32)Feedback.Num() - Offset);
+			FSortedPageList& List = Lists.AddDefaulted_GetRef();
+			List.Buffer = New<uint32>(MemStack, 2u * Size);
+			VirtualTextureFeedback::SortFeedbackPages(Feedback.GetData() + Offset, Size, List);
+		}
+
+		FUniquePageList* Merged = new(MemStack) FUniquePageList;
+		Merged->Initialize();
+		VirtualTextureFeedback::MergeSortedPageLists(Lists, Rotation, MemStack, Merged);
+		return Merged;
+	}
+
+	TMap<uint32, uint32> ToMap(const FUniquePageList& List)
+	{
+		TMap<uint32, uint32> Result;
+		for (uint32 Index = 0; Index < List.GetNum(); ++Index)
+		{
+			Result.Add(List.GetPage(Index), List.GetCount(Index));
+		}
+		return Result;
+	}
+
+	// Checks that every kept page has its requested count, and returns the number of kept pages per space and level
+	bool CheckKeptPages(FAutomationTestBase& Test, const FUniquePageList& List, const TMap<uint32, uint32>& Counts, TMap<uint32, uint32>& OutNumPerBucket)
+	{
+		for (uint32 Index = 0; Index < List.GetNum(); ++Index)
+		{
+			const uint32* Count = Counts.Find(List.GetPage(Index));
+			if (!Test.TestNotNull(TEXT("Kept page was requested"), Count) || !Test.TestEqual(TEXT("Kept page count"), (uint32)List.GetCount(Index), *Count))
+			{
+				return false;
+			}
+			OutNumPerBucket.FindOrAdd(List.GetPage(Index) >> 24)++;
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVirtualTextureFeedbackSortTest, "System.Renderer.VirtualTexture.FeedbackSort", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVirtualTextureFeedbackSortTest::RunTest(const FString& Parameters)
+{
+	using namespace VirtualTextureFeedbackSortTests;
+
+	FMemStack& MemStack = FMemStack::Get();
+	FMemMark Mark(MemStack);
+	FRandomStream Random(0x56544653);
+	TArray<uint32> Feedback;
+
+	// Fewer unique pages than the list holds: same pages and counts as the hash based analysis, for any number of sections
+	for (uint32 NumSections : { 1u, 3u, 8u })
+	{
+		MakeFeedback(Random, 1000, 64 * 1024, Feedback);
+
+		const TMap<uint32, uint32> Expected = ToMap(*AnalyzeWithHash(MemStack, Feedback, NumSections));
+		const FUniquePageList& Sorted = *AnalyzeWithSort(MemStack, Feedback, NumSections);
+
+		if (!TestEqual(*FString::Printf(TEXT("Num unique pages, %u sections"), NumSections), (int32)Sorted.GetNum(), Expected.Num()))
+		{
+			return false;
+		}
+
+		for (uint32 Index = 0; Index < Sorted.GetNum(); ++Index)
+		{
+			const uint32* Count = Expected.Find(Sorted.GetPage(Index));
+			if (!TestNotNull(TEXT("Page found by the hash based analysis"), Count) || !TestEqual(TEXT("Page count"), (uint32)Sorted.GetCount(Index), *Count))
+			{
+				return false;
+			}
+		}
+	}
+
+	// More unique pages than the list holds, in 16 spaces and levels of the same size: every space and level keeps an equal share
+	uint32 Capacity = 0u;
+	{
+		TArray<uint32> BucketFeedback;
+		TMap<uint32, uint32> Counts;
+		for (uint32 ID = 0; ID < 4u; ++ID)
+		{
+			for (uint32 vLevelPlus1 = 1; vLevelPlus1 <= 4u; ++vLevelPlus1)
+			{
+				AddBucketFeedback(Random, ID, vLevelPlus1, 2048, BucketFeedback, Counts);
+			}
+		}
+
+		const FUniquePageList& Sorted = *AnalyzeWithSort(MemStack, BucketFeedback, 8);
+		Capacity = Sorted.GetNum();
+		if (!TestTrue(TEXT("Unique page list overflows"), Capacity < (uint32)Counts.Num()))
+		{
+			return false;
+		}
+
+		TMap<uint32, uint32> NumPerBucket;
+		if (!CheckKeptPages(*this, Sorted, Counts, NumPerBucket) || !TestEqual(TEXT("Every space and level keeps pages"), NumPerBucket.Num(), 16))
+		{
+			return false;
+		}
+
+		uint32 MinKept = MAX_uint32;
+		uint32 MaxKept = 0u;
+		for (const TPair<uint32, uint32>& Pair : NumPerBucket)
+		{
+			MinKept = FMath::Min(MinKept, Pair.Value);
+			MaxKept = FMath::Max(MaxKept, Pair.Value);
+		}
+		TestTrue(*FString::Printf(TEXT("Equal share per space and level, kept %u to %u"), MinKept, MaxKept), MaxKept - MinKept <= 1u);
+	}
+
+	// A small coarse level of the last space next to a fine level of the first that overflows the list on its own: the small one is kept whole
+	{
+		TArray<uint32> BucketFeedback;
+		TMap<uint32, uint32> Counts;
+		AddBucketFeedback(Random, 0, 1, 2u * Capacity, BucketFeedback, Counts);
+		AddBucketFeedback(Random, 15, 15, 64, BucketFeedback, Counts);
+
+		TMap<uint32, uint32> NumPerBucket;
+		if (!CheckKeptPages(*this, *AnalyzeWithSort(MemStack, BucketFeedback, 3), Counts, NumPerBucket))
+		{
+			return false;
+		}
+		TestEqual(TEXT("Kept pages of the small coarse level"), NumPerBucket.FindRef((15u << 4) | 15u), 64u);
+		TestEqual(TEXT("Kept pages of the large fine level"), NumPerBucket.FindRef(1u), Capacity - 64u);
+	}
+
+	// One level twice the size of the list: the rotation changes which pages it drops
+	{
+		TArray<uint32> BucketFeedback;
+		TMap<uint32, uint32> Counts;
+		AddBucketFeedback(Random, 2, 3, 2u * Capacity, BucketFeedback, Counts);
+
+		const TMap<uint32, uint32> Kept = ToMap(*AnalyzeWithSort(MemStack, BucketFeedback, 8, 0u));
+		const TMap<uint32, uint32> KeptRotated = ToMap(*AnalyzeWithSort(MemStack, BucketFeedback, 8, Capacity));
+
+		uint32 NumKeptByBoth = 0u;
+		for (const TPair<uint32, uint32>& Pair : KeptRotated)
+		{
+			NumKeptByBoth += Kept.Contains(Pair.Key) ? 1u : 0u;
+		}
+		TestEqual(TEXT("Num kept pages with rotation"), (uint32)KeptRotated.Num(), Capacity);
+		TestEqual(TEXT("Pages kept with and without rotation"), NumKeptByBoth, 0u);
+	}
+
+	return true;
+}
+
+// Times the analysis of a 1M entry feedback buffer in 8 sections on one thread, against the hash based analysis it replaced
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVirtualTextureFeedbackSortPerfTest, "System.Renderer.VirtualTexture.FeedbackSort.Perf", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVirtualTextureFeedbackSortPerfTest::RunTest(const FString& Parameters)
+{
+	using namespace VirtualTextureFeedbackSortTests;
+
+	const uint32 NumSections = 8;
+	const int32 NumIterations = 16;
+
+	FMemStack& MemStack = FMemStack::Get();
+	FRandomStream Random(0x56544653);
+
+	for (uint32 NumDistinctPages : { 1024u, 4096u, 16384u })
+	{
+		TArray<uint32> Feedback;
+		MakeFeedback(Random, NumDistinctPages, 1024 * 1024, Feedback);
+
+		double SecondsHash = 0.0;
+		double SecondsSort = 0.0;
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			FMemMark Mark(MemStack);
+
+			double StartTime = FPlatformTime::Seconds();
+			AnalyzeWithHash(MemStack, Feedback, NumSections);
+			SecondsHash += FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			AnalyzeWithSort(MemStack, Feedback, NumSections);
+			SecondsSort += FPlatformTime::Seconds() - StartTime;
+		}
+
+		AddInfo(FString::Printf(TEXT("%u distinct pages: hash %.3f ms, sort %.3f ms per frame"),
+			NumDistinctPages, SecondsHash * 1000.0 / NumIterations, SecondsSort * 1000.0 / NumIterations));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -20,6 +20,7 @@
 #include "VT/UniquePageList.h"
 #include "VT/UniqueRequestList.h"
 #include "VT/VirtualTextureFeedback.h"
+#include "VT/VirtualTextureFeedbackSort.h"
 #include "VT/VirtualTexturePhysicalSpace.h"
 #include "VT/VirtualTexturePoolConfig.h"
 #include "VT/VirtualTextureScalability.h"
@@ -159,6 +160,9 @@ static TAutoConsoleVariable<int32> CVarVTCsvStats(
 );
 
 
+// Pages are bucketed by their space ID and level, the bits above the tile coordinates
+static constexpr uint32 PageBucketShift = 24u;
+
 static FORCEINLINE uint32 EncodePage(uint32 ID, uint32 vLevel, uint32 vTileX, uint32 vTileY)
 {
 	const uint32 vLevelPlus1 = vLevel + 1u;
@@ -185,10 +189,187 @@ struct FFeedbackAnalysisParameters
 {
 	FVirtualTextureSystem* System = nullptr;
 	const uint32* FeedbackBuffer = nullptr;
-	FUniquePageList* UniquePageList = nullptr;
+	FSortedPageList* SortedPageList = nullptr;
 	uint32 FeedbackSize = 0u;
 };
 
+void VirtualTextureFeedback::SortFeedbackPages(const uint32* RESTRICT FeedbackBuffer, uint32 FeedbackSize, FSortedPageList& OutList)
+{
+	constexpr uint32 NumPasses = 3u;
+	constexpr uint32 RadixBits = 11u;
+	constexpr uint32 RadixSize = 1u << RadixBits;
+	constexpr uint32 RadixMask = RadixSize - 1u;
+
+	uint32* RESTRICT Src = OutList.Buffer;
+	uint32* RESTRICT Dst = OutList.Buffer + FeedbackSize;
+
+	uint32 Histograms[NumPasses][RadixSize];
+	FMemory::Memzero(Histograms);
+
+	uint32 NumPages = 0u;
+	for (uint32 Index = 0; Index < FeedbackSize; Index++)
+	{
+		const uint32 Page = FeedbackBuffer[Index];
+		if (Page != 0xffffffff)
+		{
+			Src[NumPages++] = Page;
+			Histograms[0][Page & RadixMask]++;
+			Histograms[1][(Page >> RadixBits) & RadixMask]++;
+			Histograms[2][Page >> (2u * RadixBits)]++;
+		}
+	}
+
+	for (uint32 Pass = 0; Pass < NumPasses && NumPages > 0u; Pass++)
+	{
+		const uint32 Shift = Pass * RadixBits;
+		uint32* RESTRICT Histogram = Histograms[Pass];
+
+		if (Histogram[(Src[0] >> Shift) & RadixMask] == NumPages)
+		{
+			continue;
+		}
+
+		uint32 Offset = 0u;
+		for (uint32 Digit = 0; Digit < RadixSize; Digit++)
+		{
+			const uint32 Count = Histogram[Digit];
+			Histogram[Digit] = Offset;
+			Offset += Count;
+		}
+
+		for (uint32 Index = 0; Index < NumPages; Index++)
+		{
+			const uint32 Page = Src[Index];
+			Dst[Histogram[(Page >> Shift) & RadixMask]++] = Page;
+		}
+
+		Swap(Src, Dst);
+	}
+
+	// Compact runs in place, counts go to the other half of the buffer
+	uint32* RESTRICT Counts = Dst;
+	uint32 NumUniquePages = 0u;
+	for (uint32 Index = 0; Index < NumPages;)
+	{
+		const uint32 Page = Src[Index];
+		uint32 RunEnd = Index + 1u;
+		while (RunEnd < NumPages && Src[RunEnd] == Page)
+		{
+			RunEnd++;
+		}
+
+		Src[NumUniquePages] = Page;
+		Counts[NumUniquePages] = RunEnd - Index;
+		NumUniquePages++;
+		Index = RunEnd;
+	}
+
+	OutList.Pages = Src;
+	OutList.Counts = Counts;
+	OutList.Num = NumUniquePages;
+}
+
+void VirtualTextureFeedback::MergeSortedPageLists(TArrayView<const FSortedPageList> Lists, uint32 Rotation, FMemStack& MemStack, FUniquePageList* RESTRICT UniquePageList)
+{
+	FMemMark MergeMark(MemStack);
+
+	const uint32 NumLists = (uint32)Lists.Num();
+	TArray<uint32, TInlineAllocator<16>> Cursors;
+	Cursors.SetNumZeroed(NumLists);
+
+	uint32 MaxMergedPages = 0u;
+	for (const FSortedPageList& List : Lists)
+	{
+		MaxMergedPages += List.Num;
+	}
+	uint32* RESTRICT MergedPages = New<uint32>(MemStack, MaxMergedPages);
+	uint32* RESTRICT MergedCounts = New<uint32>(MemStack, MaxMergedPages);
+	uint32 NumMergedPages = 0u;
+
+	while (true)
+	{
+		uint32 MinPage = 0xffffffff;
+		for (uint32 ListIndex = 0; ListIndex < NumLists; ++ListIndex)
+		{
+			const FSortedPageList& List = Lists[ListIndex];
+			if (Cursors[ListIndex] < List.Num)
+			{
+				MinPage = FMath::Min(MinPage, List.Pages[Cursors[ListIndex]]);
+			}
+		}
+
+		if (MinPage == 0xffffffff)
+		{
+			break;
+		}
+
+		uint32 Count = 0u;
+		for (uint32 ListIndex = 0; ListIndex < NumLists; ++ListIndex)
+		{
+			const FSortedPageList& List = Lists[ListIndex];
+			uint32& Cursor = Cursors[ListIndex];
+			if (Cursor < List.Num && List.Pages[Cursor] == MinPage)
+			{
+				Count += List.Counts[Cursor];
+				Cursor++;
+			}
+		}
+
+		MergedPages[NumMergedPages] = MinPage;
+		MergedCounts[NumMergedPages] = Count;
+		NumMergedPages++;
+	}
+
+	// The space ID and level are the top bits of a page, so every bucket is a contiguous range of the merged pages
+	struct FBucket
+	{
+		uint32 Begin;
+		uint32 Num;
+		uint32 Next;
+	};
+	FBucket Buckets[1u << (32u - PageBucketShift)];
+	uint32 NumActiveBuckets = 0u;
+	for (uint32 Index = 0; Index < NumMergedPages;)
+	{
+		const uint32 Key = MergedPages[Index] >> PageBucketShift;
+		uint32 End = Index + 1u;
+		while (End < NumMergedPages && (MergedPages[End] >> PageBucketShift) == Key)
+		{
+			End++;
+		}
+		Buckets[NumActiveBuckets++] = { Index, End - Index, 0u };
+		Index = End;
+	}
+
+	// Takes one page of every bucket in turn, so that if the list overflows every space and level keeps the same share.
+	// Each bucket starts at a rotated offset, so the pages a bucket drops change from frame to frame.
+	while (NumActiveBuckets > 0u)
+	{
+		for (uint32 BucketIndex = 0; BucketIndex < NumActiveBuckets;)
+		{
+			FBucket& Bucket = Buckets[BucketIndex];
+			const uint32 Index = Bucket.Begin + (Bucket.Next + Rotation) % Bucket.Num;
+
+			const uint32 NumPagesBefore = UniquePageList->GetNum();
+			UniquePageList->Add(MergedPages[Index], MergedCounts[Index]);
+			if (UniquePageList->GetNum() == NumPagesBefore)
+			{
+				// Merged pages are unique, so the list is full
+				return;
+			}
+
+			if (++Bucket.Next == Bucket.Num)
+			{
+				Buckets[BucketIndex] = Buckets[--NumActiveBuckets];
+			}
+			else
+			{
+				BucketIndex++;
+			}
+		}
+	}
+}
+
 class FFeedbackAnalysisTask
 {
 public:
@@ -198,7 +379,6 @@ public:
 
 	static void DoTask(FFeedbackAnalysisParameters& InParams)
 	{
-		InParams.UniquePageList->Initialize();
 		InParams.System->FeedbackAnalysisTask(InParams);
 	}
 
@@ -1288,39 +1468,10 @@ void FVirtualTextureSystem::RequestTilesForRegionInternal(const IAllocatedVirtua
 	}
 }
 
-//将 GPU 产生的 Request 数据加入到 FUniquePageList 中，并统计出现的次数。FUniquePageList 内部是一个 Hash Table，通过 hash Page Request 得到 Page 的索引并进行累加次数。
+//将 GPU 产生的 Request 数据基数排序，相同 Page 的连续长度即为出现的次数，结果在 Update 中归并到 FUniquePageList。
 void FVirtualTextureSystem::FeedbackAnalysisTask(const FFeedbackAnalysisParameters& Parameters)
 {
-	FUniquePageList* RESTRICT RequestedPageList = Parameters.UniquePageList;
-	const uint32* RESTRICT Buffer = Parameters.FeedbackBuffer;
-	const uint32 BufferSize = Parameters.FeedbackSize;
-
-	// Combine simple runs of identical requests
-	uint32 LastPixel = 0xffffffff;
-	uint32 LastCount = 0;
-
-	for (uint32 Index = 0; Index < BufferSize; Index++)
-	{
-		const uint32 Pixel = Buffer[Index];
-		if (Pixel == LastPixel)
-		{
-			LastCount++;
-			continue;
-		}
-
-		if (LastPixel != 0xffffffff)
-		{
-			RequestedPageList->Add(LastPixel, LastCount);
-		}
-
-		LastPixel = Pixel;
-		LastCount = 1;
-	}
-
-	if (LastPixel != 0xffffffff)
-	{
-		RequestedPageList->Add(LastPixel, LastCount);
-	}
+	VirtualTextureFeedback::SortFeedbackPages(Parameters.FeedbackBuffer, Parameters.FeedbackSize, *Parameters.SortedPageList);
 }
 
 void FVirtualTextureSystem::Update(FRDGBuilder& GraphBuilder, ERHIFeatureLevel::Type FeatureLevel, FScene* Scene)
@@ -1407,6 +1558,7 @@ void FVirtualTextureSystem::Update(FRDGBuilder& GraphBuilder, ERHIFeatureLevel::
 		// Create tasks to read the feedback data
 		// Give each task a section of the feedback buffer to analyze
 		FFeedbackAnalysisParameters FeedbackAnalysisParameters[MaxNumTasks];
+		FSortedPageList SortedPageLists[MaxNumTasks];
 
 		const uint32 MaxNumFeedbackTasks = FMath::Clamp((uint32)CVarVTNumFeedbackTasks.GetValueOnRenderThread(), 1u, MaxNumTasks);
 		const uint32 FeedbackSizePerTask = FMath::DivideAndRoundUp(FeedbackResult.Size, MaxNumFeedbackTasks);
@@ -1418,19 +1570,15 @@ void FVirtualTextureSystem::Update(FRDGBuilder& GraphBuilder, ERHIFeatureLevel::
 			const uint32 TaskIndex = NumFeedbackTasks++;
 			FFeedbackAnalysisParameters& Params = FeedbackAnalysisParameters[TaskIndex];
 			Params.System = this;
-			if (TaskIndex == 0u)
-			{
-				Params.UniquePageList = MergedUniquePageList;
-			}
-			else
-			{
-				Params.UniquePageList = new(MemStack) FUniquePageList;
-			}
 			Params.FeedbackBuffer = FeedbackResult.Data + CurrentOffset;
 
 			const uint32 Size = FMath::Min(FeedbackSizePerTask, FeedbackResult.Size - CurrentOffset);
 			Params.FeedbackSize = Size;
 			CurrentOffset += Size;
+
+			// The mem stack is per thread, so the scratch space is allocated here rather than in the task
+			Params.SortedPageList = &SortedPageLists[TaskIndex];
+			Params.SortedPageList->Buffer = New<uint32>(MemStack, 2u * Size);
 		}
 
 		// Kick the tasks
@@ -1465,13 +1613,10 @@ void FVirtualTextureSystem::Update(FRDGBuilder& GraphBuilder, ERHIFeatureLevel::
 			}
 		}
 
-		if (NumFeedbackTasks > 1u)
+		if (NumFeedbackTasks > 0u)
 		{
 			SCOPE_CYCLE_COUNTER(STAT_ProcessRequests_MergePages);
-			for (uint32 TaskIndex = 1u; TaskIndex < NumFeedbackTasks; ++TaskIndex)
-			{
-				MergedUniquePageList->MergePages(FeedbackAnalysisParameters[TaskIndex].UniquePageList);
-			}
+			VirtualTextureFeedback::MergeSortedPageLists(MakeArrayView(SortedPageLists, NumFeedbackTasks), Frame, MemStack, MergedUniquePageList);
 		}
 
 		GVirtualTextureFeedback.Unmap(GraphBuilder.RHICmdList, FeedbackResult.MapHandle);
@@ -57,7 +57,7 @@ namespace EMeshPass
 #endif
 		/*begin sjw modify*/
 		MultiBasePass,
-		ToonOutline,
+		ToonHullOutline,
 		/* end sjw modify*/
 		Num,
 		NumBits = 5,
@@ -100,7 +100,7 @@ inline const TCHAR* GetMeshPassName(EMeshPass::Type MeshPass)
 #endif
 		//begin sjw modify
 	case EMeshPass::MultiBasePass: return TEXT("MultiBasePass");
-	case EMeshPass::ToonOutline: return TEXT("Outline");
+	case EMeshPass::ToonHullOutline: return TEXT("ToonHullOutline");
 		//end sjw modify
 	}
 
@@ -110,7 +110,7 @@ inline const TCHAR* GetMeshPassName(EMeshPass::Type MeshPass)
 	static_assert(EMeshPass::Num == 25 + 4, "Need to update switch(MeshPass) after changing EMeshPass");
 	// begin sjw modify
 #else
-	static_assert(EMeshPass::Num == 23, "Need to update switch(MeshPass) after changing EMeshPass");
+	static_assert(EMeshPass::Num == 25, "Need to update switch(MeshPass) after changing EMeshPass");
 #endif
 
 	checkf(0, TEXT("Missing case for EMeshPass %u"), (uint32)MeshPass);
@@ -17,10 +17,6 @@ BEGIN_GLOBAL_SHADER_PARAMETER_STRUCT(FSceneTextureUniformParameters, RENDERER_AP
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferDTexture)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferETexture)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferFTexture)
-//begin sjw modify
-// init in scenetexture.cpp -> SetupSceneTextureUniformParameterss
-	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, ToonBufferATexture)
-//end sjw modify
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D, GBufferVelocityTexture)
 
 
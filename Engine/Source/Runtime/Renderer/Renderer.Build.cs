@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class Renderer : ModuleRules
+{
+	public Renderer(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PrivateIncludePaths.AddRange(
+			new string[] {
+				"Runtime/Renderer/Private",
+				"Runtime/Renderer/Private/CompositionLighting",
+				"Runtime/Renderer/Private/PostProcess"
+			}
+		);
+
+		if (Target.bBuildEditor == true)
+		{
+			PrivateDependencyModuleNames.Add("TargetPlatform");
+			//begin sjw modify
+			// ToonBRDFLUT.cpp caches the baked toon BRDF LUTs in the DDC in the editor
+			PrivateDependencyModuleNames.Add("DerivedDataCache");
+			//end sjw modify
+		}
+
+		// Renderer module builds faster without unity
+		// Non-unity also provides faster iteration
+		// Not enabled by default as it might harm full rebuild times without XGE
+		//bFasterWithoutUnity = true;
+
+		MinFilesUsingPrecompiledHeaderOverride = 4;
+
+		PublicDependencyModuleNames.Add("Core");
+		PublicDependencyModuleNames.Add("Engine");
+		PublicDependencyModuleNames.Add("MaterialShaderQualitySettings");
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[] {
+				"CoreUObject",
+				"ApplicationCore",
+				"RenderCore",
+				"ImageWriteQueue",
+				"RHI",
+				"MaterialShaderQualitySettings",
+				"GeometryCore",
+				"TraceLog"
+			}
+		);
+
+		PrivateIncludePathModuleNames.AddRange(new string[] { "HeadMountedDisplay", "EyeTracker" });
+		DynamicallyLoadedModuleNames.AddRange(new string[] { "HeadMountedDisplay", "EyeTracker" });
+	}
+}